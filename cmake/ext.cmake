@@ -81,6 +81,22 @@ cpmaddpackage(
   DOWNLOAD_ONLY YES
   )
 
+cpmaddpackage(
+  NAME basis_universal
+  GITHUB_REPOSITORY ${basis_universal_GITHUB}
+  GIT_TAG ${basis_universal_TAG}
+  DOWNLOAD_ONLY YES
+  )
+
+if(LIBLAVA_SPNG)
+  cpmaddpackage(
+    NAME spng
+    GITHUB_REPOSITORY ${spng_GITHUB}
+    GIT_TAG ${spng_TAG}
+    DOWNLOAD_ONLY YES
+    )
+endif()
+
 cpmaddpackage(
   NAME Vulkan-Headers
   GITHUB_REPOSITORY ${Vulkan-Headers_GITHUB}
@@ -26,6 +26,12 @@ set(stb_TAG 5c205738c191bcb0abc65c4febfa9bd25ff35234)
 set(tinyobjloader_GITHUB syoyo/tinyobjloader)
 set(tinyobjloader_TAG fe9e7130a0eee720a28f39b33852108217114076)
 
+set(basis_universal_GITHUB BinomialLLC/basis_universal)
+set(basis_universal_TAG 1.16.4)
+
+set(spng_GITHUB randy408/libspng)
+set(spng_TAG v0.7.4)
+
 set(Vulkan-Headers_GITHUB KhronosGroup/Vulkan-Headers)
 set(Vulkan-Headers_TAG 6a74a7d65cafa19e38ec116651436cce6efd5b2e)
 
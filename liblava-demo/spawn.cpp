@@ -23,6 +23,7 @@ int main(int argc, char* argv[]) {
 
     app.props.add(_vertex_, "spawn/spawn.vert");
     app.props.add(_fragment_, "spawn/spawn.frag");
+    app.props.add("cull", "spawn/cull.comp");
 
     setup_imgui_font_icons(app.config.imgui_font,
                            FONT_ICON_FILE_NAME_FAS,
@@ -35,6 +36,16 @@ int main(int argc, char* argv[]) {
     app.tooltips.add("lock rotation", key::r);
     app.tooltips.add("lock z", key::z);
 
+    app.platform.on_create_param = [&](device::create_param& param) {
+        auto const& features = param.physical_device->get_features();
+
+        // draw all instances with one indirect draw
+        param.features.multiDrawIndirect = features.multiDrawIndirect;
+
+        // instance slot per draw command
+        param.features.drawIndirectFirstInstance = features.drawIndirectFirstInstance;
+    };
+
     if (!app.setup())
         return error::not_ready;
 
@@ -56,10 +67,101 @@ int main(int argc, char* argv[]) {
     if (!default_texture)
         return error::create_failed;
 
+    ui32 instance_count = 1;
+    app.get_cmd_line()({"-si", "--spawn_instances"}) >> instance_count;
+    instance_count = std::max(instance_count, 1u);
+
+    v3 spawn_min{std::numeric_limits<r32>::max()};
+    v3 spawn_max{std::numeric_limits<r32>::lowest()};
+    for (auto const& vertex : spawn_mesh->get_data().vertices) {
+        spawn_min = glm::min(spawn_min, vertex.position);
+        spawn_max = glm::max(spawn_max, vertex.position);
+    }
+
+    v3 const spawn_center = (spawn_min + spawn_max) * 0.5f;
+    r32 const spawn_radius = glm::length(spawn_max - spawn_min) * 0.5f;
+
+    // instances in a grid around the origin
+    std::vector<mat4> spawn_instances(instance_count);
+    {
+        auto const grid = to_ui32(std::ceil(std::cbrt(r32(instance_count))));
+        auto const spacing = spawn_radius * 2.5f;
+
+        for (auto i = 0u; i < instance_count; ++i) {
+            v3 const cell{r32(i % grid),
+                          r32((i / grid) % grid),
+                          r32(i / (grid * grid))};
+
+            spawn_instances[i] = glm::translate(mat4(1.f), cell * spacing);
+        }
+    }
+
+    buffer spawn_instance_buffer;
+    if (!spawn_instance_buffer.create_mapped(app.device,
+                                             spawn_instances.data(),
+                                             sizeof(mat4) * instance_count,
+                                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+        return error::create_failed;
+
+    indirect_draw spawn_draw;
+    if (!spawn_draw.create(app.device,
+                           instance_count,
+                           app.producer.get_shader("cull"),
+                           app.pipeline_cache,
+                           app.target->get_frame_count()))
+        return error::create_failed;
+
+    // without first instance all instances go into one command (no culling)
+    bool const first_instance = app.device->get_features().drawIndirectFirstInstance;
+
+    bool culling_active = first_instance && spawn_draw.culling();
+
+    // bounding spheres follow the spawn matrix
+    auto update_spawn_draws = [&](mat4 const& model) {
+        auto const scale = std::max({glm::length(v3(model[0])),
+                                     glm::length(v3(model[1])),
+                                     glm::length(v3(model[2]))});
+
+        auto const& lods = spawn_mesh->get_lods();
+        auto const index_count = lods.empty() ? spawn_mesh->get_indices_count()
+                                              : lods.front().index_count;
+        auto const first_index = lods.empty() ? 0u : lods.front().first_index;
+
+        spawn_draw.clear();
+
+        if (!first_instance) {
+            spawn_draw.add({
+                               .indexCount = index_count,
+                               .instanceCount = instance_count,
+                               .firstIndex = first_index,
+                               .vertexOffset = 0,
+                               .firstInstance = 0,
+                           },
+                           spawn_center,
+                           -1.f);
+            return;
+        }
+
+        for (auto i = 0u; i < instance_count; ++i) {
+            auto const center = v3(model * spawn_instances[i] * v4(spawn_center, 1.f));
+
+            spawn_draw.add({
+                               .indexCount = index_count,
+                               .instanceCount = 1,
+                               .firstIndex = first_index,
+                               .vertexOffset = 0,
+                               .firstInstance = i,
+                           },
+                           center,
+                           culling_active ? spawn_radius * scale : -1.f);
+        }
+    };
+
     app.camera.position = v3(0.832f, 0.036f, 2.304f);
     app.camera.rotation = v3(8.42f, -29.73f, 0.f);
 
     mat4 spawn_model = glm::identity<mat4>();
+    update_spawn_draws(spawn_model);
 
     buffer spawn_model_buffer;
     if (!spawn_model_buffer.create_mapped(app.device,
@@ -107,6 +209,9 @@ int main(int argc, char* argv[]) {
         descriptor->add_binding(2,
                                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                                 VK_SHADER_STAGE_FRAGMENT_BIT);
+        descriptor->add_binding(3,
+                                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                VK_SHADER_STAGE_VERTEX_BIT);
 
         if (!descriptor->create(app.device))
             return false;
@@ -116,6 +221,7 @@ int main(int argc, char* argv[]) {
                                      {
                                          {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
                                          {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+                                         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
                                      }))
             return false;
 
@@ -156,9 +262,19 @@ int main(int argc, char* argv[]) {
             .pImageInfo = default_texture->get_descriptor_info(),
         };
 
+        VkWriteDescriptorSet const write_desc_instances{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptor_set,
+            .dstBinding = 3,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = spawn_instance_buffer.get_descriptor_info(),
+        };
+
         app.device->vkUpdateDescriptorSets({write_desc_ubo_camera,
                                             write_desc_ubo_spawn,
-                                            write_desc_sampler});
+                                            write_desc_sampler,
+                                            write_desc_instances});
 
         render_pass::s_ptr render_pass = app.shading.get_pass();
 
@@ -170,12 +286,18 @@ int main(int argc, char* argv[]) {
         pipeline->on_process = [&](VkCommandBuffer cmd_buf) {
             layout->bind(cmd_buf, descriptor_set);
 
-            spawn_mesh->bind_draw(cmd_buf);
+            spawn_mesh->bind(cmd_buf);
+            spawn_draw.draw(cmd_buf);
         };
 
         return true;
     };
 
+    app.on_process = [&](VkCommandBuffer cmd_buf, index frame) {
+        if (spawn_draw.culling())
+            spawn_draw.cull(cmd_buf, frame, app.camera.calc_view_projection());
+    };
+
     app.on_destroy = [&]() {
         descriptor->deallocate(descriptor_set, descriptor_pool->get());
 
@@ -220,9 +342,18 @@ int main(int argc, char* argv[]) {
 
         ImGui::SameLine();
 
+        ImGui::Text("instances: %u", instance_count);
+
+        ImGui::SameLine();
+
         uv2 texture_size = default_texture->get_size();
         ImGui::Text("texture: %d x %d", texture_size.x, texture_size.y);
 
+        if (first_instance && spawn_draw.culling()) {
+            if (ImGui::Checkbox("gpu culling", &culling_active))
+                update_spawn_draws(spawn_model);
+        }
+
         ImGui::Separator();
 
         ImGui::Spacing();
@@ -324,6 +455,8 @@ int main(int argc, char* argv[]) {
 
             memcpy(data::as_ptr(spawn_model_buffer.get_mapped_data()), &spawn_model, sizeof(mat4));
 
+            update_spawn_draws(spawn_model);
+
             update_spawn_matrix = false;
         }
 
@@ -331,6 +464,8 @@ int main(int argc, char* argv[]) {
     };
 
     app.add_run_end([&]() {
+        spawn_draw.destroy();
+        spawn_instance_buffer.destroy();
         spawn_model_buffer.destroy();
     });
 
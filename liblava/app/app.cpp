@@ -107,7 +107,13 @@ bool app::create_block() {
                                     _lava_texture_staging_,
                                     {0.f, 0.13f, 0.4f, 1.f});
 
+            // staging memory of completed buffer uploads
+            if (auto ring = device->get_staging_ring())
+                ring->collect();
+
             staging.stage(cmd_buf, current_frame);
+
+            streamer.stream(cmd_buf, current_frame);
         }
 
         if (on_process)
@@ -293,7 +299,22 @@ bool app::setup_window() {
 //-----------------------------------------------------------------------------
 bool app::setup_device() {
     if (!device) {
+        auto const on_create_param = platform.on_create_param;
+
+        // own transfer queue for async uploads (see staging)
+        platform.on_create_param = [&](lava::device::create_param& param) {
+            if (param.timeline_semaphore
+                && !param.add_queue(VK_QUEUE_TRANSFER_BIT))
+                logger()->info("no free transfer queue for async uploads");
+
+            if (on_create_param)
+                on_create_param(param);
+        };
+
         device = platform.create_device(config.physical_device);
+
+        platform.on_create_param = on_create_param;
+
         if (!device)
             return false;
     }
@@ -308,6 +329,9 @@ bool app::setup_device() {
                    device_name, device_type,
                    to_string(device_driver_version));
 
+    if (device->timeline_semaphore_enabled())
+        staging.create_async(device);
+
     return true;
 }
 
@@ -357,11 +381,15 @@ void app::setup_run() {
 
             destroy_imgui();
 
+            streamer.clear();
+
             block.destroy();
 
             destroy_target();
         }
 
+        staging.clear();
+
         destroy_pipeline_cache();
 
         if (!headless)
@@ -670,6 +698,11 @@ void app::render() {
         if (!block.process(*frame_index))
             return run_abort;
 
+        if (auto const wait_value = staging.get_frame_wait_value())
+            renderer.add_frame_timeline_wait(staging.get_timeline_semaphore(),
+                                             wait_value,
+                                             staging.get_frame_wait_stage());
+
         return renderer.end_frame(block.collect_buffers());
     });
 }
@@ -768,6 +801,16 @@ void app::draw_about(about_info_setting setting) const {
             ImGui::TextUnformatted(_paused_);
         }
     }
+
+    if (setting.draw_staging && staging.get_queue_depth() > 0) {
+        if (setting.draw_spacing)
+            imgui_left_spacing();
+
+        ImGui::Text("staging: %zu (%.1f MB) - %.1f MB/frame",
+                    staging.get_queue_depth(),
+                    to_r32(staging.get_pending_size()) / (1024.f * 1024.f),
+                    to_r32(staging.get_staged_size()) / (1024.f * 1024.f));
+    }
 }
 
 } // namespace lava
@@ -13,6 +13,7 @@
 #include "liblava/app/forward_shading.hpp"
 #include "liblava/block.hpp"
 #include "liblava/frame.hpp"
+#include "liblava/resource/texture_stream.hpp"
 
 namespace lava {
 
@@ -74,6 +75,9 @@ struct app : frame {
     /// Texture staging
     lava::staging staging;
 
+    /// Texture streaming
+    lava::texture_streamer streamer;
+
     /// Basic block
     lava::block block;
 
@@ -158,6 +162,9 @@ struct app : frame {
         /// Draw with fps
         bool draw_fps = true;
 
+        /// Draw with staging queue (when busy)
+        bool draw_staging = true;
+
         /// Draw with spacing
         bool draw_spacing = true;
 
@@ -6,6 +6,7 @@
  */
 
 #include "liblava/app/camera.hpp"
+#include "liblava/resource/mesh_lod.hpp"
 
 namespace lava {
 
@@ -188,6 +189,27 @@ mat4 camera::calc_view_projection() const {
     return m_projection * m_view;
 }
 
+//-----------------------------------------------------------------------------
+r32 camera::calc_pixels_per_unit(v3 pos,
+                                 r32 viewport_height) const {
+    auto const view_pos = v3(m_view * v4(pos, 1.f));
+    auto const distance = std::max(glm::length(view_pos), z_near);
+
+    return viewport_height
+           / (2.f * std::tan(glm::radians(fov) * 0.5f) * distance);
+}
+
+//-----------------------------------------------------------------------------
+index camera::select_lod(mesh_lod::list const& lods,
+                         v3 pos,
+                         r32 viewport_height,
+                         r32 pixel_threshold,
+                         r32 scale) const {
+    return select_mesh_lod(lods,
+                           calc_pixels_per_unit(pos, viewport_height) * scale,
+                           pixel_threshold);
+}
+
 //-----------------------------------------------------------------------------
 void camera::upload() {
     memcpy(m_data->get_mapped_data(), &m_projection, m_size);
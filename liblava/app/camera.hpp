@@ -10,6 +10,7 @@
 #include "liblava/frame/gamepad.hpp"
 #include "liblava/frame/input.hpp"
 #include "liblava/resource/buffer.hpp"
+#include "liblava/resource/mesh.hpp"
 
 namespace lava {
 
@@ -86,6 +87,30 @@ struct camera : entity {
      */
     mat4 calc_view_projection() const;
 
+    /**
+     * @brief Calc the projected pixels per world unit at a position
+     * @param position           World position
+     * @param viewport_height    Viewport height in pixels
+     * @return r32               Pixels per world unit
+     */
+    r32 calc_pixels_per_unit(v3 position,
+                             r32 viewport_height) const;
+
+    /**
+     * @brief Select a mesh lod by projected screen-space error
+     * @param lods               List of mesh lods
+     * @param position           World position of mesh
+     * @param viewport_height    Viewport height in pixels
+     * @param pixel_threshold    Maximal projected error in pixels
+     * @param scale              Uniform model scale of mesh
+     * @return index             Index of lod
+     */
+    index select_lod(mesh_lod::list const& lods,
+                     v3 position,
+                     r32 viewport_height,
+                     r32 pixel_threshold = 1.f,
+                     r32 scale = 1.f) const;
+
     /**
      * @brief Handle key event
      * @param event     Key event
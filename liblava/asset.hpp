@@ -7,7 +7,13 @@
 
 #pragma once
 
+#include "liblava/asset/compress_texture.hpp"
+#include "liblava/asset/image_decoder.hpp"
+#include "liblava/asset/load_gltf.hpp"
 #include "liblava/asset/load_image.hpp"
+#include "liblava/asset/load_ktx2.hpp"
 #include "liblava/asset/load_mesh.hpp"
 #include "liblava/asset/load_texture.hpp"
+#include "liblava/asset/parse_obj.hpp"
+#include "liblava/asset/texture_batch.hpp"
 #include "liblava/asset/write_image.hpp"
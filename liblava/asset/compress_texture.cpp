@@ -0,0 +1,106 @@
+/**
+ * @file         liblava/asset/compress_texture.cpp
+ * @brief        Texture block compression
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/compress_texture.hpp"
+#include "liblava/util/thread.hpp"
+
+#define STB_DXT_IMPLEMENTATION
+#include "stb_dxt.h"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+VkFormat get_compression_format(texture_compression compression) {
+    switch (compression) {
+    case texture_compression::bc1:
+        return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    case texture_compression::bc3:
+        return VK_FORMAT_BC3_SRGB_BLOCK;
+    case texture_compression::bc5:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+    default:
+        return VK_FORMAT_UNDEFINED;
+    }
+}
+
+//-----------------------------------------------------------------------------
+texture_compression select_compression(ui8 const* data,
+                                       size_t texel_count,
+                                       texture_compression compression) {
+    if (compression != texture_compression::automatic)
+        return compression;
+
+    for (auto i = 0u; i < texel_count; ++i)
+        if (data[i * 4 + 3] != 255)
+            return texture_compression::bc3;
+
+    return texture_compression::bc1;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ui8> compress_rgba8(ui8 const* data,
+                                texture::mip_level::list const& levels,
+                                texture_compression compression,
+                                ui32 thread_count) {
+    auto const block_size = compression_block_size(compression);
+
+    size_t result_size = 0;
+    for (auto const& level : levels)
+        result_size += ((level.extent.x + 3) / 4) * ((level.extent.y + 3) / 4) * block_size;
+
+    std::vector<ui8> result(result_size);
+
+    auto const compress_block = [&](ui8 const* texels, ui32 pitch, uv2 extent,
+                                    ui32 block_x, ui32 block_y, ui8* target) {
+        // edge blocks repeat the last row and column
+        std::array<ui8, 16 * 4> block;
+        for (auto y = 0u; y < 4; ++y)
+            for (auto x = 0u; x < 4; ++x) {
+                auto const sx = std::min(block_x * 4 + x, extent.x - 1);
+                auto const sy = std::min(block_y * 4 + y, extent.y - 1);
+                memcpy(&block[(y * 4 + x) * 4], texels + sy * pitch + sx * 4, 4);
+            }
+
+        if (compression == texture_compression::bc5) {
+            std::array<ui8, 16 * 2> rg;
+            for (auto i = 0u; i < 16; ++i) {
+                rg[i * 2] = block[i * 4];
+                rg[i * 2 + 1] = block[i * 4 + 1];
+            }
+
+            stb_compress_bc5_block(target, rg.data());
+        } else {
+            stb_compress_dxt_block(target, block.data(),
+                                   compression == texture_compression::bc3,
+                                   STB_DXT_HIGHQUAL);
+        }
+    };
+
+    auto src = data;
+    auto dst = result.data();
+
+    for (auto const& level : levels) {
+        auto const pitch = level.extent.x * 4;
+        auto const blocks_x = (level.extent.x + 3) / 4;
+        auto const blocks_y = (level.extent.y + 3) / 4;
+
+        // block rows per task
+        parallel_for(thread_count, blocks_y, [&](size_t row) {
+            auto const block_y = to_ui32(row);
+            for (auto block_x = 0u; block_x < blocks_x; ++block_x)
+                compress_block(src, pitch, level.extent, block_x, block_y,
+                               dst + (block_y * blocks_x + block_x) * block_size);
+        });
+
+        src += level.extent.x * level.extent.y * 4;
+        dst += blocks_x * blocks_y * block_size;
+    }
+
+    return result;
+}
+
+} // namespace lava
@@ -0,0 +1,54 @@
+/**
+ * @file         liblava/asset/compress_texture.hpp
+ * @brief        Texture block compression
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/texture.hpp"
+
+namespace lava {
+
+/**
+ * @brief Get the size of a compressed block
+ * @param compression    Texture compression
+ * @return ui32          Size of 4x4 block in bytes
+ */
+inline ui32 compression_block_size(texture_compression compression) {
+    return compression == texture_compression::bc1 ? 8 : 16;
+}
+
+/**
+ * @brief Get the format of a texture compression
+ * @param compression    Texture compression
+ * @return VkFormat      Block format (sRGB for color)
+ */
+VkFormat get_compression_format(texture_compression compression);
+
+/**
+ * @brief Select compression for RGBA8 texels
+ * @param data                     Texels
+ * @param texel_count              Number of texels
+ * @param compression              Requested compression
+ * @return texture_compression     BC1 or BC3 if automatic, else requested
+ */
+texture_compression select_compression(ui8 const* data,
+                                       size_t texel_count,
+                                       texture_compression compression);
+
+/**
+ * @brief Compress RGBA8 levels into blocks
+ * @param data                Texels of all levels (first level first)
+ * @param levels              List of mip levels
+ * @param compression         Texture compression (not automatic)
+ * @param thread_count        Number of threads (0: hardware concurrency)
+ * @return std::vector<ui8>   Blocks of all levels
+ */
+std::vector<ui8> compress_rgba8(ui8 const* data,
+                                texture::mip_level::list const& levels,
+                                texture_compression compression,
+                                ui32 thread_count = 0);
+
+} // namespace lava
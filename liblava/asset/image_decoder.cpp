@@ -0,0 +1,273 @@
+/**
+ * @file         liblava/asset/image_decoder.cpp
+ * @brief        Image decoder backends
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/image_decoder.hpp"
+#include "liblava/util/log.hpp"
+
+#include "stb_image.h"
+
+#ifdef LAVA_TURBOJPEG
+    #include "turbojpeg.h"
+#endif
+
+#ifdef LAVA_SPNG
+    #include "spng.h"
+#endif
+
+namespace lava {
+
+namespace {
+
+/// Number of channels in decoded data
+constexpr ui32 const rgba_channels = 4;
+
+/**
+ * @brief Check the file signature of image data
+ * @param data         Encoded image data
+ * @param signature    Expected first bytes
+ * @return Signature matches or not
+ */
+template<size_t size>
+bool has_signature(c_data::ref data,
+                   std::array<ui8, size> const& signature) {
+    return data.addr
+           && data.size >= size
+           && memcmp(data.addr, signature.data(), size) == 0;
+}
+
+/// JPEG start of image marker
+std::array<ui8, 3> const jpeg_signature = {0xff, 0xd8, 0xff};
+
+/// PNG signature
+std::array<ui8, 8> const png_signature = {0x89, 0x50, 0x4e, 0x47,
+                                          0x0d, 0x0a, 0x1a, 0x0a};
+
+/**
+ * @brief Decode image data with stb_image
+ * @param data                  Encoded image data
+ * @return image_data::s_ptr    Decoded image
+ */
+image_data::s_ptr decode_stb(c_data::ref data) {
+    i32 width = 0, height = 0, channels = 0;
+    auto pixels = stbi_load_from_memory((stbi_uc const*)data.addr,
+                                        to_i32(data.size),
+                                        &width,
+                                        &height,
+                                        &channels,
+                                        STBI_rgb_alpha);
+    if (!pixels)
+        return nullptr;
+
+    auto result = std::make_shared<image_data>();
+    result->set_data(data::as_ptr(pixels));
+    result->dimensions = {width, height};
+    result->channels = channels;
+
+    return result;
+}
+
+#ifdef LAVA_TURBOJPEG
+/**
+ * @brief Decode JPEG data with libjpeg-turbo
+ * @param data                  Encoded image data
+ * @return image_data::s_ptr    Decoded image
+ */
+image_data::s_ptr decode_turbojpeg(c_data::ref data) {
+    auto handle = tjInitDecompress();
+    if (!handle)
+        return nullptr;
+
+    auto const source = (unsigned char const*)data.addr;
+    auto const source_size = (unsigned long)data.size;
+
+    i32 width = 0, height = 0, subsamp = 0, colorspace = 0;
+    if (tjDecompressHeader3(handle, source, source_size,
+                            &width, &height, &subsamp, &colorspace)
+        != 0) {
+        tjDestroy(handle);
+        return nullptr;
+    }
+
+    // freed by image data
+    auto pixels = (unsigned char*)malloc(size_t(width) * height * rgba_channels);
+    if (!pixels) {
+        tjDestroy(handle);
+        return nullptr;
+    }
+
+    // CMYK can not be converted to RGBA
+    if (tjDecompress2(handle, source, source_size,
+                      pixels, width, 0, height, TJPF_RGBA, 0)
+        != 0) {
+        logger()->trace("turbojpeg: {}", tjGetErrorStr2(handle));
+
+        free(pixels);
+        tjDestroy(handle);
+        return nullptr;
+    }
+
+    tjDestroy(handle);
+
+    auto result = std::make_shared<image_data>();
+    result->set_data(data::as_ptr(pixels));
+    result->dimensions = {width, height};
+    result->channels = colorspace == TJCS_GRAY ? 1 : 3;
+
+    return result;
+}
+#endif
+
+#ifdef LAVA_SPNG
+/**
+ * @brief Decode PNG data with libspng
+ * @param data                  Encoded image data
+ * @return image_data::s_ptr    Decoded image
+ */
+image_data::s_ptr decode_spng(c_data::ref data) {
+    auto ctx = spng_ctx_new(0);
+    if (!ctx)
+        return nullptr;
+
+    spng_ihdr ihdr{};
+    size_t size = 0;
+    if (spng_set_png_buffer(ctx, data.addr, data.size) != 0
+        || spng_get_ihdr(ctx, &ihdr) != 0
+        || spng_decoded_image_size(ctx, SPNG_FMT_RGBA8, &size) != 0) {
+        spng_ctx_free(ctx);
+        return nullptr;
+    }
+
+    // freed by image data
+    auto pixels = malloc(size);
+    if (!pixels) {
+        spng_ctx_free(ctx);
+        return nullptr;
+    }
+
+    // transparency chunk to alpha like stb
+    if (auto error = spng_decode_image(ctx, pixels, size,
+                                       SPNG_FMT_RGBA8, SPNG_DECODE_TRNS)) {
+        logger()->trace("spng: {}", spng_strerror(error));
+
+        free(pixels);
+        spng_ctx_free(ctx);
+        return nullptr;
+    }
+
+    spng_ctx_free(ctx);
+
+    ui32 channels = 3;
+    switch (ihdr.color_type) {
+    case SPNG_COLOR_TYPE_GRAYSCALE:
+        channels = 1;
+        break;
+    case SPNG_COLOR_TYPE_GRAYSCALE_ALPHA:
+        channels = 2;
+        break;
+    case SPNG_COLOR_TYPE_TRUECOLOR_ALPHA:
+        channels = 4;
+        break;
+    default:
+        break;
+    }
+
+    auto result = std::make_shared<image_data>();
+    result->set_data(data::as_ptr(pixels));
+    result->dimensions = {ihdr.width, ihdr.height};
+    result->channels = channels;
+
+    return result;
+}
+#endif
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+name get_image_decoder_name(image_decoder decoder) {
+    switch (decoder) {
+    case image_decoder::automatic:
+        return "automatic";
+    case image_decoder::stb:
+        return "stb";
+    case image_decoder::turbojpeg:
+        return "turbojpeg";
+    case image_decoder::spng:
+        return "spng";
+    }
+
+    return "unknown";
+}
+
+//-----------------------------------------------------------------------------
+bool image_decoder_available(image_decoder decoder) {
+    switch (decoder) {
+    case image_decoder::automatic:
+    case image_decoder::stb:
+        return true;
+    case image_decoder::turbojpeg:
+#ifdef LAVA_TURBOJPEG
+        return true;
+#else
+        return false;
+#endif
+    case image_decoder::spng:
+#ifdef LAVA_SPNG
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+image_decoder select_image_decoder(c_data::ref data) {
+    if (image_decoder_available(image_decoder::turbojpeg)
+        && has_signature(data, jpeg_signature))
+        return image_decoder::turbojpeg;
+
+    if (image_decoder_available(image_decoder::spng)
+        && has_signature(data, png_signature))
+        return image_decoder::spng;
+
+    return image_decoder::stb;
+}
+
+//-----------------------------------------------------------------------------
+image_data::s_ptr decode_image(c_data::ref data,
+                               image_decoder decoder) {
+    if (!data.addr || data.size == 0)
+        return nullptr;
+
+    if (decoder == image_decoder::automatic)
+        decoder = select_image_decoder(data);
+
+    image_data::s_ptr result;
+
+    switch (decoder) {
+    case image_decoder::turbojpeg:
+#ifdef LAVA_TURBOJPEG
+        result = decode_turbojpeg(data);
+#endif
+        break;
+    case image_decoder::spng:
+#ifdef LAVA_SPNG
+        result = decode_spng(data);
+#endif
+        break;
+    default:
+        break;
+    }
+
+    if (result)
+        return result;
+
+    return decode_stb(data);
+}
+
+} // namespace lava
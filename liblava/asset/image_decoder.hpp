@@ -0,0 +1,57 @@
+/**
+ * @file         liblava/asset/image_decoder.hpp
+ * @brief        Image decoder backends
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/image.hpp"
+
+namespace lava {
+
+/**
+ * @brief Image decoder backends
+ */
+enum class image_decoder : index {
+    automatic = 0, ///< fastest available backend for the data
+    stb,           ///< stb_image (all formats, always available)
+    turbojpeg,     ///< libjpeg-turbo (JPEG, LIBLAVA_TURBOJPEG)
+    spng,          ///< libspng (PNG, LIBLAVA_SPNG)
+};
+
+/**
+ * @brief Get the name of an image decoder
+ * @param decoder    Image decoder
+ * @return name      Name of decoder
+ */
+name get_image_decoder_name(image_decoder decoder);
+
+/**
+ * @brief Check if an image decoder is built in
+ * @param decoder    Image decoder
+ * @return Decoder is available or not
+ */
+bool image_decoder_available(image_decoder decoder);
+
+/**
+ * @brief Select the fastest available decoder by file signature
+ * @param data               Encoded image data
+ * @return image_decoder     Selected decoder (stb as fallback)
+ */
+image_decoder select_image_decoder(c_data::ref data);
+
+/**
+ * @brief Decode image data to RGBA8
+ *
+ * Falls back to stb when the backend is not available or fails.
+ *
+ * @param data                  Encoded image data
+ * @param decoder               Image decoder
+ * @return image_data::s_ptr    Decoded image (channels of source)
+ */
+image_data::s_ptr decode_image(c_data::ref data,
+                               image_decoder decoder = image_decoder::automatic);
+
+} // namespace lava
@@ -0,0 +1,861 @@
+/**
+ * @file         liblava/asset/load_gltf.cpp
+ * @brief        Load glTF 2.0 model from file
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/load_gltf.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "liblava/file.hpp"
+#include <list>
+
+namespace lava {
+
+namespace {
+
+/// GLB header magic ("glTF")
+constexpr ui32 const glb_magic = 0x46546C67;
+
+/// GLB json chunk type ("JSON")
+constexpr ui32 const glb_chunk_json = 0x4E4F534A;
+
+/// GLB binary chunk type ("BIN")
+constexpr ui32 const glb_chunk_bin = 0x004E4942;
+
+/// Triangle list primitive mode
+constexpr index const gltf_mode_triangles = 4;
+
+/**
+ * @brief glTF accessor component types
+ */
+enum gltf_component : ui32 {
+    gltf_byte = 5120,
+    gltf_unsigned_byte = 5121,
+    gltf_short = 5122,
+    gltf_unsigned_short = 5123,
+    gltf_unsigned_int = 5125,
+    gltf_float = 5126,
+};
+
+/**
+ * @brief Get size of accessor component
+ * @param component    Component type
+ * @return size_t      Size in bytes
+ */
+size_t component_size(ui32 component) {
+    switch (component) {
+    case gltf_byte:
+    case gltf_unsigned_byte:
+        return 1;
+    case gltf_short:
+    case gltf_unsigned_short:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/**
+ * @brief Get number of components of accessor type
+ * @param type      Accessor type
+ * @return ui32     Number of components
+ */
+ui32 component_count(string_ref type) {
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4" || type == "MAT2")
+        return 4;
+    if (type == "MAT3")
+        return 9;
+    if (type == "MAT4")
+        return 16;
+    return 0;
+}
+
+/**
+ * @brief Decode base64 string
+ * @param source    Encoded string
+ * @param target    Target data
+ * @return Decode was successful or failed
+ */
+bool decode_base64(string_view source,
+                   u_data& target) {
+    auto const value = [](char c) -> i32 {
+        if (c >= 'A' && c <= 'Z')
+            return c - 'A';
+        if (c >= 'a' && c <= 'z')
+            return c - 'a' + 26;
+        if (c >= '0' && c <= '9')
+            return c - '0' + 52;
+        if (c == '+' || c == '-')
+            return 62;
+        if (c == '/' || c == '_')
+            return 63;
+        return -1;
+    };
+
+    while (!source.empty() && source.back() == '=')
+        source.remove_suffix(1);
+
+    target.set(source.size() * 3 / 4 + 1);
+    if (!target.addr)
+        return false;
+
+    size_t size = 0;
+    ui32 bits = 0;
+    i32 bit_count = 0;
+    for (auto const c : source) {
+        auto const v = value(c);
+        if (v < 0)
+            return false;
+
+        bits = (bits << 6) | to_ui32(v);
+        bit_count += 6;
+
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            target.addr[size++] = static_cast<char>((bits >> bit_count) & 0xff);
+        }
+    }
+
+    target.size = size;
+    return true;
+}
+
+/**
+ * @brief Accessor view into buffer data
+ */
+struct gltf_accessor {
+    /// First element
+    ui8 const* data = nullptr;
+
+    /// Number of elements
+    size_t count = 0;
+
+    /// Distance between elements
+    size_t stride = 0;
+
+    /// Component type
+    ui32 component = gltf_float;
+
+    /// Number of components
+    ui32 components = 0;
+
+    /// Normalized integer state
+    bool normalized = false;
+
+    /// Buffer view of accessor
+    index buffer_view = no_index;
+
+    /// Byte offset in buffer view
+    size_t offset = 0;
+
+    /**
+     * @brief Check if accessor is valid
+     * @return Accessor is valid or not
+     */
+    bool valid() const {
+        return data != nullptr;
+    }
+
+    /**
+     * @brief Read component as float
+     * @param element            Element index
+     * @param component_index    Component index
+     * @return r32               Value
+     */
+    r32 read(size_t element,
+             ui32 component_index) const {
+        auto const ptr = data + element * stride
+                         + component_index * component_size(component);
+
+        switch (component) {
+        case gltf_float: {
+            r32 value;
+            memcpy(&value, ptr, sizeof(r32));
+            return value;
+        }
+        case gltf_unsigned_byte:
+            return normalized ? *ptr / 255.f : *ptr;
+        case gltf_byte: {
+            auto const value = static_cast<i8>(*ptr);
+            return normalized ? std::max(value / 127.f, -1.f) : value;
+        }
+        case gltf_unsigned_short: {
+            ui16 value;
+            memcpy(&value, ptr, sizeof(ui16));
+            return normalized ? value / 65535.f : value;
+        }
+        case gltf_short: {
+            i16 value;
+            memcpy(&value, ptr, sizeof(i16));
+            return normalized ? std::max(value / 32767.f, -1.f) : value;
+        }
+        default: {
+            ui32 value;
+            memcpy(&value, ptr, sizeof(ui32));
+            return r32(value);
+        }
+        }
+    }
+
+    /**
+     * @brief Read integer element
+     * @param element    Element index
+     * @return index     Value
+     */
+    index read_index(size_t element) const {
+        auto const ptr = data + element * stride;
+
+        switch (component) {
+        case gltf_unsigned_byte:
+            return *ptr;
+        case gltf_unsigned_short: {
+            ui16 value;
+            memcpy(&value, ptr, sizeof(ui16));
+            return value;
+        }
+        default: {
+            ui32 value;
+            memcpy(&value, ptr, sizeof(ui32));
+            return value;
+        }
+        }
+    }
+};
+
+/**
+ * @brief glTF document with buffer views into file data
+ */
+struct gltf_document : no_copy_no_move {
+    /**
+     * @brief Load the document
+     * @param filename    File to load
+     * @return Load was successful or failed
+     */
+    bool load(string_ref filename);
+
+    /**
+     * @brief Get accessor by index
+     * @param accessor_index    Index of accessor
+     * @return gltf_accessor    Accessor view (invalid on error)
+     */
+    gltf_accessor get_accessor(index accessor_index) const;
+
+    /**
+     * @brief Resolve image file of texture
+     * @param texture_info    Texture info json
+     * @return string         Image file (empty: none or embedded)
+     */
+    string get_texture_file(json const& texture_info) const;
+
+    /// Json root
+    json root;
+
+    /// Buffers (views into file data or decoded data)
+    std::vector<c_data> buffers;
+
+    /// Path of document
+    std::filesystem::path path;
+
+private:
+    /// Source file
+    u_data m_source;
+
+    /// External and decoded buffers
+    std::list<u_data> m_storage;
+};
+
+//-----------------------------------------------------------------------------
+bool gltf_document::load(string_ref filename) {
+    path = filename;
+
+    if (!load_file_data(filename, m_source)) {
+        logger()->error("load gltf file: {}", filename);
+        return false;
+    }
+
+    c_data binary_chunk;
+
+    if (extension(filename, "GLB")) {
+        auto const read_ui32 = [&](size_t offset) {
+            ui32 value = 0;
+            if (offset + sizeof(ui32) <= m_source.size)
+                memcpy(&value, m_source.addr + offset, sizeof(ui32));
+            return value;
+        };
+
+        if (m_source.size < 20 || read_ui32(0) != glb_magic || read_ui32(4) != 2) {
+            logger()->error("invalid glb header: {}", filename);
+            return false;
+        }
+
+        auto const total_size = std::min(size_t(read_ui32(8)), m_source.size);
+
+        c_data json_chunk;
+        for (size_t offset = 12; offset + 8 <= total_size;) {
+            auto const chunk_size = size_t(read_ui32(offset));
+            auto const chunk_type = read_ui32(offset + 4);
+            offset += 8;
+
+            if (offset + chunk_size > total_size)
+                break;
+
+            if (chunk_type == glb_chunk_json && !json_chunk.addr)
+                json_chunk = {m_source.addr + offset, chunk_size};
+            else if (chunk_type == glb_chunk_bin && !binary_chunk.addr)
+                binary_chunk = {m_source.addr + offset, chunk_size};
+
+            offset += align_up(chunk_size, size_t(4));
+        }
+
+        if (!json_chunk.addr) {
+            logger()->error("missing glb json chunk: {}", filename);
+            return false;
+        }
+
+        root = json::parse(json_chunk.addr, json_chunk.addr + json_chunk.size, nullptr, false);
+    } else {
+        root = json::parse(m_source.addr, m_source.addr + m_source.size, nullptr, false);
+    }
+
+    if (root.is_discarded() || !root.is_object()) {
+        logger()->error("parse gltf json: {}", filename);
+        return false;
+    }
+
+    if (!root.count("buffers"))
+        return true;
+
+    for (auto const& buffer : root["buffers"]) {
+        if (!buffer.count("uri")) {
+            // glb binary chunk is referenced directly
+            buffers.push_back(binary_chunk);
+            continue;
+        }
+
+        string const uri = buffer["uri"];
+
+        auto& storage = m_storage.emplace_back();
+
+        if (uri.starts_with("data:")) {
+            auto const separator = uri.find(";base64,");
+            if (separator == string::npos
+                || !decode_base64(string_view(uri).substr(separator + 8), storage)) {
+                logger()->error("decode gltf buffer: {}", filename);
+                return false;
+            }
+        } else {
+            auto buffer_path = path;
+            buffer_path.replace_filename(uri);
+
+            if (!load_file_data(buffer_path.string(), storage)) {
+                logger()->error("load gltf buffer: {}", buffer_path.string());
+                return false;
+            }
+        }
+
+        buffers.push_back(storage);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+gltf_accessor gltf_document::get_accessor(index accessor_index) const {
+    gltf_accessor result;
+
+    if (!root.count("accessors") || accessor_index >= root["accessors"].size())
+        return result;
+
+    auto const& accessor = root["accessors"][accessor_index];
+    if (accessor.count("sparse"))
+        logger()->warn("gltf sparse accessor not supported: {}", path.string());
+
+    if (!accessor.count("bufferView"))
+        return result;
+
+    result.count = accessor.value("count", size_t(0));
+    result.component = accessor.value("componentType", ui32(gltf_float));
+    result.components = component_count(accessor.value("type", string()));
+    result.normalized = accessor.value("normalized", false);
+    result.buffer_view = accessor["bufferView"].get<index>();
+    result.offset = accessor.value("byteOffset", size_t(0));
+
+    if (result.components == 0
+        || !root.count("bufferViews")
+        || result.buffer_view >= root["bufferViews"].size())
+        return result;
+
+    auto const& view = root["bufferViews"][result.buffer_view];
+
+    index const buffer_index = view.value("buffer", 0u);
+    if (buffer_index >= buffers.size() || !buffers[buffer_index].addr)
+        return result;
+
+    auto const element_size = component_size(result.component) * result.components;
+
+    result.stride = view.value("byteStride", size_t(0));
+    if (result.stride == 0)
+        result.stride = element_size;
+
+    auto const view_offset = view.value("byteOffset", size_t(0));
+    auto const view_size = view.value("byteLength", size_t(0));
+
+    auto const& buffer = buffers[buffer_index];
+    if (view_offset + view_size > buffer.size
+        || (result.count > 0
+            && result.offset + (result.count - 1) * result.stride + element_size > view_size)) {
+        logger()->error("gltf accessor out of range: {}", path.string());
+        return result;
+    }
+
+    result.data = reinterpret_cast<ui8 const*>(buffer.addr) + view_offset + result.offset;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+string gltf_document::get_texture_file(json const& texture_info) const {
+    if (!texture_info.count("index") || !root.count("textures"))
+        return {};
+
+    index const texture_index = texture_info["index"];
+    if (texture_index >= root["textures"].size())
+        return {};
+
+    auto const& texture = root["textures"][texture_index];
+    if (!texture.count("source") || !root.count("images"))
+        return {};
+
+    index const image_index = texture["source"];
+    if (image_index >= root["images"].size())
+        return {};
+
+    auto const& image = root["images"][image_index];
+    if (!image.count("uri"))
+        return {};
+
+    string const uri = image["uri"];
+    if (uri.starts_with("data:"))
+        return {};
+
+    auto image_path = path;
+    image_path.replace_filename(uri);
+    return image_path.string();
+}
+
+/**
+ * @brief Check if accessor is a float attribute of vertex
+ * @param accessor      Accessor to check
+ * @param components    Expected components
+ * @return Accessor matches or not
+ */
+bool float_attribute(gltf_accessor const& accessor,
+                     ui32 components) {
+    return accessor.valid()
+           && accessor.component == gltf_float
+           && accessor.components == components;
+}
+
+/**
+ * @brief Read primitive into mesh data
+ * @param doc          glTF document
+ * @param primitive    Primitive json
+ * @param target       Target mesh data
+ * @return Read was successful or failed
+ */
+bool read_primitive(gltf_document const& doc,
+                    json const& primitive,
+                    mesh_data& target) {
+    if (primitive.value("mode", gltf_mode_triangles) != gltf_mode_triangles) {
+        logger()->warn("gltf primitive mode not supported: {}", doc.path.string());
+        return false;
+    }
+
+    if (!primitive.count("attributes"))
+        return false;
+
+    auto const& attributes = primitive["attributes"];
+
+    auto const get_attribute = [&](name attribute) {
+        if (!attributes.count(attribute))
+            return gltf_accessor{};
+        return doc.get_accessor(attributes[attribute].get<index>());
+    };
+
+    auto const position = get_attribute("POSITION");
+    if (!float_attribute(position, 3) || position.count == 0)
+        return false;
+
+    auto const normal = get_attribute("NORMAL");
+    auto const uv = get_attribute("TEXCOORD_0");
+    auto const color = get_attribute("COLOR_0");
+
+    auto const vertex_count = position.count;
+    target.vertices.resize(vertex_count);
+
+    // interleaved buffer view with matching layout maps directly
+    auto const matches = [&](gltf_accessor const& accessor, ui32 components, size_t offset) {
+        return float_attribute(accessor, components)
+               && accessor.count == vertex_count
+               && accessor.buffer_view == position.buffer_view
+               && accessor.stride == sizeof(vertex)
+               && accessor.offset - position.offset + offsetof(vertex, position) == offset;
+    };
+
+    if (position.stride == sizeof(vertex)
+        && position.offset >= offsetof(vertex, position)
+        && matches(normal, 3, offsetof(vertex, normal))
+        && matches(uv, 2, offsetof(vertex, uv))
+        && matches(color, 4, offsetof(vertex, color))) {
+        memcpy(target.vertices.data(),
+               position.data - offsetof(vertex, position),
+               vertex_count * sizeof(vertex));
+    } else {
+        auto const read_attribute = [&](gltf_accessor const& accessor,
+                                        ui32 components,
+                                        size_t offset,
+                                        r32 fill) {
+            auto const usable = accessor.valid() && accessor.count >= vertex_count;
+
+            for (auto i = 0u; i < vertex_count; ++i) {
+                auto target_ptr = reinterpret_cast<ui8*>(&target.vertices[i]) + offset;
+
+                for (auto c = 0u; c < components; ++c) {
+                    auto value = fill;
+                    if (usable && c < accessor.components)
+                        value = accessor.read(i, c);
+
+                    memcpy(target_ptr + c * sizeof(r32), &value, sizeof(r32));
+                }
+            }
+        };
+
+        // float attribute (packed or interleaved view): copy per vertex
+        auto const copy_attribute = [&](gltf_accessor const& accessor,
+                                        ui32 components,
+                                        size_t offset,
+                                        r32 fill) {
+            if (!float_attribute(accessor, components) || accessor.count < vertex_count) {
+                read_attribute(accessor, components, offset, fill);
+                return;
+            }
+
+            auto const size = components * sizeof(r32);
+
+            auto source = accessor.data;
+            for (auto i = 0u; i < vertex_count; ++i, source += accessor.stride)
+                memcpy(reinterpret_cast<ui8*>(&target.vertices[i]) + offset, source, size);
+        };
+
+        copy_attribute(position, 3, offsetof(vertex, position), 0.f);
+        copy_attribute(normal, 3, offsetof(vertex, normal), 0.f);
+        copy_attribute(uv, 2, offsetof(vertex, uv), 0.f);
+        copy_attribute(color, 4, offsetof(vertex, color), 1.f);
+    }
+
+    if (primitive.count("indices")) {
+        auto const indices = doc.get_accessor(primitive["indices"].get<index>());
+        if (!indices.valid() || indices.components != 1)
+            return false;
+
+        target.indices.resize(indices.count);
+
+        if (indices.component == gltf_unsigned_int && indices.stride == sizeof(ui32)) {
+            memcpy(target.indices.data(),
+                   indices.data,
+                   indices.count * sizeof(ui32));
+        } else {
+            for (auto i = 0u; i < indices.count; ++i)
+                target.indices[i] = indices.read_index(i);
+        }
+
+        for (auto const i : target.indices)
+            if (i >= vertex_count) {
+                logger()->error("gltf index out of range: {}", doc.path.string());
+                return false;
+            }
+    } else {
+        target.indices.resize(vertex_count);
+        for (auto i = 0u; i < vertex_count; ++i)
+            target.indices[i] = i;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read material
+ * @param doc               glTF document
+ * @param material          Material json
+ * @return gltf_material    Material
+ */
+gltf_material read_material(gltf_document const& doc,
+                            json const& material) {
+    gltf_material result;
+    result.name = material.value("name", string());
+    result.double_sided = material.value("doubleSided", false);
+
+    if (material.count("pbrMetallicRoughness")) {
+        auto const& pbr = material["pbrMetallicRoughness"];
+
+        if (pbr.count("baseColorFactor") && pbr["baseColorFactor"].size() == 4)
+            for (auto i = 0u; i < 4; ++i)
+                result.base_color_factor[i] = pbr["baseColorFactor"][i];
+
+        result.metallic_factor = pbr.value("metallicFactor", 1.f);
+        result.roughness_factor = pbr.value("roughnessFactor", 1.f);
+
+        if (pbr.count("baseColorTexture"))
+            result.base_color_texture = doc.get_texture_file(pbr["baseColorTexture"]);
+
+        if (pbr.count("metallicRoughnessTexture"))
+            result.metallic_roughness_texture = doc.get_texture_file(pbr["metallicRoughnessTexture"]);
+    }
+
+    if (material.count("emissiveFactor") && material["emissiveFactor"].size() == 3)
+        for (auto i = 0u; i < 3; ++i)
+            result.emissive_factor[i] = material["emissiveFactor"][i];
+
+    if (material.count("normalTexture"))
+        result.normal_texture = doc.get_texture_file(material["normalTexture"]);
+
+    if (material.count("emissiveTexture"))
+        result.emissive_texture = doc.get_texture_file(material["emissiveTexture"]);
+
+    return result;
+}
+
+/**
+ * @brief Get local transform of node
+ * @param node      Node json
+ * @return mat4     Local transform
+ */
+mat4 get_node_transform(json const& node) {
+    if (node.count("matrix") && node["matrix"].size() == 16) {
+        mat4 result;
+        for (auto i = 0u; i < 16; ++i)
+            result[i / 4][i % 4] = node["matrix"][i];
+        return result;
+    }
+
+    auto translation = v3(0.f);
+    if (node.count("translation") && node["translation"].size() == 3)
+        for (auto i = 0u; i < 3; ++i)
+            translation[i] = node["translation"][i];
+
+    auto rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+    if (node.count("rotation") && node["rotation"].size() == 4)
+        rotation = glm::quat(node["rotation"][3].get<r32>(),
+                             node["rotation"][0].get<r32>(),
+                             node["rotation"][1].get<r32>(),
+                             node["rotation"][2].get<r32>());
+
+    auto scale = v3(1.f);
+    if (node.count("scale") && node["scale"].size() == 3)
+        for (auto i = 0u; i < 3; ++i)
+            scale[i] = node["scale"][i];
+
+    return glm::translate(mat4(1.f), translation)
+           * glm::mat4_cast(rotation)
+           * glm::scale(mat4(1.f), scale);
+}
+
+/// Function called for each mesh instance (mesh index, world transform)
+using gltf_mesh_func = std::function<void(index, mat4 const&)>;
+
+/**
+ * @brief Visit mesh instances of default scene
+ * @param doc     glTF document
+ * @param func    Function called for each mesh instance
+ */
+void visit_mesh_nodes(gltf_document const& doc,
+                      gltf_mesh_func const& func) {
+    if (!doc.root.count("nodes")) {
+        // no scene graph: every mesh once
+        if (doc.root.count("meshes"))
+            for (auto i = 0u; i < doc.root["meshes"].size(); ++i)
+                func(i, mat4(1.f));
+        return;
+    }
+
+    auto const& nodes = doc.root["nodes"];
+
+    std::function<void(index, mat4 const&, ui32)> visit;
+    visit = [&](index node_index, mat4 const& parent, ui32 depth) {
+        if (node_index >= nodes.size() || depth > nodes.size())
+            return;
+
+        auto const& node = nodes[node_index];
+        auto const transform = parent * get_node_transform(node);
+
+        if (node.count("mesh"))
+            func(node["mesh"].get<index>(), transform);
+
+        if (node.count("children"))
+            for (auto const& child : node["children"])
+                visit(child.get<index>(), transform, depth + 1);
+    };
+
+    index_list roots;
+    if (doc.root.count("scenes") && !doc.root["scenes"].empty()) {
+        index scene = doc.root.value("scene", 0u);
+        if (scene >= doc.root["scenes"].size())
+            scene = 0;
+
+        auto const& scene_json = doc.root["scenes"][scene];
+        if (scene_json.count("nodes"))
+            for (auto const& node : scene_json["nodes"])
+                roots.push_back(node.get<index>());
+    } else {
+        // no scene: nodes without parent are roots
+        std::vector<bool> is_child(nodes.size(), false);
+        for (auto const& node : nodes)
+            if (node.count("children"))
+                for (auto const& child : node["children"])
+                    if (child.get<index>() < nodes.size())
+                        is_child[child.get<index>()] = true;
+
+        for (auto i = 0u; i < nodes.size(); ++i)
+            if (!is_child[i])
+                roots.push_back(i);
+    }
+
+    for (auto const root : roots)
+        visit(root, mat4(1.f), 0);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+gltf_model::s_ptr load_gltf(device::ptr device,
+                            string_ref filename) {
+    gltf_document doc;
+    if (!doc.load(filename))
+        return nullptr;
+
+    auto model = gltf_model::make();
+
+    if (doc.root.count("materials"))
+        for (auto const& material : doc.root["materials"])
+            model->materials.push_back(read_material(doc, material));
+
+    if (!doc.root.count("meshes"))
+        return nullptr;
+
+    auto const& meshes = doc.root["meshes"];
+
+    /// Primitive meshes of glTF mesh (created on first use)
+    struct primitive_mesh {
+        mesh::s_ptr mesh;
+        index material = no_index;
+    };
+
+    std::vector<std::vector<primitive_mesh>> primitives(meshes.size());
+    std::vector<bool> loaded(meshes.size(), false);
+
+    auto result = true;
+
+    visit_mesh_nodes(doc, [&](index mesh_index, mat4 const& transform) {
+        if (!result || mesh_index >= meshes.size())
+            return;
+
+        auto const& mesh_json = meshes[mesh_index];
+
+        if (!loaded[mesh_index]) {
+            loaded[mesh_index] = true;
+
+            if (mesh_json.count("primitives"))
+                for (auto const& primitive : mesh_json["primitives"]) {
+                    auto product = mesh::make();
+                    if (!read_primitive(doc, primitive, product->get_data()))
+                        continue;
+
+                    if (!product->create(device)) {
+                        result = false;
+                        return;
+                    }
+
+                    primitives[mesh_index].push_back({
+                        .mesh = product,
+                        .material = primitive.value("material", no_index),
+                    });
+                }
+        }
+
+        for (auto const& primitive : primitives[mesh_index])
+            model->submeshes.push_back({
+                .name = mesh_json.value("name", string()),
+                .mesh = primitive.mesh,
+                .material = primitive.material < model->materials.size()
+                                ? primitive.material
+                                : no_index,
+                .transform = transform,
+            });
+    });
+
+    if (!result || model->submeshes.empty()) {
+        model->destroy();
+        return nullptr;
+    }
+
+    return model;
+}
+
+//-----------------------------------------------------------------------------
+bool load_gltf_mesh_data(string_ref filename,
+                         mesh_data& target) {
+    gltf_document doc;
+    if (!doc.load(filename))
+        return false;
+
+    if (!doc.root.count("meshes"))
+        return false;
+
+    auto const& meshes = doc.root["meshes"];
+
+    std::vector<std::vector<mesh_data>> primitives(meshes.size());
+    std::vector<bool> loaded(meshes.size(), false);
+
+    visit_mesh_nodes(doc, [&](index mesh_index, mat4 const& transform) {
+        if (mesh_index >= meshes.size())
+            return;
+
+        if (!loaded[mesh_index]) {
+            loaded[mesh_index] = true;
+
+            if (meshes[mesh_index].count("primitives"))
+                for (auto const& primitive : meshes[mesh_index]["primitives"]) {
+                    mesh_data data;
+                    if (read_primitive(doc, primitive, data))
+                        primitives[mesh_index].push_back(std::move(data));
+                }
+        }
+
+        auto const normal_matrix = mat3(glm::transpose(glm::inverse(transform)));
+
+        for (auto const& data : primitives[mesh_index]) {
+            auto const base = to_index(target.vertices.size());
+
+            for (auto vertex : data.vertices) {
+                vertex.position = v3(transform * v4(vertex.position, 1.f));
+                if (vertex.normal != v3(0.f))
+                    vertex.normal = glm::normalize(normal_matrix * vertex.normal);
+
+                target.vertices.push_back(vertex);
+            }
+
+            for (auto const i : data.indices)
+                target.indices.push_back(base + i);
+        }
+    });
+
+    return !target.vertices.empty();
+}
+
+} // namespace lava
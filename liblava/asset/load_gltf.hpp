@@ -0,0 +1,121 @@
+/**
+ * @file         liblava/asset/load_gltf.hpp
+ * @brief        Load glTF 2.0 model from file
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief glTF material (metallic roughness)
+ */
+struct gltf_material {
+    /// List of materials
+    using list = std::vector<gltf_material>;
+
+    /// Name of material
+    string name;
+
+    /// Base color factor
+    v4 base_color_factor = v4(1.f);
+
+    /// Metallic factor
+    r32 metallic_factor = 1.f;
+
+    /// Roughness factor
+    r32 roughness_factor = 1.f;
+
+    /// Emissive factor
+    v3 emissive_factor = v3(0.f);
+
+    /// Base color texture file (empty: none or embedded)
+    string base_color_texture;
+
+    /// Metallic roughness texture file (empty: none or embedded)
+    string metallic_roughness_texture;
+
+    /// Normal texture file (empty: none or embedded)
+    string normal_texture;
+
+    /// Emissive texture file (empty: none or embedded)
+    string emissive_texture;
+
+    /// Double sided state
+    bool double_sided = false;
+};
+
+/**
+ * @brief glTF submesh (primitive placed by node)
+ */
+struct gltf_submesh {
+    /// List of submeshes
+    using list = std::vector<gltf_submesh>;
+
+    /// Name of glTF mesh
+    string name;
+
+    /// Mesh of primitive (shared by all nodes using it)
+    mesh::s_ptr mesh;
+
+    /// Index of material (no_index: default material)
+    index material = no_index;
+
+    /// World transform of node
+    mat4 transform = mat4(1.f);
+};
+
+/**
+ * @brief glTF model
+ */
+struct gltf_model : entity {
+    /// Shared pointer to model
+    using s_ptr = std::shared_ptr<gltf_model>;
+
+    /**
+     * @brief Make a new model
+     * @return s_ptr    Shared pointer to model
+     */
+    static s_ptr make() {
+        return std::make_shared<gltf_model>();
+    }
+
+    /**
+     * @brief Destroy the model
+     */
+    void destroy() {
+        for (auto& submesh : submeshes)
+            if (submesh.mesh)
+                submesh.mesh->destroy();
+    }
+
+    /// List of submeshes
+    gltf_submesh::list submeshes;
+
+    /// List of materials
+    gltf_material::list materials;
+};
+
+/**
+ * @brief Load glTF 2.0 model from file (.gltf or .glb)
+ * @param device                Vulkan device
+ * @param filename              File to load
+ * @return gltf_model::s_ptr    Loaded model
+ */
+gltf_model::s_ptr load_gltf(device::ptr device,
+                            string_ref filename);
+
+/**
+ * @brief Load glTF 2.0 file as single mesh data (all primitives, node transforms applied)
+ * @param filename    File to load
+ * @param target      Target mesh data
+ * @return Load was successful or failed
+ */
+bool load_gltf_mesh_data(string_ref filename,
+                         mesh_data& target);
+
+} // namespace lava
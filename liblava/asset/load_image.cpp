@@ -6,6 +6,7 @@
  */
 
 #include "liblava/asset/load_image.hpp"
+#include "liblava/asset/image_decoder.hpp"
 #include "liblava/file/file.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -24,6 +25,8 @@ image_data::s_ptr load_image(string_ref filename) {
 
         if (file_error(image_file.read(data_guard.addr)))
             return nullptr;
+
+        return decode_image(data_guard);
     }
 
     i32 tex_width, tex_height, tex_channels = 0;
@@ -31,15 +34,9 @@ image_data::s_ptr load_image(string_ref filename) {
     if (!result)
         return nullptr;
 
-    if (image_file.opened())
-        result->set_data(data::as_ptr(stbi_load_from_memory((stbi_uc const*)data_guard.addr,
-                                                            to_i32(data_guard.size),
-                                                            &tex_width, &tex_height,
-                                                            &tex_channels, STBI_rgb_alpha)));
-    else
-        result->set_data(data::as_ptr(stbi_load(str(filename),
-                                                &tex_width, &tex_height,
-                                                &tex_channels, STBI_rgb_alpha)));
+    result->set_data(data::as_ptr(stbi_load(str(filename),
+                                            &tex_width, &tex_height,
+                                            &tex_channels, STBI_rgb_alpha)));
 
     if (!result->ready())
         return nullptr;
@@ -52,23 +49,7 @@ image_data::s_ptr load_image(string_ref filename) {
 
 //-----------------------------------------------------------------------------
 image_data::s_ptr load_image(c_data::ref data) {
-    i32 tex_width, tex_height, tex_channels = 0;
-    auto result = std::make_shared<image_data>();
-    if (!result)
-        return nullptr;
-
-    result->set_data(data::as_ptr(stbi_load_from_memory((stbi_uc const*)data.addr,
-                                                        to_i32(data.size),
-                                                        &tex_width, &tex_height,
-                                                        &tex_channels, STBI_rgb_alpha)));
-
-    if (!result->ready())
-        return nullptr;
-
-    result->dimensions = {tex_width, tex_height};
-    result->channels = tex_channels;
-
-    return result;
+    return decode_image(data);
 }
 
 } // namespace lava
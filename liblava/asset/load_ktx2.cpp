@@ -0,0 +1,251 @@
+/**
+ * @file         liblava/asset/load_ktx2.cpp
+ * @brief        Load KTX2 texture with Basis Universal transcoding
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/load_ktx2.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+#include "liblava/util/thread.hpp"
+
+#ifdef LAVA_BASISU
+    #include "transcoder/basisu_transcoder.h"
+    #include <atomic>
+    #include <mutex>
+#endif
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+VkFormat select_ktx2_format(device::ptr device,
+                            bool has_alpha,
+                            bool srgb) {
+    auto const& features = device->get_features();
+
+    auto const supported = [&](VkFormat format) {
+        return find_supported_format(device->get_vk_physical_device(),
+                                     {format},
+                                     VK_IMAGE_USAGE_SAMPLED_BIT
+                                         | VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+            .has_value();
+    };
+
+    VkFormats candidates;
+
+    if (features.textureCompressionBC)
+        candidates.push_back(srgb ? VK_FORMAT_BC7_SRGB_BLOCK
+                                  : VK_FORMAT_BC7_UNORM_BLOCK);
+
+    if (features.textureCompressionASTC_LDR)
+        candidates.push_back(srgb ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+                                  : VK_FORMAT_ASTC_4x4_UNORM_BLOCK);
+
+    if (features.textureCompressionBC) {
+        if (has_alpha)
+            candidates.push_back(srgb ? VK_FORMAT_BC3_SRGB_BLOCK
+                                      : VK_FORMAT_BC3_UNORM_BLOCK);
+        else
+            candidates.push_back(srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                                      : VK_FORMAT_BC1_RGB_UNORM_BLOCK);
+    }
+
+    if (features.textureCompressionETC2) {
+        if (has_alpha)
+            candidates.push_back(srgb ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+                                      : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK);
+        else
+            candidates.push_back(srgb ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+                                      : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK);
+    }
+
+    for (auto format : candidates)
+        if (supported(format))
+            return format;
+
+    return srgb ? VK_FORMAT_R8G8B8A8_SRGB
+                : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+#ifdef LAVA_BASISU
+
+namespace {
+
+/**
+ * @brief Get the Basis transcoder format of a Vulkan format
+ * @param format                              Target format
+ * @return basist::transcoder_texture_format  Transcoder format
+ */
+basist::transcoder_texture_format get_transcoder_format(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFBC7_RGBA;
+    case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+    case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFBC3_RGBA;
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFBC1_RGB;
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFETC2_RGBA;
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        return basist::transcoder_texture_format::cTFETC1_RGB;
+    default:
+        return basist::transcoder_texture_format::cTFRGBA32;
+    }
+}
+
+/**
+ * @brief Transcode task of one image
+ */
+struct ktx2_image {
+    /// List of images
+    using list = std::vector<ktx2_image>;
+
+    /// Mip level
+    ui32 level = 0;
+
+    /// Layer (or face)
+    ui32 layer = 0;
+
+    /// Offset in upload data
+    size_t offset = 0;
+
+    /// Size in blocks or pixels
+    ui32 count = 0;
+};
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+texture::s_ptr create_ktx2_texture(device::ptr device,
+                                   c_data::ref data,
+                                   ui32 thread_count) {
+    static std::once_flag init_flag;
+    std::call_once(init_flag, [] {
+        basist::basisu_transcoder_init();
+    });
+
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(data.addr, to_ui32(data.size))) {
+        logger()->error("load ktx2 texture - invalid data");
+        return nullptr;
+    }
+
+    if (!transcoder.start_transcoding()) {
+        logger()->error("load ktx2 texture - start transcoding");
+        return nullptr;
+    }
+
+    auto const srgb = transcoder.get_dfd_transfer_func() == basist::KTX2_KHR_DF_TRANSFER_SRGB;
+    auto const format = select_ktx2_format(device,
+                                           transcoder.get_has_alpha(),
+                                           srgb);
+    auto const target = get_transcoder_format(format);
+
+    auto const uncompressed = basist::basis_transcoder_format_is_uncompressed(target);
+    auto const unit_size = basist::basis_get_bytes_per_block_or_pixel(target);
+
+    auto const level_count = std::max(transcoder.get_levels(), 1u);
+    auto const layer_count = std::max(transcoder.get_layers(), 1u);
+    auto const face_count = transcoder.get_faces();
+
+    auto type = texture_type::tex_2d;
+    if (face_count == 6)
+        type = texture_type::cube_map;
+    else if (layer_count > 1)
+        type = texture_type::array;
+
+    // layers of texture: array layers or cube faces
+    auto const texture_layer_count = face_count == 6 ? face_count : layer_count;
+
+    texture::layer::list layers(texture_layer_count);
+    ktx2_image::list images;
+    size_t data_size = 0;
+
+    for (auto layer = 0u; layer < texture_layer_count; ++layer) {
+        for (auto level = 0u; level < level_count; ++level) {
+            basist::ktx2_image_level_info info;
+            if (!transcoder.get_image_level_info(info,
+                                                 level,
+                                                 face_count == 6 ? 0 : layer,
+                                                 face_count == 6 ? layer : 0)) {
+                logger()->error("load ktx2 texture - level info");
+                return nullptr;
+            }
+
+            auto const count = uncompressed ? info.m_orig_width * info.m_orig_height
+                                            : info.m_total_blocks;
+
+            layers[layer].levels.push_back({{info.m_orig_width, info.m_orig_height},
+                                            count * unit_size});
+
+            images.push_back({level, layer, data_size, count});
+            data_size += count * unit_size;
+        }
+    }
+
+    std::vector<ui8> upload_data(data_size);
+    std::atomic<bool> failed = false;
+
+    parallel_for(thread_count, images.size(), [&](size_t i) {
+        auto const& image = images[i];
+
+        // own state per task for thread safety
+        basist::ktx2_transcoder_state state;
+
+        if (!transcoder.transcode_image_level(image.level,
+                                              face_count == 6 ? 0 : image.layer,
+                                              face_count == 6 ? image.layer : 0,
+                                              upload_data.data() + image.offset,
+                                              image.count,
+                                              target,
+                                              0,
+                                              0,
+                                              0,
+                                              -1,
+                                              -1,
+                                              &state))
+            failed = true;
+    });
+
+    if (failed) {
+        logger()->error("load ktx2 texture - transcode");
+        return nullptr;
+    }
+
+    auto texture = texture::make();
+
+    uv2 const size = layers.front().levels.front().extent;
+    if (!texture->create(device, size, format, layers, type))
+        return nullptr;
+
+    if (!texture->upload(upload_data.data(), upload_data.size()))
+        return nullptr;
+
+    logger()->trace("ktx2 texture transcoded: {} x {} - {} levels - format {}",
+                    size.x, size.y, level_count, to_ui32(format));
+
+    return texture;
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+texture::s_ptr create_ktx2_texture(device::ptr,
+                                   c_data::ref,
+                                   ui32) {
+    logger()->error("load ktx2 texture - built without LIBLAVA_BASISU");
+    return nullptr;
+}
+
+#endif
+
+} // namespace lava
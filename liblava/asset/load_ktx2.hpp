@@ -0,0 +1,40 @@
+/**
+ * @file         liblava/asset/load_ktx2.hpp
+ * @brief        Load KTX2 texture with Basis Universal transcoding
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/texture.hpp"
+
+namespace lava {
+
+/**
+ * @brief Select the transcode target of a KTX2 texture
+ *
+ * Prefers BC7, ASTC 4x4, BC1/BC3 and ETC2 in this order, limited to
+ * compression features enabled on the device. Falls back to RGBA8.
+ *
+ * @param device       Vulkan device
+ * @param has_alpha    Texture has alpha channel
+ * @param srgb         Texture has sRGB transfer function
+ * @return VkFormat    Target format
+ */
+VkFormat select_ktx2_format(device::ptr device,
+                            bool has_alpha,
+                            bool srgb);
+
+/**
+ * @brief Create a texture from KTX2 data (Basis Universal or UASTC)
+ * @param device             Vulkan device
+ * @param data               KTX2 file data
+ * @param thread_count       Number of transcode threads (0: hardware concurrency)
+ * @return texture::s_ptr    Loaded texture (nullptr: not supported in build)
+ */
+texture::s_ptr create_ktx2_texture(device::ptr device,
+                                   c_data::ref data,
+                                   ui32 thread_count = 0);
+
+} // namespace lava
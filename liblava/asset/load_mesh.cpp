@@ -6,7 +6,9 @@
  */
 
 #include "liblava/asset/load_mesh.hpp"
+#include "liblava/asset/load_gltf.hpp"
 #include "liblava/file.hpp"
+#include <sstream>
 
 #ifdef _WIN32
     #pragma warning(push, 4)
@@ -26,9 +28,123 @@
 
 namespace lava {
 
+/// Minimal OBJ file size for parallel parser
+constexpr size_t const obj_parallel_min_size = 8 << 20;
+
+namespace {
+
+/**
+ * @brief Add tinyobjloader shapes to mesh data (one vertex per index)
+ * @param attrib    OBJ attributes
+ * @param shapes    OBJ shapes
+ * @param target    Target mesh data
+ * @param result    Optional list of shapes
+ */
+void add_obj_shapes(tinyobj::attrib_t const& attrib,
+                    std::vector<tinyobj::shape_t> const& shapes,
+                    mesh_data& target,
+                    obj_shape::list* result) {
+    for (auto const& shape : shapes) {
+        auto const first_index = to_index(target.indices.size());
+
+        for (auto const& index : shape.mesh.indices) {
+            vertex vertex;
+
+            vertex.position = v3(attrib.vertices[3 * index.vertex_index],
+                                 attrib.vertices[3 * index.vertex_index + 1],
+                                 attrib.vertices[3 * index.vertex_index + 2]);
+
+            vertex.color = v4(1.f);
+
+            // faces may miss texcoord or normal
+            vertex.uv = index.texcoord_index < 0
+                            ? v2(0.f)
+                            : v2(attrib.texcoords[2 * index.texcoord_index],
+                                 1.f - attrib.texcoords[2 * index.texcoord_index + 1]);
+
+            vertex.normal = index.normal_index < 0
+                                ? v3(0.f)
+                                : v3(attrib.normals[3 * index.normal_index],
+                                     attrib.normals[3 * index.normal_index + 1],
+                                     attrib.normals[3 * index.normal_index + 2]);
+
+            target.vertices.push_back(vertex);
+            target.indices.push_back(to_index(target.indices.size()));
+        }
+
+        if (result && !shape.mesh.indices.empty())
+            result->push_back({
+                .name = shape.name,
+                .first_index = first_index,
+                .index_count = to_ui32(shape.mesh.indices.size()),
+            });
+    }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool load_obj_mesh_data(c_data source,
+                        mesh_data& target,
+                        obj_shape::list* shapes) {
+    if (!source.addr || source.size == 0)
+        return false;
+
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> obj_shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string err;
+    std::string warn;
+
+    std::istringstream stream(std::string(source.addr, source.size));
+
+    if (!tinyobj::LoadObj(&attrib,
+                          &obj_shapes,
+                          &materials,
+                          &warn, &err,
+                          &stream))
+        return false;
+
+    add_obj_shapes(attrib, obj_shapes, target, shapes);
+
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 mesh::s_ptr load_mesh(device::ptr device, string_ref filename, string_ref temp_dir) {
+    if (extension(filename, string_list{"GLTF", "GLB"})) {
+        auto mesh = mesh::make();
+        if (!load_gltf_mesh_data(filename, mesh->get_data()))
+            return nullptr;
+
+        if (!mesh->create(device))
+            return nullptr;
+
+        return mesh;
+    }
+
     if (extension(filename, "OBJ")) {
+        {
+            file file(filename);
+            if (file.opened() && file.get_size() >= i64(obj_parallel_min_size)) {
+                file_data obj_data(filename);
+                if (!obj_data.addr)
+                    return nullptr;
+
+                auto mesh = mesh::make();
+                if (!parse_obj(obj_data, mesh->get_data()))
+                    return nullptr;
+
+                if (mesh->empty())
+                    return nullptr;
+
+                if (!mesh->create(device))
+                    return nullptr;
+
+                return mesh;
+            }
+        }
+
         tinyobj::attrib_t attrib;
         std::vector<tinyobj::shape_t> shapes;
         std::vector<tinyobj::material_t> materials;
@@ -68,30 +184,7 @@ mesh::s_ptr load_mesh(device::ptr device, string_ref filename, string_ref temp_d
                              str(target_file))) {
             auto mesh = mesh::make();
 
-            for (auto const& shape : shapes) {
-                for (auto const& index : shape.mesh.indices) {
-                    vertex vertex;
-
-                    vertex.position = v3(attrib.vertices[3 * index.vertex_index],
-                                         attrib.vertices[3 * index.vertex_index + 1],
-                                         attrib.vertices[3 * index.vertex_index + 2]);
-
-                    vertex.color = v4(1.f);
-
-                    if (!attrib.texcoords.empty())
-                        vertex.uv = v2(attrib.texcoords[2 * index.texcoord_index],
-                                       1.f - attrib.texcoords[2 * index.texcoord_index + 1]);
-
-                    vertex.normal = attrib.normals.empty()
-                                        ? v3(0.f)
-                                        : v3(attrib.normals[3 * index.normal_index],
-                                             attrib.normals[3 * index.normal_index + 1],
-                                             attrib.normals[3 * index.normal_index + 2]);
-
-                    mesh->get_vertices().push_back(vertex);
-                    mesh->get_indices().push_back(mesh->get_indices_count());
-                }
-            }
+            add_obj_shapes(attrib, shapes, mesh->get_data(), nullptr);
 
             if (mesh->empty())
                 return nullptr;
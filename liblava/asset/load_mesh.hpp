@@ -7,10 +7,24 @@
 
 #pragma once
 
-#include "liblava/resource/mesh.hpp"
+#include "liblava/asset/parse_obj.hpp"
 
 namespace lava {
 
+/**
+ * @brief Load OBJ data into mesh data with tinyobjloader
+ *
+ * Reference of parse_obj: same vertices, indices and shapes.
+ *
+ * @param source    OBJ file data
+ * @param target    Target mesh data
+ * @param shapes    Optional list of shapes
+ * @return Load was successful or failed
+ */
+bool load_obj_mesh_data(c_data source,
+                        mesh_data& target,
+                        obj_shape::list* shapes = nullptr);
+
 /**
  * @brief Load mesh from file
  * @param device          Vulkan device
@@ -6,8 +6,13 @@
  */
 
 #include "liblava/asset/load_texture.hpp"
+#include "liblava/asset/compress_texture.hpp"
+#include "liblava/asset/image_decoder.hpp"
+#include "liblava/asset/load_ktx2.hpp"
 #include "liblava/file.hpp"
 #include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+#include "liblava/util/thread.hpp"
 
 #ifdef _WIN32
     #pragma warning(push, 4)
@@ -34,29 +39,121 @@
     #pragma GCC diagnostic pop
 #endif
 
-#include "stb_image.h"
-
 namespace lava {
 
+namespace {
+
+/// Number of entries in linear to sRGB table
+constexpr ui32 const linear_to_srgb_steps = 4096;
+
 /**
- * @brief Create a gli 2D texture
- * @param device             Vulkan device
- * @param file               File to load
- * @param format             Format of texture
- * @param temp_data          Data of texture
- * @return texture::s_ptr    Loaded texture
+ * @brief Get the sRGB to linear lookup table
+ * @return std::array<r32, 256> const&    Linear value by sRGB byte
  */
-texture::s_ptr create_gli_texture_2d(device::ptr device,
-                                     file::ref file,
-                                     VkFormat format,
-                                     u_data::ref temp_data) {
-    gli::texture2d tex(file.opened() ? gli::load(temp_data.addr, temp_data.size)
-                                     : gli::load(file.get_path()));
-    LAVA_ASSERT(!tex.empty());
-    if (tex.empty())
-        return nullptr;
+std::array<r32, 256> const& srgb_to_linear_table() {
+    static auto const table = [] {
+        std::array<r32, 256> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            auto const c = i / 255.f;
+            result[i] = c <= 0.04045f ? c / 12.92f
+                                      : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return result;
+    }();
+    return table;
+}
 
-    auto mip_levels = to_ui32(tex.levels());
+/**
+ * @brief Get the linear to sRGB lookup table
+ * @return std::array<ui8, linear_to_srgb_steps> const&    sRGB byte by quantized linear value
+ */
+std::array<ui8, linear_to_srgb_steps> const& linear_to_srgb_table() {
+    static auto const table = [] {
+        std::array<ui8, linear_to_srgb_steps> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            auto const l = i / r32(linear_to_srgb_steps - 1);
+            auto const c = l <= 0.0031308f ? l * 12.92f
+                                           : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+            result[i] = static_cast<ui8>(std::clamp(c, 0.f, 1.f) * 255.f + 0.5f);
+        }
+        return result;
+    }();
+    return table;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::vector<ui8> generate_mips_rgba8(ui8 const* data,
+                                     uv2 size,
+                                     bool srgb,
+                                     ui32 thread_count) {
+    auto const layers = make_mip_layers(size, 4);
+    auto const& levels = layers.front().levels;
+
+    size_t total_size = 0;
+    for (auto const& level : levels)
+        total_size += level.size;
+
+    std::vector<ui8> result(total_size);
+    memcpy(result.data(), data, levels.front().size);
+
+    auto const& to_linear = srgb_to_linear_table();
+    auto const& to_srgb = linear_to_srgb_table();
+
+    // rows of a level per task
+    constexpr ui32 const band_rows = 64;
+
+    auto src = result.data();
+    for (auto l = 1u; l < levels.size(); ++l) {
+        auto const src_extent = levels[l - 1].extent;
+        auto const dst_extent = levels[l].extent;
+        auto const dst = src + levels[l - 1].size;
+
+        auto const band_count = (dst_extent.y + band_rows - 1) / band_rows;
+
+        parallel_for(thread_count, band_count, [&](size_t band) {
+            auto const row_begin = to_ui32(band) * band_rows;
+            auto const row_end = std::min(dst_extent.y, row_begin + band_rows);
+
+            for (auto y = row_begin; y < row_end; ++y) {
+                auto const row0 = src + std::min(y * 2, src_extent.y - 1) * src_extent.x * 4;
+                auto const row1 = src + std::min(y * 2 + 1, src_extent.y - 1) * src_extent.x * 4;
+                auto target = dst + y * dst_extent.x * 4;
+
+                for (auto x = 0u; x < dst_extent.x; ++x) {
+                    auto const x0 = std::min(x * 2, src_extent.x - 1) * 4;
+                    auto const x1 = std::min(x * 2 + 1, src_extent.x - 1) * 4;
+
+                    for (auto c = 0u; c < 4; ++c) {
+                        if (srgb && c < 3) {
+                            auto const sum = to_linear[row0[x0 + c]] + to_linear[row0[x1 + c]]
+                                             + to_linear[row1[x0 + c]] + to_linear[row1[x1 + c]];
+                            auto const step = to_ui32(sum * 0.25f * (linear_to_srgb_steps - 1) + 0.5f);
+                            target[x * 4 + c] = to_srgb[std::min(step, linear_to_srgb_steps - 1)];
+                        } else {
+                            target[x * 4 + c] = static_cast<ui8>((row0[x0 + c] + row0[x1 + c]
+                                                                  + row1[x0 + c] + row1[x1 + c] + 2)
+                                                                 / 4);
+                        }
+                    }
+                }
+            }
+        });
+
+        src = dst;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Create a layer list for a 2D texture
+ * @param tex                      Target texture
+ * @return texture::layer::list    List with one texture layer
+ */
+texture::layer::list create_layer_list(gli::texture2d const& tex) {
+    auto const mip_levels = to_ui32(tex.levels());
 
     texture::layer layer;
 
@@ -69,8 +166,20 @@ texture::s_ptr create_gli_texture_2d(device::ptr device,
         layer.levels.push_back(level);
     }
 
-    texture::layer::list layers;
-    layers.push_back(layer);
+    return {layer};
+}
+
+/**
+ * @brief Create a texture from a gli 2D texture
+ * @param device             Vulkan device
+ * @param tex                gli 2D texture
+ * @param format             Format of texture
+ * @return texture::s_ptr    Loaded texture
+ */
+texture::s_ptr create_gli_texture_2d(device::ptr device,
+                                     gli::texture2d const& tex,
+                                     VkFormat format) {
+    auto const layers = create_layer_list(tex);
 
     auto texture = texture::make();
 
@@ -89,6 +198,27 @@ texture::s_ptr create_gli_texture_2d(device::ptr device,
     return texture;
 }
 
+/**
+ * @brief Create a gli 2D texture
+ * @param device             Vulkan device
+ * @param file               File to load
+ * @param format             Format of texture
+ * @param temp_data          Data of texture
+ * @return texture::s_ptr    Loaded texture
+ */
+texture::s_ptr create_gli_texture_2d(device::ptr device,
+                                     file::ref file,
+                                     VkFormat format,
+                                     u_data::ref temp_data) {
+    gli::texture2d tex(file.opened() ? gli::load(temp_data.addr, temp_data.size)
+                                     : gli::load(file.get_path()));
+    LAVA_ASSERT(!tex.empty());
+    if (tex.empty())
+        return nullptr;
+
+    return create_gli_texture_2d(device, tex, format);
+}
+
 /**
  * @brief Create a layer list for a texture
  * @param tex                      Target texture
@@ -193,57 +323,339 @@ texture::s_ptr create_gli_texture_cube_map(device::ptr device,
 }
 
 /**
- * @brief Create a stbi texture
+ * @brief Get the gli format of a texture compression
+ * @param compression      Texture compression
+ * @return gli::format     Block format
+ */
+gli::format get_gli_format(texture_compression compression) {
+    switch (compression) {
+    case texture_compression::bc1:
+        return gli::FORMAT_RGB_DXT1_SRGB_BLOCK8;
+    case texture_compression::bc3:
+        return gli::FORMAT_RGBA_DXT5_SRGB_BLOCK16;
+    default:
+        return gli::FORMAT_RG_ATI2N_UNORM_BLOCK16;
+    }
+}
+
+/**
+ * @brief Create a block compressed texture (cached as KTX)
  * @param device             Vulkan device
- * @param file               File to load
- * @param temp_data          Data of texture
+ * @param temp_data          Data of texture file
+ * @param tex_file           Texture file
+ * @param cache_path         Path of compressed texture cache
  * @return texture::s_ptr    Loaded texture
  */
-texture::s_ptr create_stbi_texture(device::ptr device,
-                                   file::ref file,
-                                   u_data::ref temp_data) {
-    i32 tex_width = 0, tex_height = 0;
-    stbi_uc* data = nullptr;
-
-    if (file.opened())
-        data = stbi_load_from_memory((stbi_uc const*)temp_data.addr,
-                                     to_i32(temp_data.size),
-                                     &tex_width,
-                                     &tex_height,
-                                     nullptr,
-                                     STBI_rgb_alpha);
+texture::s_ptr create_compressed_texture(device::ptr device,
+                                         u_data::ref temp_data,
+                                         texture_file const& tex_file,
+                                         string_ref cache_path) {
+    auto const cache_filename = fmt::format("{}{}_{}_{}.ktx",
+                                            cache_path,
+                                            hash256({temp_data.addr, temp_data.size}),
+                                            to_ui32(tex_file.compression),
+                                            to_ui32(tex_file.mips));
+
+    if (std::filesystem::exists(cache_filename)) {
+        gli::texture2d tex(gli::load(cache_filename));
+        if (!tex.empty()) {
+            for (auto compression : {texture_compression::bc1,
+                                     texture_compression::bc3,
+                                     texture_compression::bc5})
+                if (tex.format() == get_gli_format(compression))
+                    return create_gli_texture_2d(device, tex,
+                                                 get_compression_format(compression));
+        }
+
+        logger()->warn("texture cache invalid: {}", cache_filename);
+    }
+
+    auto const decoded = decode_image(temp_data);
+    if (!decoded)
+        return nullptr;
+
+    auto const data = (ui8 const*)decoded->get_data();
+
+    uv2 const size = decoded->dimensions;
+
+    auto const compression = select_compression(data,
+                                                size.x * size.y,
+                                                tex_file.compression);
+
+    auto levels = make_mip_layers(size, 4).front().levels;
+    if (tex_file.mips == texture_mips::none)
+        levels.resize(1);
+
+    std::vector<ui8> levels_data;
+    if (levels.size() > 1)
+        levels_data = generate_mips_rgba8(data,
+                                          size,
+                                          compression != texture_compression::bc5);
     else
-        data = stbi_load(str(file.get_path()),
-                         &tex_width,
-                         &tex_height,
-                         nullptr,
-                         STBI_rgb_alpha);
+        levels_data.assign(data, data + size.x * size.y * 4);
+
 
-    if (!data)
+    auto const blocks = compress_rgba8(levels_data.data(),
+                                       levels,
+                                       compression);
+
+    gli::texture2d tex(get_gli_format(compression),
+                       gli::texture2d::extent_type(size.x, size.y),
+                       levels.size());
+    LAVA_ASSERT(tex.size() == blocks.size());
+    if (tex.size() != blocks.size())
         return nullptr;
 
-    auto texture = texture::make();
+    memcpy(tex.data(), blocks.data(), blocks.size());
+
+    if (gli::save_ktx(tex, cache_filename))
+        logger()->info("texture compressed: {} - {} bytes", tex_file.path, blocks.size());
+    else
+        logger()->warn("texture not cached: {}", cache_filename);
+
+    return create_gli_texture_2d(device, tex, get_compression_format(compression));
+}
+
+//-----------------------------------------------------------------------------
+texture_data decode_texture(texture_file const& tex_file,
+                            c_data::ref file_data,
+                            texture_type type,
+                            ui32 thread_count) {
+    texture_data result;
 
-    uv2 const size = {tex_width, tex_height};
-    auto const font_format = VK_FORMAT_R8G8B8A8_SRGB;
-    if (!texture->create(device, size, font_format))
+    if (extension(tex_file.path, {"DDS", "KTX", "KMG"})) {
+        auto const tex = gli::load(file_data.addr, file_data.size);
+        if (tex.empty())
+            return {};
+
+        result.format = tex_file.format;
+        result.size = {tex.extent().x, tex.extent().y};
+        result.type = type;
+
+        switch (type) {
+        case texture_type::tex_2d: {
+            result.layers = create_layer_list(gli::texture2d(tex));
+            break;
+        }
+        case texture_type::array: {
+            gli::texture2d_array const tex_array(tex);
+            result.layers = create_layer_list(tex_array, to_ui32(tex_array.layers()));
+            break;
+        }
+        case texture_type::cube_map: {
+            gli::texture_cube const tex_cube(tex);
+            result.layers = create_layer_list(tex_cube, to_ui32(tex_cube.faces()));
+            break;
+        }
+        case texture_type::none:
+            return {};
+        }
+
+        auto const bytes = static_cast<ui8 const*>(tex.data());
+        result.data.assign(bytes, bytes + tex.size());
+
+        return result;
+    }
+
+    // block compression and KTX2 need the device
+    if (tex_file.compression != texture_compression::none
+        || !extension(tex_file.path,
+                      {"JPG", "PNG", "TGA", "BMP", "PSD", "GIF", "HDR", "PIC"}))
+        return {};
+
+    auto const decoded = decode_image(file_data);
+    if (!decoded)
+        return {};
+
+    auto const data = (ui8 const*)decoded->get_data();
+
+    result.format = VK_FORMAT_R8G8B8A8_SRGB;
+    result.size = decoded->dimensions;
+
+    auto const texel_size = to_ui32(format_block_size(result.format));
+
+    if (tex_file.mips != texture_mips::none)
+        result.layers = make_mip_layers(result.size, texel_size);
+
+    if (tex_file.mips == texture_mips::cpu) {
+        result.data = generate_mips_rgba8(data, result.size, true, thread_count);
+    } else {
+        result.blit_mips = tex_file.mips == texture_mips::gpu;
+        result.data.assign(data, data + result.size.x * result.size.y * texel_size);
+    }
+
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+texture::s_ptr create_texture(device::ptr device,
+                              texture_data const& data) {
+    if (!data.valid())
         return nullptr;
 
-    auto const uploadSize = tex_width * tex_height * format_block_size(font_format);
-    auto result = texture->upload(data, uploadSize);
+    // no blit support: mips on the cpu
+    std::vector<ui8> mip_data;
+    if (data.blit_mips
+        && !support_mip_blit(device->get_vk_physical_device(), data.format))
+        mip_data = generate_mips_rgba8(data.data.data(), data.size, true);
+
+    auto texture = texture::make();
+    if (!texture->create(device, data.size, data.format, data.layers, data.type))
+        return nullptr;
 
-    stbi_image_free(data);
+    texture->set_blit_mips(data.blit_mips && mip_data.empty());
 
-    if (!result)
+    auto const& upload_data = mip_data.empty() ? data.data : mip_data;
+    if (!texture->upload(upload_data.data(), upload_data.size()))
         return nullptr;
 
     return texture;
 }
 
+/// Texture data file signature
+constexpr ui32 const texture_data_magic = 0x5845544c; // LTEX
+
+/// Texture data file version
+constexpr ui32 const texture_data_version = 1;
+
+/**
+ * @brief Texture data file header
+ */
+struct texture_data_header {
+    /// File signature
+    ui32 magic = texture_data_magic;
+
+    /// File version
+    ui32 version = texture_data_version;
+
+    /// Texture format
+    ui32 format = 0;
+
+    /// Texture type
+    ui32 type = 0;
+
+    /// Size of first level
+    ui32 width = 0;
+    ui32 height = 0;
+
+    /// Number of layers
+    ui32 layer_count = 0;
+
+    /// Number of levels per layer
+    ui32 level_count = 0;
+
+    /// Blit mips on stage
+    ui32 blit_mips = 0;
+
+    /// Reserved
+    ui32 padding = 0;
+
+    /// Size of data
+    ui64 data_size = 0;
+};
+
+//-----------------------------------------------------------------------------
+bool write_texture_data(string_ref filename,
+                        texture_data const& data) {
+    if (!data.valid())
+        return false;
+
+    texture_data_header header;
+    header.format = to_ui32(data.format);
+    header.type = to_ui32(data.type);
+    header.width = data.size.x;
+    header.height = data.size.y;
+    header.layer_count = to_ui32(data.layers.size());
+    header.level_count = data.layers.empty()
+                             ? 0
+                             : to_ui32(data.layers.front().levels.size());
+    header.blit_mips = data.blit_mips ? 1 : 0;
+    header.data_size = data.data.size();
+
+    std::vector<texture::mip_level> levels;
+    for (auto& layer : data.layers) {
+        if (layer.levels.size() != header.level_count)
+            return false;
+
+        levels.insert(levels.end(), layer.levels.begin(), layer.levels.end());
+    }
+
+    file file(filename, file_mode::write);
+    if (!file.opened())
+        return false;
+
+    if (file_error(file.write((char const*)&header, sizeof(header))))
+        return false;
+
+    if (!levels.empty()
+        && file_error(file.write((char const*)levels.data(),
+                                 levels.size() * sizeof(texture::mip_level))))
+        return false;
+
+    return !file_error(file.write((char const*)data.data.data(),
+                                  data.data.size()));
+}
+
+//-----------------------------------------------------------------------------
+texture_data read_texture_data(string_ref filename) {
+    u_data file_data;
+    if (!load_file_data(filename, file_data))
+        return {};
+
+    texture_data_header header;
+    if (file_data.size < sizeof(header))
+        return {};
+
+    memcpy(&header, file_data.addr, sizeof(header));
+
+    if (header.magic != texture_data_magic
+        || header.version != texture_data_version
+        || header.type > to_ui32(texture_type::cube_map))
+        return {};
+
+    auto const level_count = size_t(header.layer_count) * header.level_count;
+    auto const levels_size = level_count * sizeof(texture::mip_level);
+
+    // truncated or stale file
+    if (file_data.size != sizeof(header) + levels_size + header.data_size)
+        return {};
+
+    texture_data result;
+    result.format = static_cast<VkFormat>(header.format);
+    result.size = {header.width, header.height};
+    result.type = static_cast<texture_type>(header.type);
+    result.blit_mips = header.blit_mips != 0;
+
+    auto cursor = file_data.addr + sizeof(header);
+
+    size_t levels_data_size = 0;
+    result.layers.resize(header.layer_count);
+    for (auto& layer : result.layers) {
+        layer.levels.resize(header.level_count);
+        memcpy(layer.levels.data(), cursor, header.level_count * sizeof(texture::mip_level));
+        cursor += header.level_count * sizeof(texture::mip_level);
+
+        for (auto& level : layer.levels)
+            levels_data_size += level.size;
+    }
+
+    if (!result.layers.empty()
+        && !result.blit_mips
+        && levels_data_size != header.data_size)
+        return {};
+
+    result.data.assign(cursor, cursor + header.data_size);
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 texture::s_ptr load_texture(device::ptr device,
                             texture_file tex_file,
-                            texture_type type) {
+                            texture_type type,
+                            string_ref cache_path) {
+    auto use_ktx2 = extension(tex_file.path, "KTX2");
     auto use_gli = extension(tex_file.path,
                              {"DDS", "KTX", "KMG"});
     auto use_stbi = false;
@@ -252,7 +664,7 @@ texture::s_ptr load_texture(device::ptr device,
         use_stbi = extension(tex_file.path,
                              {"JPG", "PNG", "TGA", "BMP", "PSD", "GIF", "HDR", "PIC"});
 
-    if (!use_gli && !use_stbi)
+    if (!use_ktx2 && !use_gli && !use_stbi)
         return nullptr;
 
     file file(tex_file.path);
@@ -266,6 +678,14 @@ texture::s_ptr load_texture(device::ptr device,
             return nullptr;
     }
 
+    if (use_ktx2) {
+        if (!file.opened())
+            return nullptr;
+
+        // type and format come from the container
+        return create_ktx2_texture(device, temp_data);
+    }
+
     if (use_gli) {
         texture::layer::list layers;
 
@@ -296,14 +716,84 @@ texture::s_ptr load_texture(device::ptr device,
         }
         }
     } else {
-        return create_stbi_texture(device,
-                                   file,
-                                   temp_data);
+        if (tex_file.compression != texture_compression::none
+            && type == texture_type::tex_2d
+            && !cache_path.empty()
+            && file.opened()
+            && device->get_features().textureCompressionBC)
+            return create_compressed_texture(device,
+                                             temp_data,
+                                             tex_file,
+                                             cache_path);
+
+        if (!file.opened())
+            return nullptr;
+
+        return create_texture(device,
+                              decode_texture(tex_file, temp_data));
     }
 
     return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+streamed_texture::s_ptr load_streamed_texture(device::ptr device,
+                                              texture_file const& tex_file,
+                                              ui32 tail_extent) {
+    auto const use_gli = extension(tex_file.path,
+                                   {"DDS", "KTX", "KMG"});
+    if (!use_gli
+        && !extension(tex_file.path,
+                      {"JPG", "PNG", "TGA", "BMP", "PSD", "GIF", "HDR", "PIC"}))
+        return nullptr;
+
+    file file(tex_file.path);
+    if (!file.opened())
+        return nullptr;
+
+    u_data temp_data(file.get_size());
+    if (file_error(file.read(temp_data.addr)))
+        return nullptr;
+
+    auto result = streamed_texture::make();
+
+    if (use_gli) {
+        gli::texture2d tex(gli::load(temp_data.addr, temp_data.size));
+        if (tex.empty())
+            return nullptr;
+
+        if (!result->create(device,
+                            tex_file.format,
+                            create_layer_list(tex),
+                            {tex.data(), tex.size()},
+                            texture_type::tex_2d,
+                            tail_extent))
+            return nullptr;
+
+        return result;
+    }
+
+    auto const decoded = decode_image(temp_data);
+    if (!decoded)
+        return nullptr;
+
+    auto const data = (ui8 const*)decoded->get_data();
+
+    uv2 const size = decoded->dimensions;
+    auto const mip_data = generate_mips_rgba8(data, size, true);
+
+
+    if (!result->create(device,
+                        VK_FORMAT_R8G8B8A8_SRGB,
+                        make_mip_layers(size, 4),
+                        {mip_data.data(), mip_data.size()},
+                        texture_type::tex_2d,
+                        tail_extent))
+        return nullptr;
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 texture::s_ptr create_default_texture(device::ptr device,
                                       uv2 size,
@@ -8,19 +8,95 @@
 #pragma once
 
 #include "liblava/resource/texture.hpp"
+#include "liblava/resource/texture_stream.hpp"
 
 namespace lava {
 
+/**
+ * @brief Texture decoded on the host
+ */
+struct texture_data {
+    /// Texture format
+    VkFormat format = VK_FORMAT_UNDEFINED;
+
+    /// Size of first level
+    uv2 size{};
+
+    /// Texture type
+    texture_type type = texture_type::tex_2d;
+
+    /// List of layers (empty: single level)
+    texture::layer::list layers;
+
+    /// Data of all levels (layer by layer, first level first)
+    std::vector<ui8> data;
+
+    /// Data contains first level only, blit the others
+    bool blit_mips = false;
+
+    /**
+     * @brief Check if texture data is valid
+     * @return Data is valid or not
+     */
+    bool valid() const {
+        return !data.empty();
+    }
+};
+
+/**
+ * @brief Decode a texture file on the host (thread safe, no device)
+ *
+ * Decodes DDS, KTX and KMG with gli and common image formats with stb.
+ * KTX2 and block compression need the device: use load_texture.
+ *
+ * @param tex_file          Texture file
+ * @param file_data         Data of file
+ * @param type              Type of texture
+ * @param thread_count      Number of threads for mips (0: hardware concurrency)
+ * @return texture_data     Decoded texture (invalid: not supported or failed)
+ */
+texture_data decode_texture(texture_file const& tex_file,
+                            c_data::ref file_data,
+                            texture_type type = texture_type::tex_2d,
+                            ui32 thread_count = 0);
+
+/**
+ * @brief Create a texture from decoded data and upload it
+ * @param device             Vulkan device
+ * @param data               Decoded texture
+ * @return texture::s_ptr    Created texture (stage it)
+ */
+texture::s_ptr create_texture(device::ptr device,
+                              texture_data const& data);
+
+/**
+ * @brief Write decoded texture to a cache file
+ * @param filename    Name of cache file
+ * @param data        Decoded texture
+ * @return Write was successful or failed
+ */
+bool write_texture_data(string_ref filename,
+                        texture_data const& data);
+
+/**
+ * @brief Read decoded texture from a cache file
+ * @param filename         Name of cache file
+ * @return texture_data    Decoded texture (invalid: missing, stale or corrupt)
+ */
+texture_data read_texture_data(string_ref filename);
+
 /**
  * @brief Load texture from file
  * @param device             Vulkan device
  * @param tex_file           Texture file
  * @param type               Type of texture
+ * @param cache_path         Path of compressed texture cache (ends with /)
  * @return texture::s_ptr    Loaded texture
  */
 texture::s_ptr load_texture(device::ptr device,
                             texture_file tex_file,
-                            texture_type type = texture_type::tex_2d);
+                            texture_type type = texture_type::tex_2d,
+                            string_ref cache_path = {});
 
 /**
  * @brief Load texture from file with default format (sRGB)
@@ -37,6 +113,34 @@ inline texture::s_ptr load_texture(device::ptr device,
     return load_texture(device, {filename, format}, type);
 }
 
+/**
+ * @brief Load 2D texture from file for mip streaming
+ *
+ * Images get a full mip chain on the CPU. The first stream of the
+ * texture_streamer uploads the mip tail.
+ *
+ * @param device                      Vulkan device
+ * @param tex_file                    Texture file
+ * @param tail_extent                 Largest extent of mip tail levels
+ * @return streamed_texture::s_ptr    Streamed texture
+ */
+streamed_texture::s_ptr load_streamed_texture(device::ptr device,
+                                              texture_file const& tex_file,
+                                              ui32 tail_extent = 128);
+
+/**
+ * @brief Generate a full mip chain of a RGBA8 image with box filter
+ * @param data                  Texels of first level
+ * @param size                  Size of first level
+ * @param srgb                  Filter color in linear space
+ * @param thread_count          Number of threads (0: hardware concurrency)
+ * @return std::vector<ui8>     Texels of all levels (first level first)
+ */
+std::vector<ui8> generate_mips_rgba8(ui8 const* data,
+                                     uv2 size,
+                                     bool srgb = true,
+                                     ui32 thread_count = 0);
+
 /**
  * @brief Create a default texture with checkerboard pattern
  * @param device             Vulkan device
@@ -0,0 +1,615 @@
+/**
+ * @file         liblava/asset/parse_obj.cpp
+ * @brief        Parallel OBJ parser
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/parse_obj.hpp"
+#include "liblava/util/thread.hpp"
+#include <atomic>
+
+namespace lava {
+
+namespace {
+
+/// Missing index in face corner
+constexpr i32 const obj_none = std::numeric_limits<i32>::min();
+
+/**
+ * @brief Face corner (0-based indices)
+ */
+struct obj_corner {
+    /// Position index
+    i32 position = obj_none;
+
+    /// Texcoord index
+    i32 texcoord = obj_none;
+
+    /// Normal index
+    i32 normal = obj_none;
+
+    /// Relative to chunk base (bit 0: position, 1: texcoord, 2: normal)
+    ui8 relative = 0;
+};
+
+/**
+ * @brief Shape start in chunk
+ */
+struct obj_chunk_shape {
+    /// Name of object or group
+    string name;
+
+    /// First triangle in chunk
+    size_t first_triangle = 0;
+};
+
+/**
+ * @brief Parse result of chunk
+ */
+struct obj_chunk {
+    /// Chunk data
+    c_data source;
+
+    /// Positions (xyz)
+    std::vector<r32> positions;
+
+    /// Texcoords (uv)
+    std::vector<r32> texcoords;
+
+    /// Normals (xyz)
+    std::vector<r32> normals;
+
+    /// Face corners
+    std::vector<obj_corner> corners;
+
+    /// Number of corners per face
+    std::vector<ui32> face_sizes;
+
+    /// Shapes starting in chunk
+    std::vector<obj_chunk_shape> shapes;
+
+    /// Number of triangles
+    size_t triangle_count = 0;
+
+    /// Parse state
+    bool valid = true;
+};
+
+/**
+ * @brief Check for digit
+ * @param c    Character
+ * @return Character is digit or not
+ */
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Check for space
+ * @param c    Character
+ * @return Character is space or not
+ */
+inline bool is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Skip spaces
+ * @param p       Current position
+ * @param end     End of line
+ * @return char const*    Next non-space position
+ */
+inline char const* skip_space(char const* p,
+                              char const* end) {
+    while (p < end && is_space(*p))
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Parse integer
+ * @param p               Current position
+ * @param end             End of line
+ * @param value           Parsed value
+ * @return char const*    Position after value (nullptr: no value)
+ */
+char const* parse_int(char const* p,
+                      char const* end,
+                      i32& value) {
+    auto negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    if (p == end || !is_digit(*p))
+        return nullptr;
+
+    i64 result = 0;
+    while (p < end && is_digit(*p)) {
+        result = std::min(result * 10 + (*p - '0'), i64(std::numeric_limits<i32>::max()));
+        ++p;
+    }
+
+    value = static_cast<i32>(negative ? -result : result);
+    return p;
+}
+
+/**
+ * @brief Parse real number
+ * @param p               Current position
+ * @param end             End of line
+ * @param value           Parsed value
+ * @return char const*    Position after value (nullptr: no value)
+ */
+char const* parse_real(char const* p,
+                       char const* end,
+                       r32& value) {
+    static r64 const powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    auto negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    ui64 mantissa = 0;
+    i32 exponent = 0;
+    auto digits = 0;
+    auto found = false;
+
+    for (; p < end && is_digit(*p); ++p) {
+        found = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        for (++p; p < end && is_digit(*p); ++p) {
+            found = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+
+    if (!found)
+        return nullptr;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        i32 e = 0;
+        if (auto next = parse_int(p + 1, end, e)) {
+            exponent += e;
+            p = next;
+        }
+    }
+
+    auto result = r64(mantissa);
+    if (exponent > 0)
+        result *= exponent <= 22 ? powers[exponent] : std::pow(10.0, exponent);
+    else if (exponent < 0)
+        result /= exponent >= -22 ? powers[-exponent] : std::pow(10.0, -exponent);
+
+    value = static_cast<r32>(negative ? -result : result);
+    return p;
+}
+
+/**
+ * @brief Parse reals into list (missing values are zero)
+ * @param p         Current position
+ * @param end       End of line
+ * @param count     Number of values
+ * @param target    Target list
+ */
+void parse_reals(char const* p,
+                 char const* end,
+                 ui32 count,
+                 std::vector<r32>& target) {
+    for (auto i = 0u; i < count; ++i) {
+        auto value = 0.f;
+
+        p = skip_space(p, end);
+        if (auto next = parse_real(p, end, value))
+            p = next;
+
+        target.push_back(value);
+    }
+}
+
+/**
+ * @brief Resolve OBJ index (1-based or relative)
+ * @param value       OBJ index
+ * @param count       Number of elements parsed in chunk
+ * @param relative    Relative flags
+ * @param bit         Relative flag of element
+ * @return i32        0-based index (obj_none: invalid)
+ */
+i32 resolve_index(i32 value,
+                  size_t count,
+                  ui8& relative,
+                  ui8 bit) {
+    if (value > 0)
+        return value - 1;
+
+    if (value < 0) {
+        relative |= bit;
+        return static_cast<i32>(i64(count) + value);
+    }
+
+    return obj_none;
+}
+
+/**
+ * @brief Parse face statement
+ * @param p        Current position
+ * @param end      End of line
+ * @param chunk    Target chunk
+ */
+void parse_face(char const* p,
+                char const* end,
+                obj_chunk& chunk) {
+    auto const first = chunk.corners.size();
+
+    while (true) {
+        p = skip_space(p, end);
+        if (p == end)
+            break;
+
+        obj_corner corner;
+
+        i32 value = 0;
+        auto next = parse_int(p, end, value);
+        if (!next) {
+            chunk.valid = false;
+            break;
+        }
+
+        corner.position = resolve_index(value, chunk.positions.size() / 3,
+                                        corner.relative, 1);
+        p = next;
+
+        if (p < end && *p == '/') {
+            ++p;
+
+            if (p < end && *p != '/') {
+                if ((next = parse_int(p, end, value))) {
+                    corner.texcoord = resolve_index(value, chunk.texcoords.size() / 2,
+                                                    corner.relative, 2);
+                    p = next;
+                }
+            }
+
+            if (p < end && *p == '/') {
+                ++p;
+
+                if ((next = parse_int(p, end, value))) {
+                    corner.normal = resolve_index(value, chunk.normals.size() / 3,
+                                                  corner.relative, 4);
+                    p = next;
+                }
+            }
+        }
+
+        if (corner.position == obj_none) {
+            chunk.valid = false;
+            break;
+        }
+
+        chunk.corners.push_back(corner);
+
+        while (p < end && !is_space(*p))
+            ++p;
+    }
+
+    auto const size = chunk.corners.size() - first;
+    if (size < 3) {
+        chunk.corners.resize(first);
+        return;
+    }
+
+    chunk.face_sizes.push_back(to_ui32(size));
+    chunk.triangle_count += size - 2;
+}
+
+/**
+ * @brief Parse chunk of lines
+ * @param chunk    Target chunk
+ */
+void parse_chunk(obj_chunk& chunk) {
+    auto p = chunk.source.addr;
+    auto const end = chunk.source.addr + chunk.source.size;
+
+    while (p < end && chunk.valid) {
+        auto line_end = static_cast<char const*>(memchr(p, '\n', end - p));
+        if (!line_end)
+            line_end = end;
+
+        auto e = line_end;
+        if (e > p && *(e - 1) == '\r')
+            --e;
+
+        p = skip_space(p, e);
+
+        if (e - p >= 2 && is_space(p[1])) {
+            switch (p[0]) {
+            case 'v':
+                parse_reals(p + 2, e, 3, chunk.positions);
+                break;
+            case 'f':
+                parse_face(p + 2, e, chunk);
+                break;
+            case 'o':
+            case 'g': {
+                auto name_begin = skip_space(p + 2, e);
+                auto name_end = e;
+                while (name_end > name_begin && is_space(*(name_end - 1)))
+                    --name_end;
+
+                chunk.shapes.push_back({
+                    .name = string(name_begin, name_end),
+                    .first_triangle = chunk.triangle_count,
+                });
+                break;
+            }
+            default:
+                break;
+            }
+        } else if (e - p >= 3 && p[0] == 'v' && is_space(p[2])) {
+            if (p[1] == 't')
+                parse_reals(p + 3, e, 2, chunk.texcoords);
+            else if (p[1] == 'n')
+                parse_reals(p + 3, e, 3, chunk.normals);
+        }
+
+        p = line_end + 1;
+    }
+}
+
+/**
+ * @brief Split data into chunks at line boundaries
+ * @param source            OBJ file data
+ * @param count             Target number of chunks
+ * @param min_chunk_size    Minimal size of chunk
+ * @return std::vector<obj_chunk>    List of chunks
+ */
+std::vector<obj_chunk> split_chunks(c_data source,
+                                    size_t count,
+                                    size_t min_chunk_size) {
+    std::vector<obj_chunk> result;
+
+    auto const chunk_size = std::max(source.size / std::max(count, size_t(1)),
+                                     std::max(min_chunk_size, size_t(1)));
+
+    auto p = source.addr;
+    auto const end = source.addr + source.size;
+
+    while (p < end) {
+        auto chunk_end = p + std::min(chunk_size, size_t(end - p));
+
+        if (chunk_end < end) {
+            auto line_end = static_cast<char const*>(memchr(chunk_end, '\n',
+                                                            end - chunk_end));
+            chunk_end = line_end ? line_end + 1 : end;
+        }
+
+        auto& chunk = result.emplace_back();
+        chunk.source = {p, size_t(chunk_end - p)};
+
+        p = chunk_end;
+    }
+
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool parse_obj(c_data source,
+               mesh_data& target,
+               obj_shape::list* shapes,
+               ui32 thread_count,
+               size_t min_chunk_size) {
+    if (!source.addr || source.size == 0)
+        return false;
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // several chunks per thread for load balance
+    auto chunks = split_chunks(source, size_t(thread_count) * 4, min_chunk_size);
+
+    parallel_for(thread_count, chunks.size(), [&](size_t i) {
+        parse_chunk(chunks[i]);
+    });
+
+    struct chunk_base {
+        size_t position = 0;
+        size_t texcoord = 0;
+        size_t normal = 0;
+        size_t triangle = 0;
+    };
+
+    std::vector<chunk_base> bases(chunks.size() + 1);
+    for (auto i = 0u; i < chunks.size(); ++i) {
+        if (!chunks[i].valid) {
+            logger()->error("parse obj face");
+            return false;
+        }
+
+        bases[i + 1] = {
+            .position = bases[i].position + chunks[i].positions.size() / 3,
+            .texcoord = bases[i].texcoord + chunks[i].texcoords.size() / 2,
+            .normal = bases[i].normal + chunks[i].normals.size() / 3,
+            .triangle = bases[i].triangle + chunks[i].triangle_count,
+        };
+    }
+
+    auto const& total = bases.back();
+    if (total.triangle * 3 > std::numeric_limits<index>::max()) {
+        logger()->error("obj too large: {} triangles", total.triangle);
+        return false;
+    }
+
+    std::vector<r32> positions(total.position * 3);
+    std::vector<r32> texcoords(total.texcoord * 2);
+    std::vector<r32> normals(total.normal * 3);
+
+    parallel_for(thread_count, chunks.size(), [&](size_t i) {
+        auto& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(),
+                  positions.begin() + bases[i].position * 3);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(),
+                  texcoords.begin() + bases[i].texcoord * 2);
+        std::copy(chunk.normals.begin(), chunk.normals.end(),
+                  normals.begin() + bases[i].normal * 3);
+
+        chunk.positions = {};
+        chunk.texcoords = {};
+        chunk.normals = {};
+    });
+
+    auto const first_vertex = target.vertices.size();
+    auto const first_index = target.indices.size();
+
+    target.vertices.resize(first_vertex + total.triangle * 3);
+    target.indices.resize(first_index + total.triangle * 3);
+
+    std::atomic<bool> valid = true;
+
+    parallel_for(thread_count, chunks.size(), [&](size_t i) {
+        auto const& chunk = chunks[i];
+        auto const& base = bases[i];
+
+        auto const resolve = [&](obj_corner const& corner) {
+            auto const absolute = [&](i32 value, ui8 bit, size_t chunk_base) -> i64 {
+                if (value == obj_none)
+                    return -1;
+                return (corner.relative & bit) ? i64(chunk_base) + value : value;
+            };
+
+            return std::array<i64, 3>{
+                absolute(corner.position, 1, base.position),
+                absolute(corner.texcoord, 2, base.texcoord),
+                absolute(corner.normal, 4, base.normal),
+            };
+        };
+
+        auto out = first_vertex + base.triangle * 3;
+
+        auto const emit = [&](std::array<i64, 3> const& corner) {
+            auto const [p, t, n] = corner;
+
+            if (p < 0 || size_t(p) >= total.position
+                || (t >= 0 && size_t(t) >= total.texcoord)
+                || (n >= 0 && size_t(n) >= total.normal)) {
+                valid = false;
+                return;
+            }
+
+            auto& vertex = target.vertices[out];
+            vertex.position = v3(positions[p * 3],
+                                 positions[p * 3 + 1],
+                                 positions[p * 3 + 2]);
+
+            vertex.color = v4(1.f);
+
+            vertex.uv = t >= 0 ? v2(texcoords[t * 2], 1.f - texcoords[t * 2 + 1])
+                               : v2(0.f);
+
+            vertex.normal = n >= 0 ? v3(normals[n * 3],
+                                        normals[n * 3 + 1],
+                                        normals[n * 3 + 2])
+                                   : v3(0.f);
+
+            target.indices[first_index + out - first_vertex] = to_index(out - first_vertex);
+            ++out;
+        };
+
+        auto corner_offset = 0u;
+        for (auto const face_size : chunk.face_sizes) {
+            auto const face = chunk.corners.data() + corner_offset;
+            corner_offset += face_size;
+
+            auto const c0 = resolve(face[0]);
+
+            if (face_size == 4) {
+                // split quad at shorter diagonal
+                auto const c1 = resolve(face[1]);
+                auto const c2 = resolve(face[2]);
+                auto const c3 = resolve(face[3]);
+
+                auto const distance = [&](i64 a, i64 b) {
+                    if (a < 0 || b < 0 || size_t(a) >= total.position
+                        || size_t(b) >= total.position)
+                        return 0.f;
+
+                    auto const pa = v3(positions[a * 3], positions[a * 3 + 1], positions[a * 3 + 2]);
+                    auto const pb = v3(positions[b * 3], positions[b * 3 + 1], positions[b * 3 + 2]);
+                    return glm::dot(pa - pb, pa - pb);
+                };
+
+                if (distance(c0[0], c2[0]) < distance(c1[0], c3[0])) {
+                    emit(c0), emit(c1), emit(c2);
+                    emit(c0), emit(c2), emit(c3);
+                } else {
+                    emit(c0), emit(c1), emit(c3);
+                    emit(c1), emit(c2), emit(c3);
+                }
+                continue;
+            }
+
+            // fan
+            for (auto k = 1u; k + 1 < face_size; ++k) {
+                emit(c0);
+                emit(resolve(face[k]));
+                emit(resolve(face[k + 1]));
+            }
+        }
+    });
+
+    if (!valid) {
+        target.vertices.resize(first_vertex);
+        target.indices.resize(first_index);
+
+        logger()->error("obj index out of range");
+        return false;
+    }
+
+    if (shapes) {
+        obj_shape::list result;
+        result.push_back({.first_index = to_index(first_index)});
+
+        for (auto i = 0u; i < chunks.size(); ++i)
+            for (auto const& shape : chunks[i].shapes)
+                result.push_back({
+                    .name = shape.name,
+                    .first_index = to_index(first_index
+                                            + (bases[i].triangle + shape.first_triangle) * 3),
+                });
+
+        auto const end_index = to_index(target.indices.size());
+        for (auto i = 0u; i < result.size(); ++i) {
+            auto const next = i + 1 < result.size() ? result[i + 1].first_index : end_index;
+            result[i].index_count = next - result[i].first_index;
+        }
+
+        for (auto& shape : result)
+            if (shape.index_count > 0)
+                shapes->push_back(std::move(shape));
+    }
+
+    return true;
+}
+
+} // namespace lava
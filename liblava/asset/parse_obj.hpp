@@ -0,0 +1,55 @@
+/**
+ * @file         liblava/asset/parse_obj.hpp
+ * @brief        Parallel OBJ parser
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/// Minimal size of chunk parsed by one task
+constexpr size_t const obj_min_chunk_size = 1 << 20;
+
+/**
+ * @brief OBJ shape (range of object or group in mesh indices)
+ */
+struct obj_shape {
+    /// List of shapes
+    using list = std::vector<obj_shape>;
+
+    /// Name of object or group
+    string name;
+
+    /// First index
+    index first_index = 0;
+
+    /// Number of indices
+    ui32 index_count = 0;
+};
+
+/**
+ * @brief Parse OBJ data into mesh data
+ *
+ * Splits the data at line boundaries, parses the chunks in parallel
+ * and merges them with index remapping. Supports v, vt, vn and f
+ * statements (with relative indices) and o/g shapes. Faces are
+ * triangulated and unrolled to one vertex per index.
+ *
+ * @param source            OBJ file data
+ * @param target            Target mesh data
+ * @param shapes            Optional list of shapes
+ * @param thread_count      Number of threads (0: hardware concurrency)
+ * @param min_chunk_size    Minimal size of chunk
+ * @return Parse was successful or failed
+ */
+bool parse_obj(c_data source,
+               mesh_data& target,
+               obj_shape::list* shapes = nullptr,
+               ui32 thread_count = 0,
+               size_t min_chunk_size = obj_min_chunk_size);
+
+} // namespace lava
@@ -0,0 +1,42 @@
+/**
+ * @file         liblava/asset/test/compress_texture.cpp
+ * @brief        Texture block compression unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("select compression", "[texture]") {
+    std::vector<ui8> texels(16 * 4, 255);
+    REQUIRE(select_compression(texels.data(), 16, texture_compression::automatic)
+            == texture_compression::bc1);
+
+    texels[7] = 128;
+    REQUIRE(select_compression(texels.data(), 16, texture_compression::automatic)
+            == texture_compression::bc3);
+
+    REQUIRE(select_compression(texels.data(), 16, texture_compression::bc5)
+            == texture_compression::bc5);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("compress levels", "[texture]") {
+    uv2 const size = {10, 6};
+    auto const levels = make_mip_layers(size, 4).front().levels;
+
+    std::vector<ui8> texels;
+    for (auto const& level : levels)
+        texels.resize(texels.size() + level.size, 200);
+
+    // 3x2 + 2x1 + 1x1 + 1x1 blocks
+    auto const bc1 = compress_rgba8(texels.data(), levels, texture_compression::bc1, 2);
+    REQUIRE(bc1.size() == (6 + 2 + 1 + 1) * 8);
+
+    auto const bc3 = compress_rgba8(texels.data(), levels, texture_compression::bc3, 2);
+    REQUIRE(bc3.size() == (6 + 2 + 1 + 1) * 16);
+
+    // single threaded result is the same
+    REQUIRE(compress_rgba8(texels.data(), levels, texture_compression::bc3, 1) == bc3);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file         liblava/asset/test/decode_image.cpp
+ * @brief        Image decoder unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "liblava/test.hpp"
+
+namespace {
+
+/**
+ * @brief Read the sample images in res (run from build directory)
+ * @return std::vector<std::vector<ui8>>    List of encoded images
+ */
+std::vector<std::vector<ui8>> read_sample_images() {
+    std::vector<std::vector<ui8>> result;
+
+    std::error_code ec;
+    for (auto const& entry : std::filesystem::recursive_directory_iterator("res", ec)) {
+        if (!entry.is_regular_file()
+            || !extension(entry.path().string(), {"PNG", "JPG", "JPEG"}))
+            continue;
+
+        std::ifstream stream(entry.path(), std::ios::binary);
+        result.emplace_back(std::istreambuf_iterator<char>(stream),
+                            std::istreambuf_iterator<char>());
+    }
+
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("image decoders", "[image]") {
+    auto const images = read_sample_images();
+    if (images.empty())
+        return; // no sample images in res
+
+    for (auto const& encoded : images) {
+        c_data const data(encoded.data(), encoded.size());
+
+        auto const reference = decode_image(data, image_decoder::stb);
+        REQUIRE(reference);
+
+        for (auto decoder : {image_decoder::turbojpeg,
+                             image_decoder::spng}) {
+            if (!image_decoder_available(decoder)
+                || select_image_decoder(data) != decoder)
+                continue;
+
+            auto const decoded = decode_image(data, decoder);
+            REQUIRE(decoded);
+            REQUIRE(decoded->dimensions == reference->dimensions);
+
+            // jpeg idct differs between decoders
+            if (decoder == image_decoder::spng)
+                REQUIRE(memcmp(decoded->get_data(),
+                               reference->get_data(),
+                               reference->dimensions.x * reference->dimensions.y * 4)
+                        == 0);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("image decode throughput", "[.][image][benchmark]") {
+    auto const images = read_sample_images();
+    if (images.empty())
+        return; // no sample images in res
+
+    auto decoded_size = 0.0;
+    for (auto const& encoded : images) {
+        auto const decoded = decode_image({encoded.data(), encoded.size()});
+        REQUIRE(decoded);
+        decoded_size += decoded->dimensions.x * decoded->dimensions.y * 4;
+    }
+
+    for (auto decoder : {image_decoder::stb,
+                         image_decoder::turbojpeg,
+                         image_decoder::spng}) {
+        if (!image_decoder_available(decoder))
+            continue;
+
+        // throughput: decoded size / mean
+        BENCHMARK(fmt::format("decode {} - {} images, {:.1f} MB",
+                              get_image_decoder_name(decoder),
+                              images.size(),
+                              decoded_size / (1024.0 * 1024.0))) {
+            auto count = 0u;
+            for (auto const& encoded : images)
+                if (decode_image({encoded.data(), encoded.size()}, decoder))
+                    ++count;
+            return count;
+        };
+    }
+}
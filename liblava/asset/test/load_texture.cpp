@@ -0,0 +1,122 @@
+/**
+ * @file         liblava/asset/test/load_texture.cpp
+ * @brief        Texture loading unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mip layers", "[texture]") {
+    REQUIRE(calc_mip_levels({1, 1}) == 1);
+    REQUIRE(calc_mip_levels({256, 256}) == 9);
+    REQUIRE(calc_mip_levels({300, 20}) == 9);
+
+    auto const layers = make_mip_layers({5, 3}, 4, 2);
+    REQUIRE(layers.size() == 2);
+
+    auto const& levels = layers.front().levels;
+    REQUIRE(levels.size() == 3);
+    REQUIRE(levels[1].extent == uv2(2, 1));
+    REQUIRE(levels[2].extent == uv2(1, 1));
+    REQUIRE(levels[1].size == 2 * 1 * 4);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("generate mips", "[texture]") {
+    uv2 const size = {8, 4};
+
+    std::vector<ui8> texels(size.x * size.y * 4);
+    for (auto i = 0u; i < texels.size(); ++i)
+        texels[i] = static_cast<ui8>(i * 37);
+
+    auto const mips = generate_mips_rgba8(texels.data(), size, false, 2);
+
+    // 8x4, 4x2, 2x1, 1x1
+    REQUIRE(mips.size() == (32 + 8 + 2 + 1) * 4);
+    REQUIRE(std::equal(texels.begin(), texels.end(), mips.begin()));
+
+    auto const texel = [&](ui32 x, ui32 y, ui32 c) {
+        return texels[(y * size.x + x) * 4 + c];
+    };
+
+    for (auto c = 0u; c < 4; ++c)
+        REQUIRE(mips[32 * 4 + c] == (texel(0, 0, c) + texel(1, 0, c) + texel(0, 1, c) + texel(1, 1, c) + 2) / 4);
+
+    // flat color stays flat in linear space
+    std::vector<ui8> gray(size.x * size.y * 4, 128);
+    auto const gray_mips = generate_mips_rgba8(gray.data(), size);
+    REQUIRE(std::all_of(gray_mips.begin(), gray_mips.end(), [](ui8 v) { return v == 128; }));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("decode texture", "[texture]") {
+    // 4x2 RGBA png, texel (x, y) = {x * 60, y * 100, 200, 255}
+    std::array<ui8, 89> const png = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02,
+        0x08, 0x06, 0x00, 0x00, 0x00, 0x7f, 0xa8, 0x7d, 0x63, 0x00, 0x00, 0x00,
+        0x20, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0x60, 0x60, 0x38, 0xf1,
+        0xdf, 0x06, 0x88, 0x2b, 0x80, 0x78, 0x0b, 0x10, 0x33, 0x30, 0xa4, 0x00,
+        0x05, 0x80, 0xb8, 0x02, 0x88, 0xb7, 0x00, 0x31, 0x00, 0x1b, 0x8d, 0x12,
+        0x99, 0x6f, 0x81, 0xca, 0xea, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e,
+        0x44, 0xae, 0x42, 0x60, 0x82};
+
+    c_data const file_data(png.data(), png.size());
+
+    auto const single = decode_texture({"test.png",
+                                        VK_FORMAT_R8G8B8A8_SRGB,
+                                        texture_mips::none},
+                                       file_data);
+    REQUIRE(single.valid());
+    REQUIRE(single.size == uv2(4, 2));
+    REQUIRE(single.layers.empty());
+    REQUIRE(single.data.size() == 4 * 2 * 4);
+    REQUIRE(single.data[(1 * 4 + 2) * 4] == 120);
+    REQUIRE(single.data[(1 * 4 + 2) * 4 + 1] == 100);
+
+    auto const cpu = decode_texture({"test.png",
+                                     VK_FORMAT_R8G8B8A8_SRGB,
+                                     texture_mips::cpu},
+                                    file_data,
+                                    texture_type::tex_2d,
+                                    1);
+    REQUIRE(cpu.layers.front().levels.size() == 3);
+    REQUIRE(cpu.data.size() == (8 + 2 + 1) * 4);
+    REQUIRE_FALSE(cpu.blit_mips);
+
+    auto const gpu = decode_texture({"test.png"}, file_data);
+    REQUIRE(gpu.blit_mips);
+    REQUIRE(gpu.data.size() == 4 * 2 * 4);
+
+    // needs the device
+    texture_file compressed{"test.png"};
+    compressed.compression = texture_compression::automatic;
+    REQUIRE_FALSE(decode_texture(compressed, file_data).valid());
+    REQUIRE_FALSE(decode_texture({"test.ktx2"}, file_data).valid());
+
+    // cache file round trip
+    auto const filename = (std::filesystem::temp_directory_path()
+                           / "lava_test_texture.tex")
+                              .string();
+
+    REQUIRE(write_texture_data(filename, cpu));
+
+    auto const cached = read_texture_data(filename);
+    REQUIRE(cached.valid());
+    REQUIRE(cached.format == cpu.format);
+    REQUIRE(cached.size == cpu.size);
+    REQUIRE(cached.layers.size() == 1);
+    REQUIRE(cached.layers.front().levels.size() == 3);
+    REQUIRE(cached.layers.front().levels[1].extent == uv2(2, 1));
+    REQUIRE(cached.data == cpu.data);
+    REQUIRE_FALSE(cached.blit_mips);
+
+    // truncated
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 1);
+    REQUIRE_FALSE(read_texture_data(filename).valid());
+
+    std::filesystem::remove(filename);
+    REQUIRE_FALSE(read_texture_data(filename).valid());
+}
@@ -0,0 +1,100 @@
+/**
+ * @file         liblava/asset/test/parse_obj.cpp
+ * @brief        OBJ parser unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/// OBJ with shapes, relative indices, missing vt/vn and quads
+string make_obj(ui32 block_count) {
+    string result = "# parse obj test\n";
+
+    // faces before first shape
+    result += "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+    result += "vt 0 0\nvt 1 0\nvt 0 1\n";
+    result += "vn 0 0 1\n";
+    result += "f 1/1/1 2/2/1 3/3/1\n";
+
+    for (auto i = 0u; i < block_count; ++i) {
+        auto const x = fmt::format("{}", r32(i) * 0.5f);
+        auto const y = fmt::format("{}", r32(i % 7) * 0.25f);
+
+        result += fmt::format("o shape_{}\n", i);
+
+        // quad with shorter diagonal 0-2
+        result += fmt::format("v {} {} 0\n", x, y);
+        result += fmt::format("v {}.75 {} 0.5\n", i, y);
+        result += fmt::format("v {}.75 {} -1.25\n", i, i + 1);
+        result += fmt::format("v {} {} 2\n", x, i + 2);
+
+        // position only, relative
+        result += "f -4 -3 -2 -1\n";
+
+        // missing vt, absolute
+        result += fmt::format("vn 0 {} 1\n", y);
+        result += fmt::format("f {0}//{1} {2}//{1} {3}//{1}\n",
+                              4 + i * 4, 2 + i, 5 + i * 4, 6 + i * 4);
+
+        // missing vn, relative position and vt
+        result += fmt::format("vt {} 0.5\nvt 1 {}\n", y, y);
+        result += "f -4/-2 -3/-1 -2/-2 -1/-1\n";
+
+        // triangle with relative and absolute corners
+        result += fmt::format("f -1/-1/-1 -4/-2/1 -3/{}/-1\n", 1 + i % 3);
+    }
+
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("parse obj - compare with tinyobj", "[obj]") {
+    auto const obj = make_obj(200);
+    c_data const source(obj.data(), obj.size());
+
+    mesh_data expected;
+    obj_shape::list expected_shapes;
+    REQUIRE(load_obj_mesh_data(source, expected, &expected_shapes));
+    REQUIRE(!expected.indices.empty());
+
+    // small chunks: split mid-file, relative indices cross chunks
+    for (auto const thread_count : {1u, 4u}) {
+        mesh_data data;
+        obj_shape::list shapes;
+        REQUIRE(parse_obj(source, data, &shapes, thread_count, 256));
+
+        REQUIRE(data.indices == expected.indices);
+        REQUIRE(data.vertices.size() == expected.vertices.size());
+
+        for (auto i = 0u; i < data.vertices.size(); ++i) {
+            auto const& a = data.vertices[i];
+            auto const& b = expected.vertices[i];
+
+            REQUIRE(a.position == b.position);
+            REQUIRE(a.uv == b.uv);
+            REQUIRE(a.normal == b.normal);
+            REQUIRE(a.color == b.color);
+        }
+
+        REQUIRE(shapes.size() == expected_shapes.size());
+        for (auto i = 0u; i < shapes.size(); ++i) {
+            REQUIRE(shapes[i].name == expected_shapes[i].name);
+            REQUIRE(shapes[i].first_index == expected_shapes[i].first_index);
+            REQUIRE(shapes[i].index_count == expected_shapes[i].index_count);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("parse obj - invalid index", "[obj]") {
+    string const obj = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+
+    mesh_data data;
+    REQUIRE(!parse_obj(c_data(obj.data(), obj.size()), data));
+    REQUIRE(data.vertices.empty());
+}
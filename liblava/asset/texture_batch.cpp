@@ -0,0 +1,152 @@
+/**
+ * @file         liblava/asset/texture_batch.cpp
+ * @brief        Load batches of textures on a thread pool
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/asset/texture_batch.hpp"
+#include "liblava/file.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+index texture_batch::add(texture_file const& tex_file,
+                         texture_type type) {
+    m_items.push_back({tex_file, type});
+    return to_index(m_items.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+bool texture_batch::start(ui32 thread_count) {
+    if (m_pool || m_started_count == m_items.size())
+        return false;
+
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto const count = m_items.size() - m_started_count;
+
+    m_pool = std::make_unique<thread_pool>();
+    m_pool->setup(to_ui32(std::min(size_t(thread_count), count)));
+
+    for (auto i = m_started_count; i < m_items.size(); ++i) {
+        m_pool->enqueue([this,
+                         i,
+                         tex_file = m_items[i].file,
+                         type = m_items[i].type](id::ref) {
+            result res{to_index(i)};
+
+            if (!m_cancel) {
+                file_data const data(tex_file.path);
+                if (data.addr) {
+                    // one thread per file, the pool scales
+                    res.data = decode_texture(tex_file, data, type, 1);
+
+                    res.load = !res.data.valid()
+                               && (extension(tex_file.path, "KTX2")
+                                   || tex_file.compression != texture_compression::none);
+                }
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_results.push_back(std::move(res));
+                ++m_decoded_count;
+            }
+
+            m_condition.notify_all();
+        });
+    }
+
+    m_started_count = m_items.size();
+
+    logger()->trace("texture batch: {} files on {} threads",
+                    count, std::min(size_t(thread_count), count));
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+ui32 texture_batch::poll(device::ptr device,
+                         staging& staging,
+                         staging_priority priority,
+                         ui32 max_count,
+                         string_ref cache_path) {
+    std::deque<result> results;
+    auto finished = false;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto count = m_results.size();
+        if (max_count > 0)
+            count = std::min(count, size_t(max_count));
+
+        std::move(m_results.begin(),
+                  m_results.begin() + count,
+                  std::back_inserter(results));
+        m_results.erase(m_results.begin(), m_results.begin() + count);
+
+        finished = m_decoded_count == m_started_count;
+    }
+
+    // all tasks are done
+    if (finished && m_pool) {
+        m_pool->teardown();
+        m_pool = nullptr;
+    }
+
+    auto handed = 0u;
+
+    for (auto& res : results) {
+        auto& item = m_items.at(res.idx);
+
+        if (res.data.valid())
+            item.texture = create_texture(device, res.data);
+        else if (res.load)
+            item.texture = load_texture(device, item.file, item.type, cache_path);
+
+        if (item.texture) {
+            staging.add(item.texture, priority);
+            ++handed;
+        } else {
+            logger()->error("load texture: {}", item.file.path);
+        }
+
+        ++m_polled_count;
+    }
+
+    return handed;
+}
+
+//-----------------------------------------------------------------------------
+void texture_batch::wait() {
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [&]() {
+        return m_decoded_count == m_started_count;
+    });
+}
+
+//-----------------------------------------------------------------------------
+void texture_batch::cancel() {
+    if (m_pool) {
+        // running tasks skip decoding
+        m_cancel = true;
+
+        m_pool->teardown();
+        m_pool = nullptr;
+
+        m_cancel = false;
+    }
+
+    m_items.clear();
+    m_results.clear();
+
+    m_decoded_count = 0;
+    m_started_count = 0;
+    m_polled_count = 0;
+}
+
+} // namespace lava
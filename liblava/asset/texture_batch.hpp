@@ -0,0 +1,162 @@
+/**
+ * @file         liblava/asset/texture_batch.hpp
+ * @brief        Load batches of textures on a thread pool
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/asset/load_texture.hpp"
+#include "liblava/util/thread.hpp"
+#include <atomic>
+
+namespace lava {
+
+/**
+ * @brief Batch of textures loaded on a thread pool
+ *
+ * Workers read and decode the files. The main thread creates the
+ * textures from the decoded data and hands them to the staging (poll
+ * once per frame). KTX2 and block compressed files are loaded by poll.
+ */
+struct texture_batch : no_copy_no_move {
+    /**
+     * @brief Destroy the texture batch
+     */
+    ~texture_batch() {
+        cancel();
+    }
+
+    /**
+     * @brief Add texture file to batch
+     * @param tex_file    Texture file
+     * @param type        Type of texture
+     * @return index      Index of texture in batch
+     */
+    index add(texture_file const& tex_file,
+              texture_type type = texture_type::tex_2d);
+
+    /**
+     * @brief Start decoding on workers
+     * @param thread_count    Number of threads (0: hardware concurrency)
+     * @return Start was successful or failed (running or empty)
+     */
+    bool start(ui32 thread_count = 0);
+
+    /**
+     * @brief Create decoded textures and add them to staging (main thread)
+     * @param device        Vulkan device
+     * @param staging       Texture staging
+     * @param priority      Staging priority
+     * @param max_count     Maximum number of textures (0: all decoded)
+     * @param cache_path    Path of compressed texture cache (ends with /)
+     * @return ui32         Number of textures handed to staging
+     */
+    ui32 poll(device::ptr device,
+              staging& staging,
+              staging_priority priority = staging_priority::visible,
+              ui32 max_count = 0,
+              string_ref cache_path = {});
+
+    /**
+     * @brief Wait until all files are decoded
+     */
+    void wait();
+
+    /**
+     * @brief Cancel decoding and clear the batch
+     */
+    void cancel();
+
+    /**
+     * @brief Check if all textures are handed to staging
+     * @return Batch is done or not
+     */
+    bool done() const {
+        return m_polled_count == m_items.size();
+    }
+
+    /**
+     * @brief Get the number of textures in batch
+     * @return size_t    Number of textures
+     */
+    size_t get_count() const {
+        return m_items.size();
+    }
+
+    /**
+     * @brief Get the number of textures handed to staging
+     * @return size_t    Number of textures (failed included)
+     */
+    size_t get_polled_count() const {
+        return m_polled_count;
+    }
+
+    /**
+     * @brief Get a texture of batch
+     * @param idx                Index of texture
+     * @return texture::s_ptr    Texture (nullptr: not polled yet or failed)
+     */
+    texture::s_ptr get_texture(index idx) const {
+        return m_items.at(idx).texture;
+    }
+
+private:
+    /**
+     * @brief Texture in batch
+     */
+    struct item {
+        /// Texture file
+        texture_file file;
+
+        /// Type of texture
+        texture_type type = texture_type::tex_2d;
+
+        /// Created texture
+        texture::s_ptr texture;
+    };
+
+    /**
+     * @brief Result of worker
+     */
+    struct result {
+        /// Index of texture
+        index idx = 0;
+
+        /// Decoded texture
+        texture_data data;
+
+        /// Load on main thread (needs device)
+        bool load = false;
+    };
+
+    /// List of textures
+    std::vector<item> m_items;
+
+    /// Decoded textures waiting for poll
+    std::deque<result> m_results;
+
+    /// Result mutex
+    std::mutex m_mutex;
+
+    /// Signaled on result
+    std::condition_variable m_condition;
+
+    /// Thread pool of workers (while running)
+    std::unique_ptr<thread_pool> m_pool;
+
+    /// Cancel state
+    std::atomic<bool> m_cancel = false;
+
+    /// Number of files done by workers
+    size_t m_decoded_count = 0;
+
+    /// Number of started files
+    size_t m_started_count = 0;
+
+    /// Number of textures handed to staging
+    size_t m_polled_count = 0;
+};
+
+} // namespace lava
@@ -108,9 +108,31 @@ bool device::create(create_param::ref param) {
         queue_create_info_list[i].pQueuePriorities = priorities.at(i).data();
     }
 
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+        .pNext = const_cast<void*>(param.next),
+        .timelineSemaphore = VK_TRUE,
+    };
+
+    // enable on a feature struct in chain, both at once are invalid
+    auto chain_timeline_semaphore = param.timeline_semaphore;
+    if (param.timeline_semaphore) {
+        for (auto next = (VkBaseOutStructure*)param.next; next; next = next->pNext) {
+            if (next->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES) {
+                ((VkPhysicalDeviceVulkan12Features*)next)->timelineSemaphore = VK_TRUE;
+                chain_timeline_semaphore = false;
+            } else if (next->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES) {
+                ((VkPhysicalDeviceTimelineSemaphoreFeatures*)next)->timelineSemaphore = VK_TRUE;
+                chain_timeline_semaphore = false;
+            }
+        }
+    }
+
     VkDeviceCreateInfo create_info{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = param.next,
+        .pNext = chain_timeline_semaphore
+                     ? &timeline_semaphore_features
+                     : param.next,
         .queueCreateInfoCount = to_ui32(queue_create_info_list.size()),
         .pQueueCreateInfos = queue_create_info_list.data(),
         .enabledLayerCount = 0,
@@ -131,6 +153,7 @@ bool device::create(create_param::ref param) {
     }
 
     m_features = param.features;
+    m_timeline_semaphore = param.timeline_semaphore;
 
     load_table();
 
@@ -183,6 +206,10 @@ void device::destroy() {
     m_transfer_queue_list.clear();
     m_queue_list.clear();
 
+    // before allocator, ring memory is allocated with it
+    m_staging_ring = nullptr;
+    m_sampler_cache = nullptr;
+
     if (m_mem_allocator) {
         m_mem_allocator->destroy();
         m_mem_allocator = nullptr;
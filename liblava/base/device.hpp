@@ -59,6 +59,9 @@ struct device : device_table, entity {
         /// Create parameter next pointer (pNext)
         void const* next = nullptr;
 
+        /// Enable timeline semaphores (Vulkan 1.2: set on a 1.2 or timeline feature struct in next, else chained)
+        bool timeline_semaphore = false;
+
         /// List of queue famiy infos
         queue_family_info::list queue_family_infos;
 
@@ -316,6 +319,46 @@ struct device : device_table, entity {
      */
     bool surface_supported(VkSurfaceKHR surface) const;
 
+    /**
+     * @brief Check if timeline semaphores are enabled
+     * @return Timeline semaphores are enabled or not
+     */
+    bool timeline_semaphore_enabled() const {
+        return m_timeline_semaphore;
+    }
+
+    /**
+     * @brief Set the staging ring for this device
+     * @param value    Staging ring (see resource/staging_ring.hpp)
+     */
+    void set_staging_ring(std::shared_ptr<staging_ring> value) {
+        m_staging_ring = value;
+    }
+
+    /**
+     * @brief Get the staging ring of this device
+     * @return std::shared_ptr<staging_ring>    Staging ring (nullptr: not used yet)
+     */
+    std::shared_ptr<staging_ring> get_staging_ring() const {
+        return m_staging_ring;
+    }
+
+    /**
+     * @brief Set the sampler cache for this device
+     * @param value    Sampler cache (see resource/sampler_cache.hpp)
+     */
+    void set_sampler_cache(std::shared_ptr<sampler_cache> value) {
+        m_sampler_cache = value;
+    }
+
+    /**
+     * @brief Get the sampler cache of this device
+     * @return std::shared_ptr<sampler_cache>    Sampler cache (nullptr: not used yet)
+     */
+    std::shared_ptr<sampler_cache> get_sampler_cache() const {
+        return m_sampler_cache;
+    }
+
     /**
      * @brief Set the allocator for this device
      * @param value    Allocator
@@ -361,8 +404,17 @@ private:
     /// Device features
     VkPhysicalDeviceFeatures m_features{};
 
+    /// Timeline semaphores enabled
+    bool m_timeline_semaphore = false;
+
     /// Device allocator
     allocator::s_ptr m_mem_allocator;
+
+    /// Staging ring for uploads
+    std::shared_ptr<staging_ring> m_staging_ring;
+
+    /// Shared samplers
+    std::shared_ptr<sampler_cache> m_sampler_cache;
 };
 
 /**
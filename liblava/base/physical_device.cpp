@@ -80,9 +80,37 @@ device::create_param physical_device::create_default_device_param() const {
 #endif
     create_param.set_default_queues();
 
+    // block compressed textures if supported
+    create_param.features.textureCompressionBC = m_features.textureCompressionBC;
+    create_param.features.textureCompressionETC2 = m_features.textureCompressionETC2;
+    create_param.features.textureCompressionASTC_LDR = m_features.textureCompressionASTC_LDR;
+
+    // async uploads on transfer queue
+    create_param.timeline_semaphore = timeline_semaphore_supported();
+
     return create_param;
 }
 
+//-----------------------------------------------------------------------------
+bool physical_device::timeline_semaphore_supported() const {
+    if (m_properties.apiVersion < VK_API_VERSION_1_2
+        || instance::singleton().get_info().req_api_version < api_version::v1_2)
+        return false;
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+    };
+
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &timeline_semaphore_features,
+    };
+
+    vkGetPhysicalDeviceFeatures2(m_vk_physical_device, &features);
+
+    return timeline_semaphore_features.timelineSemaphore == VK_TRUE;
+}
+
 //-----------------------------------------------------------------------------
 name physical_device::get_device_name() const {
     return m_properties.deviceName;
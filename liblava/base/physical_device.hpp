@@ -71,6 +71,15 @@ struct physical_device : entity {
      */
     device::create_param create_default_device_param() const;
 
+    /**
+     * @brief Check if timeline semaphores are supported
+     *
+     * Core in Vulkan 1.2, the instance must request it.
+     *
+     * @return Timeline semaphores are supported or not
+     */
+    bool timeline_semaphore_supported() const;
+
     /**
      * @brief Get the properties
      * @return VkPhysicalDeviceProperties const&    Physical device properties
@@ -12,6 +12,7 @@
 #include "liblava/block/compute_pipeline.hpp"
 #include "liblava/block/def.hpp"
 #include "liblava/block/descriptor.hpp"
+#include "liblava/block/indirect_draw.hpp"
 #include "liblava/block/pipeline.hpp"
 #include "liblava/block/pipeline_layout.hpp"
 #include "liblava/block/render_pass.hpp"
@@ -0,0 +1,376 @@
+/**
+ * @file         liblava/block/indirect_draw.cpp
+ * @brief        Indirect draw builder
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/block/indirect_draw.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+/// Stride of draw commands
+constexpr ui32 const indirect_command_stride = sizeof(VkDrawIndexedIndirectCommand);
+
+//-----------------------------------------------------------------------------
+bool indirect_draw::create(device::ptr device,
+                           ui32 max_draws,
+                           c_data::ref cull_shader,
+                           VkPipelineCache pipeline_cache,
+                           ui32 frame_count) {
+    m_device = device;
+    m_max_draws = max_draws;
+    m_count = 0;
+
+    auto const command_size = size_t(max_draws) * indirect_command_stride;
+    auto const culled = cull_shader.addr != nullptr;
+
+    m_command_buffer = buffer::make();
+    if (culled) {
+        if (!m_command_buffer->create(device,
+                                      nullptr,
+                                      command_size,
+                                      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                                          | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+            logger()->error("create indirect draw command buffer");
+            return false;
+        }
+    } else {
+        if (!m_command_buffer->create_mapped(device,
+                                             nullptr,
+                                             command_size,
+                                             VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)) {
+            logger()->error("create indirect draw command buffer");
+            return false;
+        }
+
+        return true;
+    }
+
+    m_objects.assign(max_draws, {});
+    m_version = 0;
+    m_frame = 0;
+
+    m_object_buffers.resize(std::max(frame_count, 1u));
+    m_object_versions.assign(m_object_buffers.size(), 0);
+
+    for (auto& object_buffer : m_object_buffers) {
+        object_buffer = buffer::make();
+        if (!object_buffer->create_mapped(device,
+                                          nullptr,
+                                          size_t(max_draws) * sizeof(indirect_object),
+                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+            logger()->error("create indirect draw object buffer");
+            return false;
+        }
+    }
+
+    m_count_buffer = buffer::make();
+    if (!m_count_buffer->create(device,
+                                nullptr,
+                                sizeof(ui32),
+                                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                                    | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                    | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+        logger()->error("create indirect draw count buffer");
+        return false;
+    }
+
+    return create_pipeline(cull_shader, pipeline_cache);
+}
+
+//-----------------------------------------------------------------------------
+bool indirect_draw::create_pipeline(c_data::ref cull_shader,
+                                    VkPipelineCache pipeline_cache) {
+    m_descriptor = descriptor::make();
+    for (auto binding = 0u; binding < 3; ++binding)
+        m_descriptor->add_binding(binding,
+                                  VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                  VK_SHADER_STAGE_COMPUTE_BIT);
+
+    if (!m_descriptor->create(m_device))
+        return false;
+
+    auto const set_count = to_ui32(m_object_buffers.size());
+
+    m_descriptor_pool = descriptor::pool::make();
+    if (!m_descriptor_pool->create(m_device,
+                                   {
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * set_count},
+                                   },
+                                   set_count))
+        return false;
+
+    m_layout = pipeline_layout::make();
+    m_layout->add(m_descriptor);
+    m_layout->add({VK_SHADER_STAGE_COMPUTE_BIT,
+                   0,
+                   sizeof(indirect_cull_constants)});
+
+    if (!m_layout->create(m_device))
+        return false;
+
+    for (auto& object_buffer : m_object_buffers) {
+        auto const descriptor_set = m_descriptor->allocate(m_descriptor_pool->get());
+        if (!descriptor_set)
+            return false;
+
+        m_descriptor_sets.push_back(descriptor_set);
+
+        auto const write = [&](index binding, buffer::s_ptr const& target) {
+            return VkWriteDescriptorSet{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = descriptor_set,
+                .dstBinding = binding,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo = target->get_descriptor_info(),
+            };
+        };
+
+        m_device->vkUpdateDescriptorSets({write(0, object_buffer),
+                                          write(1, m_command_buffer),
+                                          write(2, m_count_buffer)});
+    }
+
+    m_pipeline = compute_pipeline::make(m_device, pipeline_cache);
+    if (!m_pipeline->set_shader_stage(cull_shader,
+                                      VK_SHADER_STAGE_COMPUTE_BIT)) {
+        m_pipeline = nullptr;
+        return false;
+    }
+
+    m_pipeline->set_layout(m_layout);
+
+    if (!m_pipeline->create()) {
+        logger()->error("create indirect draw culling pipeline");
+        m_pipeline = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw::destroy() {
+    if (m_pipeline) {
+        m_pipeline->destroy();
+        m_pipeline = nullptr;
+    }
+
+    for (auto& descriptor_set : m_descriptor_sets)
+        m_descriptor->deallocate(descriptor_set, m_descriptor_pool->get());
+
+    m_descriptor_sets.clear();
+
+    if (m_layout) {
+        m_layout->destroy();
+        m_layout = nullptr;
+    }
+
+    if (m_descriptor_pool) {
+        m_descriptor_pool->destroy();
+        m_descriptor_pool = nullptr;
+    }
+
+    if (m_descriptor) {
+        m_descriptor->destroy();
+        m_descriptor = nullptr;
+    }
+
+    m_command_buffer = nullptr;
+    m_object_buffers.clear();
+    m_object_versions.clear();
+    m_objects.clear();
+    m_count_buffer = nullptr;
+
+    m_draw_count = nullptr;
+    m_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+index indirect_draw::add(VkDrawIndexedIndirectCommand const& command,
+                         v3 center,
+                         r32 radius) {
+    if (m_count >= m_max_draws)
+        return no_index;
+
+    auto const draw = m_count++;
+    set(draw, command, center, radius);
+
+    return draw;
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw::set(index draw,
+                        VkDrawIndexedIndirectCommand const& command,
+                        v3 center,
+                        r32 radius) {
+    LAVA_ASSERT(draw < m_count);
+
+    if (!culling()) {
+        auto const offset = size_t(draw) * indirect_command_stride;
+
+        memcpy(data::as_ptr(m_command_buffer->get_mapped_data()) + offset,
+               &command, indirect_command_stride);
+        m_command_buffer->flush(offset, indirect_command_stride);
+        return;
+    }
+
+    // copied into the object buffer of a frame on cull
+    m_objects[draw] = {
+        .sphere = v4(center, radius),
+        .command = command,
+    };
+
+    ++m_version;
+}
+
+//-----------------------------------------------------------------------------
+bool indirect_draw::set_draw_count(bool value) {
+    m_draw_count = nullptr;
+
+    if (!value)
+        return true;
+
+    if (!culling()) {
+        logger()->warn("indirect draw count requires culling");
+        return false;
+    }
+
+    m_draw_count = m_device->call().vkCmdDrawIndexedIndirectCount;
+    if (!m_draw_count)
+        m_draw_count = m_device->call().vkCmdDrawIndexedIndirectCountKHR;
+
+    if (!m_draw_count) {
+        logger()->warn("indirect draw count not supported");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw::cull(VkCommandBuffer cmd_buf,
+                         index frame,
+                         mat4 const& view_projection) {
+    if (!culling() || m_count == 0)
+        return;
+
+    LAVA_ASSERT(frame < m_object_buffers.size());
+
+    // previous use of this frame has completed
+    m_frame = to_index(frame % m_object_buffers.size());
+
+    auto& object_buffer = m_object_buffers[m_frame];
+    if (m_object_versions[m_frame] != m_version) {
+        auto const size = size_t(m_count) * sizeof(indirect_object);
+
+        memcpy(object_buffer->get_mapped_data(), m_objects.data(), size);
+        object_buffer->flush(0, size);
+
+        m_object_versions[m_frame] = m_version;
+    }
+
+    auto const compact = draw_count();
+
+    // previous draws must be done reading the commands and count
+    VkMemoryBarrier const draw_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+        .dstAccessMask = compact ? VK_ACCESS_SHADER_WRITE_BIT
+                                       | VK_ACCESS_TRANSFER_WRITE_BIT
+                                 : VK_ACCESS_SHADER_WRITE_BIT,
+    };
+
+    vkCmdPipelineBarrier(cmd_buf,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                         compact ? VK_PIPELINE_STAGE_TRANSFER_BIT
+                                       | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                 : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &draw_barrier, 0, nullptr, 0, nullptr);
+
+    // count is only read by count draw
+    if (compact) {
+        vkCmdFillBuffer(cmd_buf, m_count_buffer->get(), 0, sizeof(ui32), 0);
+
+        VkMemoryBarrier const fill_barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        };
+
+        vkCmdPipelineBarrier(cmd_buf,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &fill_barrier, 0, nullptr, 0, nullptr);
+    }
+
+    m_pipeline->bind(cmd_buf);
+    m_layout->bind(cmd_buf,
+                   m_descriptor_sets[m_frame],
+                   0,
+                   {},
+                   VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    indirect_cull_constants const constants{
+        .planes = extract_frustum_planes(view_projection),
+        .object_count = m_count,
+        .compact = compact ? 1u : 0u,
+    };
+
+    vkCmdPushConstants(cmd_buf,
+                       m_layout->get(),
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0,
+                       sizeof(indirect_cull_constants),
+                       &constants);
+
+    vkCmdDispatch(cmd_buf,
+                  (m_count + indirect_cull_group_size - 1) / indirect_cull_group_size,
+                  1, 1);
+
+    VkMemoryBarrier const cull_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+    };
+
+    vkCmdPipelineBarrier(cmd_buf,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                         0, 1, &cull_barrier, 0, nullptr, 0, nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void indirect_draw::draw(VkCommandBuffer cmd_buf) const {
+    if (m_count == 0)
+        return;
+
+    if (m_draw_count) {
+        m_draw_count(cmd_buf,
+                     m_command_buffer->get(),
+                     0,
+                     m_count_buffer->get(),
+                     0,
+                     m_count,
+                     indirect_command_stride);
+        return;
+    }
+
+    // without multiDrawIndirect only single draws are allowed
+    auto max_batch = 1u;
+    if (m_device->get_features().multiDrawIndirect)
+        max_batch = std::max(m_device->get_properties().limits.maxDrawIndirectCount, 1u);
+
+    for (auto first = 0u; first < m_count; first += max_batch) {
+        vkCmdDrawIndexedIndirect(cmd_buf,
+                                 m_command_buffer->get(),
+                                 VkDeviceSize(first) * indirect_command_stride,
+                                 std::min(max_batch, m_count - first),
+                                 indirect_command_stride);
+    }
+}
+
+} // namespace lava
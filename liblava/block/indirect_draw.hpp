@@ -0,0 +1,271 @@
+/**
+ * @file         liblava/block/indirect_draw.hpp
+ * @brief        Indirect draw builder
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/block/compute_pipeline.hpp"
+#include "liblava/resource/buffer.hpp"
+#include "liblava/util/math.hpp"
+
+namespace lava {
+
+/**
+ * @brief Indirect draw object (std430 layout of culling shader)
+ */
+struct indirect_object {
+    /// Bounding sphere (xyz: world center, w: radius, negative: never culled)
+    v4 sphere = v4(0.f, 0.f, 0.f, -1.f);
+
+    /// Draw command
+    VkDrawIndexedIndirectCommand command = {};
+
+    /// Padding
+    ui32 padding[3] = {};
+};
+
+static_assert(sizeof(indirect_object) == 48);
+
+/**
+ * @brief Indirect draw culling push constants
+ */
+struct indirect_cull_constants {
+    /// Frustum planes
+    frustum_planes planes;
+
+    /// Number of objects
+    ui32 object_count = 0;
+
+    /// Compact visible commands (1) or zero culled instances (0)
+    ui32 compact = 0;
+};
+
+/// Workgroup size of culling shader
+constexpr ui32 const indirect_cull_group_size = 64;
+
+/**
+ * @brief Indirect draw builder
+ *
+ * Collects indexed draw commands in a device buffer and submits them
+ * with one indirect draw. With a culling shader, a compute pass tests
+ * the bounding spheres against the frustum and writes the visible
+ * commands, so the CPU cost per frame does not depend on the number
+ * of objects. See res/spawn/cull.comp for the shader interface.
+ *
+ * Culled objects are kept on the host and copied into one object
+ * buffer per frame in flight on cull, so they can change every frame.
+ * Without culling, the commands are written in place: only change
+ * them while no frame using them is in flight.
+ */
+struct indirect_draw : entity {
+    /// Shared pointer to indirect draw
+    using s_ptr = std::shared_ptr<indirect_draw>;
+
+    /**
+     * @brief Make a new indirect draw
+     * @return s_ptr    Shared pointer to indirect draw
+     */
+    static s_ptr make() {
+        return std::make_shared<indirect_draw>();
+    }
+
+    /**
+     * @brief Destroy the indirect draw
+     */
+    ~indirect_draw() {
+        destroy();
+    }
+
+    /**
+     * @brief Create the indirect draw
+     * @param device            Vulkan device
+     * @param max_draws         Maximal number of draws
+     * @param cull_shader       Culling compute shader (empty: no culling)
+     * @param pipeline_cache    Pipeline cache
+     * @param frame_count       Number of object buffers (render target frame count)
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 max_draws,
+                c_data::ref cull_shader = {},
+                VkPipelineCache pipeline_cache = 0,
+                ui32 frame_count = 2);
+
+    /**
+     * @brief Destroy the indirect draw
+     */
+    void destroy();
+
+    /**
+     * @brief Add draw command
+     * @param command    Draw command
+     * @param center     Bounding sphere center (world)
+     * @param radius     Bounding sphere radius (negative: never culled)
+     * @return index     Index of draw (no_index: full)
+     */
+    index add(VkDrawIndexedIndirectCommand const& command,
+              v3 center = v3(0.f),
+              r32 radius = -1.f);
+
+    /**
+     * @brief Update draw command
+     * @param draw       Index of draw
+     * @param command    Draw command
+     * @param center     Bounding sphere center (world)
+     * @param radius     Bounding sphere radius (negative: never culled)
+     */
+    void set(index draw,
+             VkDrawIndexedIndirectCommand const& command,
+             v3 center = v3(0.f),
+             r32 radius = -1.f);
+
+    /**
+     * @brief Remove all draw commands
+     */
+    void clear() {
+        m_count = 0;
+    }
+
+    /**
+     * @brief Use count draw for culled commands
+     *
+     * Requires the drawIndirectCount feature (Vulkan 1.2) or
+     * VK_KHR_draw_indirect_count to be enabled on the device.
+     *
+     * @param value    Enable state
+     * @return Count draw is available or not
+     */
+    bool set_draw_count(bool value = true);
+
+    /**
+     * @brief Cull draw commands on the device
+     *
+     * Must be recorded outside of a render pass, before draw(), once
+     * per frame: each frame uses its own object buffer.
+     *
+     * @param cmd_buf            Command buffer
+     * @param frame              Index of frame (less than frame count)
+     * @param view_projection    View projection matrix
+     */
+    void cull(VkCommandBuffer cmd_buf,
+              index frame,
+              mat4 const& view_projection);
+
+    /**
+     * @brief Draw all (visible) commands
+     * @param cmd_buf    Command buffer
+     */
+    void draw(VkCommandBuffer cmd_buf) const;
+
+    /**
+     * @brief Check if culling is available
+     * @return Culling pipeline is ready or not
+     */
+    bool culling() const {
+        return m_pipeline != nullptr;
+    }
+
+    /**
+     * @brief Check if count draw is used
+     * @return Count draw is used or not
+     */
+    bool draw_count() const {
+        return m_draw_count != nullptr;
+    }
+
+    /**
+     * @brief Get the number of draws
+     * @return ui32    Number of draws
+     */
+    ui32 get_count() const {
+        return m_count;
+    }
+
+    /**
+     * @brief Get the maximal number of draws
+     * @return ui32    Maximal number of draws
+     */
+    ui32 get_max_draws() const {
+        return m_max_draws;
+    }
+
+    /**
+     * @brief Get the command buffer
+     * @return buffer::s_ptr    Shared pointer to buffer
+     */
+    buffer::s_ptr get_command_buffer() const {
+        return m_command_buffer;
+    }
+
+    /**
+     * @brief Get the object buffer of the last cull
+     * @return buffer::s_ptr    Shared pointer to buffer (culling only)
+     */
+    buffer::s_ptr get_object_buffer() const {
+        return m_object_buffers.empty() ? nullptr
+                                        : m_object_buffers[m_frame];
+    }
+
+private:
+    /**
+     * @brief Create the culling pipeline
+     * @param cull_shader       Culling compute shader
+     * @param pipeline_cache    Pipeline cache
+     * @return Create was successful or failed
+     */
+    bool create_pipeline(c_data::ref cull_shader,
+                         VkPipelineCache pipeline_cache);
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Draw commands (culled on device or written on host)
+    buffer::s_ptr m_command_buffer;
+
+    /// Objects for culling (host)
+    std::vector<indirect_object> m_objects;
+
+    /// Version of objects (changed on set)
+    ui64 m_version = 0;
+
+    /// Objects for culling per frame
+    buffer::s_list m_object_buffers;
+
+    /// Version of objects in buffers
+    std::vector<ui64> m_object_versions;
+
+    /// Object buffer of last cull
+    index m_frame = 0;
+
+    /// Number of visible commands
+    buffer::s_ptr m_count_buffer;
+
+    /// Maximal number of draws
+    ui32 m_max_draws = 0;
+
+    /// Number of draws
+    ui32 m_count = 0;
+
+    /// Culling pipeline
+    compute_pipeline::s_ptr m_pipeline;
+
+    /// Culling pipeline layout
+    pipeline_layout::s_ptr m_layout;
+
+    /// Culling descriptor
+    descriptor::s_ptr m_descriptor;
+
+    /// Culling descriptor pool
+    descriptor::pool::s_ptr m_descriptor_pool;
+
+    /// Culling descriptor sets (per object buffer)
+    VkDescriptorSets m_descriptor_sets;
+
+    /// Count draw function (nullptr: not used)
+    PFN_vkCmdDrawIndexedIndirectCount m_draw_count = nullptr;
+};
+
+} // namespace lava
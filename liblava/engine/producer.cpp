@@ -60,6 +60,42 @@ bool producer::add_mesh(mesh::s_ptr product) {
     return true;
 }
 
+//-----------------------------------------------------------------------------
+gltf_model::s_ptr producer::get_model(string_ref name) {
+    for (auto& [id, meta] : models.get_all_meta()) {
+        if (meta == name)
+            return models.get(id);
+    }
+
+    auto product = load_gltf(app->device,
+                             app->props.get_filename(name));
+    if (!product)
+        return nullptr;
+
+    if (!add_model(product, name))
+        return nullptr;
+
+    return product;
+}
+
+//-----------------------------------------------------------------------------
+bool producer::add_model(gltf_model::s_ptr product,
+                         string_ref name) {
+    if (!product)
+        return false;
+
+    if (models.exists(product->get_id()))
+        return false;
+
+    models.add(product, name);
+
+    for (auto& submesh : product->submeshes)
+        if (submesh.mesh && !meshes.exists(submesh.mesh->get_id()))
+            meshes.add(submesh.mesh);
+
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 texture::s_ptr producer::create_texture(uv2 size) {
     auto product = create_default_texture(app->device,
@@ -77,8 +113,30 @@ texture::s_ptr producer::get_texture(string_ref name) {
             return textures.get(id);
     }
 
-    auto product = load_texture(app->device,
-                                app->props.get_filename(name));
+    string cache_path;
+    if (texture_compress != texture_compression::none
+        && app->fs.create_folder(string(_cache_path_) + _texture_path_))
+        cache_path = app->fs.get_pref_dir() + _cache_path_ + _texture_path_;
+
+    texture_file const tex_file{
+        .path = app->props.get_filename(name),
+        .format = VK_FORMAT_R8G8B8A8_SRGB,
+        .compression = texture_compress,
+    };
+
+    texture::s_ptr product;
+
+    // block compressed and container files are cached or upload ready
+    if (texture_cache
+        && texture_compress == texture_compression::none
+        && !extension(tex_file.path, {"DDS", "KTX", "KMG", "KTX2"}))
+        product = get_cached_texture(name, tex_file);
+
+    if (!product)
+        product = load_texture(app->device,
+                               tex_file,
+                               texture_type::tex_2d,
+                               cache_path);
     if (!product)
         return nullptr;
 
@@ -88,6 +146,55 @@ texture::s_ptr producer::get_texture(string_ref name) {
     return product;
 }
 
+//-----------------------------------------------------------------------------
+texture::s_ptr producer::get_cached_texture(string_ref name,
+                                            texture_file tex_file) {
+    if (!app->fs.create_folder(string(_cache_path_) + _texture_path_))
+        return nullptr;
+
+    // upload ready: all levels
+    if (tex_file.mips == texture_mips::gpu)
+        tex_file.mips = texture_mips::cpu;
+
+    auto const filename = fmt::format("{}{}{}{}_{}_{}.tex",
+                                      app->fs.get_pref_dir(),
+                                      _cache_path_,
+                                      _texture_path_,
+                                      hash256(name),
+                                      to_ui32(tex_file.format),
+                                      to_ui32(tex_file.mips));
+
+    if (valid_texture(name)) {
+        auto const data = read_texture_data(filename);
+        if (data.valid() && data.format == tex_file.format) {
+            logger()->info("texture cache: {} - {} bytes",
+                           name, data.data.size());
+
+            return lava::create_texture(app->device, data);
+        }
+    }
+
+    logger()->info("texture cache invalid: {}", name);
+
+    u_data file_data;
+    if (!load_file_data(tex_file.path, file_data))
+        return nullptr;
+
+    auto const data = decode_texture(tex_file, file_data);
+    if (!data.valid())
+        return nullptr;
+
+    if (write_texture_data(filename, data)) {
+        string_map file_hash_map;
+        file_hash_map.emplace(tex_file.path, hash256({file_data.addr, file_data.size}));
+        update_hash(name, file_hash_map, _texture_path_);
+    } else {
+        logger()->warn("texture not cached: {}", filename);
+    }
+
+    return lava::create_texture(app->device, data);
+}
+
 //-----------------------------------------------------------------------------
 bool producer::add_texture(texture::s_ptr product) {
     if (!product)
@@ -102,6 +209,52 @@ bool producer::add_texture(texture::s_ptr product) {
     return true;
 }
 
+//-----------------------------------------------------------------------------
+index producer::get_atlas_texture(string_ref name) {
+    if (m_atlas_regions.count(name))
+        return m_atlas_regions.at(name);
+
+    texture_file const tex_file{
+        .path = app->props.get_filename(name),
+        .format = VK_FORMAT_R8G8B8A8_SRGB,
+        .mips = texture_mips::none,
+    };
+
+    // same decoding as get_texture, single level
+    u_data file_data;
+    if (!load_file_data(tex_file.path, file_data))
+        return no_index;
+
+    auto const data = decode_texture(tex_file, file_data);
+    if (!data.valid() || data.format != VK_FORMAT_R8G8B8A8_SRGB) {
+        logger()->error("atlas texture: {}", name);
+        return no_index;
+    }
+
+    auto const region = atlas.add(data.size,
+                                  {data.data.data(), data.data.size()});
+    m_atlas_regions.emplace(name, region);
+
+    return region;
+}
+
+//-----------------------------------------------------------------------------
+bool producer::build_atlas(uv2 layer_size,
+                           ui32 padding) {
+    // texture may be in use
+    if (atlas.get_texture())
+        app->device->wait_for_idle();
+
+    if (!atlas.create(app->device,
+                      layer_size,
+                      VK_FORMAT_R8G8B8A8_SRGB,
+                      padding))
+        return false;
+
+    app->staging.add(atlas.get_texture());
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 c_data producer::get_shader(string_ref name,
                             bool reload) {
@@ -370,9 +523,14 @@ void producer::destroy() {
     for (auto& [id, mesh] : meshes.get_all())
         mesh->destroy();
 
+    for (auto& [id, model] : models.get_all())
+        model->destroy();
+
     for (auto& [id, texture] : textures.get_all())
         texture->destroy();
 
+    atlas.destroy();
+
     for (auto& [prop, shader] : m_shaders)
         shader.deallocate();
 }
@@ -382,17 +540,22 @@ void producer::clear() {
     destroy();
 
     meshes.clear();
+    models.clear();
     textures.clear();
     m_shaders.clear();
+
+    atlas.clear();
+    m_atlas_regions.clear();
 }
 
 //-----------------------------------------------------------------------------
 void producer::update_hash(string_ref name,
-                           string_map_ref file_hash_map) const {
-    if (!app->fs.create_folder(string(_cache_path_) + _shader_path_))
+                           string_map_ref file_hash_map,
+                           string_ref path) const {
+    if (!app->fs.create_folder(string(_cache_path_) + path))
         return;
 
-    auto filename = app->fs.get_pref_dir() + _cache_path_ + _shader_path_ + _hash_json_;
+    auto filename = app->fs.get_pref_dir() + _cache_path_ + path + _hash_json_;
     json_file hash_file(filename);
 
     json_file::callback callback;
@@ -408,10 +571,11 @@ void producer::update_hash(string_ref name,
 }
 
 //-----------------------------------------------------------------------------
-bool producer::valid_shader(string_ref name) const {
+bool producer::valid_hash(string_ref name,
+                          string_ref path) const {
     auto valid = true;
 
-    auto filename = app->fs.get_pref_dir() + _cache_path_ + _shader_path_ + _hash_json_;
+    auto filename = app->fs.get_pref_dir() + _cache_path_ + path + _hash_json_;
     json_file hash_file(filename);
 
     json_file::callback callback;
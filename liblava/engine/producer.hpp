@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "liblava/asset/load_gltf.hpp"
 #include "liblava/fwd.hpp"
 #include "liblava/resource.hpp"
 
@@ -18,6 +19,9 @@ constexpr name _shader_path_ = "shader/";
 /// temp folder
 constexpr name _temp_path_ = "temp/";
 
+/// texture folder
+constexpr name _texture_path_ = "texture/";
+
 /// hash file
 constexpr name _hash_json_ = "hash.json";
 
@@ -52,6 +56,22 @@ struct producer {
      */
     bool add_mesh(mesh::s_ptr mesh);
 
+    /**
+     * @brief Get glTF model by prop name
+     * @param name                  Name of prop
+     * @return gltf_model::s_ptr    Model
+     */
+    gltf_model::s_ptr get_model(string_ref name);
+
+    /**
+     * @brief Add glTF model and its meshes to products
+     * @param product    Model
+     * @param name       Name of prop
+     * @return Added to products or already exists
+     */
+    bool add_model(gltf_model::s_ptr product,
+                   string_ref name = {});
+
     /**
      * @brief Create a texture product
      * @param size               Size of texture
@@ -73,6 +93,29 @@ struct producer {
      */
     bool add_texture(texture::s_ptr product);
 
+    /**
+     * @brief Get atlas region of a small texture by prop name
+     *
+     * Decodes the texture into the atlas, build_atlas packs and stages
+     * all regions in one texture array.
+     *
+     * @param name       Name of prop
+     * @return index     Index of atlas region (no_index: failed)
+     */
+    index get_atlas_texture(string_ref name);
+
+    /**
+     * @brief Pack the atlas and add it to staging
+     *
+     * Building again waits for the device (replaces the texture).
+     *
+     * @param layer_size    Size of atlas layers
+     * @param padding       Texels around each region
+     * @return Build was successful or failed
+     */
+    bool build_atlas(uv2 layer_size = default_atlas_layer_size,
+                     ui32 padding = 2);
+
     /**
      * @brief Generate shader by prop name
      * @param name       Name of shader
@@ -115,9 +158,15 @@ struct producer {
     /// Mesh products
     id_registry<mesh, string> meshes;
 
+    /// Model products
+    id_registry<gltf_model, string> models;
+
     /// Texture products
     id_registry<texture, string> textures;
 
+    /// Atlas of small textures
+    texture_atlas atlas;
+
     /**
      * @brief Shader optimization level
      */
@@ -144,21 +193,61 @@ struct producer {
     /// Shader debug information
     bool shader_debug = false;
 
+    /// Texture block compression (cached)
+    texture_compression texture_compress = texture_compression::none;
+
+    /// Cache decoded textures with mips
+    bool texture_cache = true;
+
 private:
     /**
      * @brief Update file hash
      * @param name             Target file
      * @param file_hash_map    Map of used files with hash
+     * @param path             Cache folder
      */
     void update_hash(string_ref name,
-                     string_map_ref file_hash_map) const;
+                     string_map_ref file_hash_map,
+                     string_ref path = _shader_path_) const;
+
+    /**
+     * @brief Check if file(s) of a cache entry changed
+     * @param name    Target file
+     * @param path    Cache folder
+     * @return Cache entry is valid or has changed
+     */
+    bool valid_hash(string_ref name,
+                    string_ref path) const;
 
     /**
      * @brief Check if shader file(s) changed
      * @param name      Name of shader
      * @return Shader is valid or has changed
      */
-    bool valid_shader(string_ref name) const;
+    bool valid_shader(string_ref name) const {
+        return valid_hash(name, _shader_path_);
+    }
+
+    /**
+     * @brief Check if texture file changed
+     * @param name    Name of texture
+     * @return Texture is valid or has changed
+     */
+    bool valid_texture(string_ref name) const {
+        return valid_hash(name, _texture_path_);
+    }
+
+    /**
+     * @brief Get texture from decoded texture cache
+     * @param name               Name of prop
+     * @param tex_file           Texture file
+     * @return texture::s_ptr    Texture (nullptr: not decodable)
+     */
+    texture::s_ptr get_cached_texture(string_ref name,
+                                      texture_file tex_file);
+
+    /// Atlas regions by prop name
+    std::map<string, index> m_atlas_regions;
 
     /// Map of shader products
     using shader_map = std::map<string, data>;
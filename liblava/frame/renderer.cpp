@@ -174,8 +174,29 @@ bool renderer::end_frame(VkCommandBuffers const& cmd_buffers) {
 
     LAVA_ASSERT(user_frame_wait_semaphores.size() == user_frame_wait_stages.size());
 
+    // values of binary semaphores are ignored
+    std::vector<ui64> wait_values;
+    if (!m_timeline_wait_semaphores.empty()) {
+        wait_values.resize(wait_semaphores.size(), 0);
+
+        append(wait_semaphores, m_timeline_wait_semaphores);
+        append(wait_values, m_timeline_wait_values);
+        append(wait_stages, m_timeline_wait_stages);
+
+        m_timeline_wait_semaphores.clear();
+        m_timeline_wait_values.clear();
+        m_timeline_wait_stages.clear();
+    }
+
+    VkTimelineSemaphoreSubmitInfo const timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = to_ui32(wait_values.size()),
+        .pWaitSemaphoreValues = wait_values.data(),
+    };
+
     VkSubmitInfo const submit_info{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = wait_values.empty() ? nullptr : &timeline_info,
         .waitSemaphoreCount = to_ui32(wait_semaphores.size()),
         .pWaitSemaphores = wait_semaphores.data(),
         .pWaitDstStageMask = wait_stages.data(),
@@ -84,6 +84,20 @@ struct renderer : entity {
     /// The frame additionally signals these semaphores (Usefully for additional CommandBuffers)
     VkSemaphores user_frame_signal_semaphores;
 
+    /**
+     * @brief Wait for a timeline semaphore value in the next frame only
+     * @param semaphore    Timeline semaphore
+     * @param value        Value to wait for
+     * @param stage        Pipeline wait stage
+     */
+    void add_frame_timeline_wait(VkSemaphore semaphore,
+                                 ui64 value,
+                                 VkPipelineStageFlags stage) {
+        m_timeline_wait_semaphores.push_back(semaphore);
+        m_timeline_wait_values.push_back(value);
+        m_timeline_wait_stages.push_back(stage);
+    }
+
     /// Destroy function
     using destroy_func = std::function<void()>;
 
@@ -123,6 +137,15 @@ private:
 
     /// List of render complete semaphores
     VkSemaphores m_render_complete_semaphores = {};
+
+    /// Timeline semaphores the next frame waits for
+    VkSemaphores m_timeline_wait_semaphores;
+
+    /// To timeline semaphores corresponding values
+    std::vector<ui64> m_timeline_wait_values;
+
+    /// To timeline semaphores corresponding pipeline wait stages
+    VkPipelineStageFlagsList m_timeline_wait_stages;
 };
 
 } // namespace lava
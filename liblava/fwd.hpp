@@ -38,6 +38,8 @@ struct attachment;
 struct command;
 struct block;
 struct descriptor;
+struct indirect_draw;
+struct indirect_object;
 struct pipeline_layout;
 struct pipeline;
 struct compute_pipeline;
@@ -100,13 +102,34 @@ struct window;
 
 // liblava/resource.hpp
 struct buffer;
+struct buffer_upload;
+struct bounding_box;
+struct bounding_sphere;
+struct culling_boxes;
+struct mesh_bounds;
+struct geometry_pool;
+struct range_allocator;
 struct image_data;
 struct image;
 struct vertex;
+struct mesh_lod;
+struct mesh_range;
 struct mesh_meta;
+struct meshlet;
+struct meshlet_data;
+struct quantize_transform;
+struct quantized_vertex;
+struct quantized_color_vertex;
+struct sampler_cache;
 struct texture_file;
 struct texture;
+struct texture_atlas;
+struct skyline_packer;
 struct staging;
+struct staging_allocation;
+struct staging_ring;
+struct streamed_texture;
+struct texture_streamer;
 
 // liblava/util.hpp
 struct hex_point;
@@ -7,8 +7,18 @@
 
 #pragma once
 
+#include "liblava/resource/bounds.hpp"
 #include "liblava/resource/buffer.hpp"
 #include "liblava/resource/format.hpp"
+#include "liblava/resource/geometry_pool.hpp"
 #include "liblava/resource/image.hpp"
+#include "liblava/resource/instance_buffer.hpp"
 #include "liblava/resource/mesh.hpp"
+#include "liblava/resource/mesh_lod.hpp"
+#include "liblava/resource/meshlet.hpp"
+#include "liblava/resource/quantized_mesh.hpp"
+#include "liblava/resource/sampler_cache.hpp"
+#include "liblava/resource/staging_ring.hpp"
 #include "liblava/resource/texture.hpp"
+#include "liblava/resource/texture_atlas.hpp"
+#include "liblava/resource/texture_stream.hpp"
@@ -0,0 +1,190 @@
+/**
+ * @file         liblava/resource/bounds.cpp
+ * @brief        Bounding volumes and frustum culling
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/bounds.hpp"
+#include <bit>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define LAVA_CULL_SSE 1
+    #include <xmmintrin.h>
+#endif
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+bounding_box bounding_box::transform(mat4 const& matrix) const {
+    if (!valid())
+        return {};
+
+    // Arvo: transformed extent is the absolute matrix times extent
+    auto const c = v3(matrix * v4(center(), 1.f));
+    auto const e = extent();
+
+    v3 const transformed_extent{
+        glm::abs(matrix[0][0]) * e.x + glm::abs(matrix[1][0]) * e.y + glm::abs(matrix[2][0]) * e.z,
+        glm::abs(matrix[0][1]) * e.x + glm::abs(matrix[1][1]) * e.y + glm::abs(matrix[2][1]) * e.z,
+        glm::abs(matrix[0][2]) * e.x + glm::abs(matrix[1][2]) * e.y + glm::abs(matrix[2][2]) * e.z,
+    };
+
+    return {c - transformed_extent, c + transformed_extent};
+}
+
+//-----------------------------------------------------------------------------
+bounding_sphere bounding_sphere::transform(mat4 const& matrix) const {
+    if (radius < 0.f)
+        return {};
+
+    auto const scale = std::max({glm::length(v3(matrix[0])),
+                                 glm::length(v3(matrix[1])),
+                                 glm::length(v3(matrix[2]))});
+
+    return {v3(matrix * v4(center, 1.f)), radius * scale};
+}
+
+//-----------------------------------------------------------------------------
+mesh_bounds calc_bounds(v3 const* positions,
+                        size_t count,
+                        size_t stride) {
+    mesh_bounds result;
+    if (count == 0)
+        return result;
+
+    auto const position = [&](size_t i) -> v3 const& {
+        return *reinterpret_cast<v3 const*>(
+            reinterpret_cast<char const*>(positions) + i * stride);
+    };
+
+    for (auto i = 0u; i < count; ++i)
+        result.box.add(position(i));
+
+    // tighter than half diagonal: farthest vertex from box center
+    auto const center = result.box.center();
+    auto radius_squared = 0.f;
+    for (auto i = 0u; i < count; ++i) {
+        auto const offset = position(i) - center;
+        radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+    }
+
+    result.sphere = {center, std::sqrt(radius_squared)};
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+index culling_boxes::add(v3 const& center,
+                         v3 const& extent) {
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    center_z.push_back(center.z);
+
+    extent_x.push_back(extent.x);
+    extent_y.push_back(extent.y);
+    extent_z.push_back(extent.z);
+
+    return to_index(center_x.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+void culling_boxes::set(index box,
+                        v3 const& center,
+                        v3 const& extent) {
+    center_x[box] = center.x;
+    center_y[box] = center.y;
+    center_z[box] = center.z;
+
+    extent_x[box] = extent.x;
+    extent_y[box] = extent.y;
+    extent_z[box] = extent.z;
+}
+
+//-----------------------------------------------------------------------------
+void culling_boxes::reserve(size_t count) {
+    for (auto list : {&center_x, &center_y, &center_z,
+                      &extent_x, &extent_y, &extent_z})
+        list->reserve(count);
+}
+
+//-----------------------------------------------------------------------------
+void culling_boxes::clear() {
+    for (auto list : {&center_x, &center_y, &center_z,
+                      &extent_x, &extent_y, &extent_z})
+        list->clear();
+}
+
+//-----------------------------------------------------------------------------
+void cull_frustum(frustum_planes const& planes,
+                  culling_boxes const& boxes,
+                  index_list& visible) {
+    auto const count = boxes.size();
+
+    visible.clear();
+    visible.reserve(count);
+
+    auto i = 0u;
+
+#if LAVA_CULL_SSE
+    // 4 boxes per iteration, planes broadcast
+    __m128 plane_normal[6][4];
+    __m128 plane_abs[6][3];
+    for (auto p = 0u; p < planes.size(); ++p) {
+        auto const& plane = planes[p];
+
+        plane_normal[p][0] = _mm_set1_ps(plane.x);
+        plane_normal[p][1] = _mm_set1_ps(plane.y);
+        plane_normal[p][2] = _mm_set1_ps(plane.z);
+        plane_normal[p][3] = _mm_set1_ps(plane.w);
+
+        plane_abs[p][0] = _mm_set1_ps(std::abs(plane.x));
+        plane_abs[p][1] = _mm_set1_ps(std::abs(plane.y));
+        plane_abs[p][2] = _mm_set1_ps(std::abs(plane.z));
+    }
+
+    auto const zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        auto const cx = _mm_loadu_ps(&boxes.center_x[i]);
+        auto const cy = _mm_loadu_ps(&boxes.center_y[i]);
+        auto const cz = _mm_loadu_ps(&boxes.center_z[i]);
+        auto const ex = _mm_loadu_ps(&boxes.extent_x[i]);
+        auto const ey = _mm_loadu_ps(&boxes.extent_y[i]);
+        auto const ez = _mm_loadu_ps(&boxes.extent_z[i]);
+
+        auto outside = _mm_setzero_ps();
+
+        for (auto p = 0u; p < planes.size(); ++p) {
+            auto const& n = plane_normal[p];
+            auto const& a = plane_abs[p];
+
+            auto distance = _mm_add_ps(_mm_mul_ps(n[0], cx), _mm_mul_ps(n[1], cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(n[2], cz));
+            distance = _mm_add_ps(distance, n[3]);
+
+            auto radius = _mm_mul_ps(a[0], ex);
+            radius = _mm_add_ps(radius, _mm_mul_ps(a[1], ey));
+            radius = _mm_add_ps(radius, _mm_mul_ps(a[2], ez));
+
+            outside = _mm_or_ps(outside,
+                                _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        auto mask = ui32(~_mm_movemask_ps(outside) & 0xf);
+        while (mask) {
+            visible.push_back(i + std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (box_in_frustum(planes,
+                           {boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]},
+                           {boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]}))
+            visible.push_back(i);
+    }
+}
+
+} // namespace lava
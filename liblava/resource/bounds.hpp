@@ -0,0 +1,235 @@
+/**
+ * @file         liblava/resource/bounds.hpp
+ * @brief        Bounding volumes and frustum culling
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/core/types.hpp"
+#include "liblava/util/math.hpp"
+
+namespace lava {
+
+/**
+ * @brief Axis-aligned bounding box
+ */
+struct bounding_box {
+    /// Minimum corner
+    v3 min = v3(std::numeric_limits<r32>::max());
+
+    /// Maximum corner
+    v3 max = v3(std::numeric_limits<r32>::lowest());
+
+    /**
+     * @brief Check if box contains any point
+     * @return Box is valid or empty
+     */
+    bool valid() const {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    /**
+     * @brief Expand box by point
+     * @param point    Point to include
+     */
+    void add(v3 const& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    /**
+     * @brief Get the center
+     * @return v3    Center of box
+     */
+    v3 center() const {
+        return (min + max) * 0.5f;
+    }
+
+    /**
+     * @brief Get the extent
+     * @return v3    Half size of box
+     */
+    v3 extent() const {
+        return (max - min) * 0.5f;
+    }
+
+    /**
+     * @brief Transform box (result encloses the transformed box)
+     * @param matrix           Transform matrix
+     * @return bounding_box    Transformed box
+     */
+    bounding_box transform(mat4 const& matrix) const;
+};
+
+/**
+ * @brief Bounding sphere
+ */
+struct bounding_sphere {
+    /// Center
+    v3 center = v3(0.f);
+
+    /// Radius (negative: empty)
+    r32 radius = -1.f;
+
+    /**
+     * @brief Transform sphere (radius scales with largest axis)
+     * @param matrix              Transform matrix
+     * @return bounding_sphere    Transformed sphere
+     */
+    bounding_sphere transform(mat4 const& matrix) const;
+};
+
+/**
+ * @brief Bounds of a mesh
+ */
+struct mesh_bounds {
+    /// Bounding box
+    bounding_box box;
+
+    /// Bounding sphere (centered in box)
+    bounding_sphere sphere;
+};
+
+/**
+ * @brief Calculate bounds of positions
+ * @param positions      Vertex positions
+ * @param count          Number of positions
+ * @param stride         Stride between positions in bytes
+ * @return mesh_bounds   Box and sphere
+ */
+mesh_bounds calc_bounds(v3 const* positions,
+                        size_t count,
+                        size_t stride = sizeof(v3));
+
+/**
+ * @brief Calculate bounds of vertices
+ * @tparam T              Vertex struct
+ * @param vertices        List of vertices
+ * @return mesh_bounds    Box and sphere (empty for non-float positions)
+ */
+template <typename T>
+mesh_bounds calc_bounds(std::vector<T> const& vertices) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(T::position)>, v3>) {
+        if (vertices.empty())
+            return {};
+
+        return calc_bounds(&vertices.front().position, vertices.size(), sizeof(T));
+    } else {
+        return {};
+    }
+}
+
+/**
+ * @brief Check if box intersects frustum
+ * @param planes    Frustum planes
+ * @param center    Box center
+ * @param extent    Box half size
+ * @return Box is inside or intersecting
+ */
+inline bool box_in_frustum(frustum_planes const& planes,
+                           v3 const& center,
+                           v3 const& extent) {
+    for (auto const& plane : planes) {
+        auto const distance = glm::dot(v3(plane), center) + plane.w;
+        auto const radius = glm::dot(glm::abs(v3(plane)), extent);
+
+        if (distance + radius < 0.f)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Boxes in structure of arrays layout for culling
+ */
+struct culling_boxes {
+    /// Box centers
+    std::vector<r32> center_x, center_y, center_z;
+
+    /// Box half sizes
+    std::vector<r32> extent_x, extent_y, extent_z;
+
+    /**
+     * @brief Add box
+     * @param center    Box center
+     * @param extent    Box half size
+     * @return index    Index of box
+     */
+    index add(v3 const& center,
+              v3 const& extent);
+
+    /**
+     * @brief Add bounding box
+     * @param box       Bounding box
+     * @return index    Index of box
+     */
+    index add(bounding_box const& box) {
+        return add(box.center(), box.extent());
+    }
+
+    /**
+     * @brief Add bounding sphere (as enclosing cube)
+     * @param sphere    Bounding sphere
+     * @return index    Index of box
+     */
+    index add(bounding_sphere const& sphere) {
+        return add(sphere.center, v3(sphere.radius));
+    }
+
+    /**
+     * @brief Update box
+     * @param box       Index of box
+     * @param center    Box center
+     * @param extent    Box half size
+     */
+    void set(index box,
+             v3 const& center,
+             v3 const& extent);
+
+    /**
+     * @brief Reserve memory for boxes
+     * @param count    Number of boxes
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Remove all boxes
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of boxes
+     * @return size_t    Number of boxes
+     */
+    size_t size() const {
+        return center_x.size();
+    }
+};
+
+/**
+ * @brief Cull boxes against frustum (SSE when available)
+ * @param planes     Frustum planes
+ * @param boxes      Boxes to test
+ * @param visible    Indices of visible boxes (cleared first)
+ */
+void cull_frustum(frustum_planes const& planes,
+                  culling_boxes const& boxes,
+                  index_list& visible);
+
+/**
+ * @brief Cull boxes against frustum of view projection
+ * @param view_projection    View projection matrix (e.g. camera::calc_view_projection)
+ * @param boxes              Boxes to test
+ * @return index_list        Indices of visible boxes
+ */
+inline index_list cull_frustum(mat4 const& view_projection,
+                               culling_boxes const& boxes) {
+    index_list result;
+    cull_frustum(extract_frustum_planes(view_projection), boxes, result);
+    return result;
+}
+
+} // namespace lava
@@ -205,6 +205,13 @@ void format_block_dim(VkFormat format,
 #undef astc_fmt
 }
 
+//-----------------------------------------------------------------------------
+bool format_block_compressed(VkFormat format) {
+    ui32 width, height;
+    format_block_dim(format, width, height);
+    return width > 1 || height > 1;
+}
+
 //-----------------------------------------------------------------------------
 void format_align_dim(VkFormat format,
                       ui32& width,
@@ -742,6 +749,21 @@ bool support_blit(VkPhysicalDevice pyhsical_device,
     return (format_props.linearTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
 }
 
+//-----------------------------------------------------------------------------
+bool support_mip_blit(VkPhysicalDevice pyhsical_device,
+                      VkFormat format) {
+    VkFormatProperties format_props;
+    vkGetPhysicalDeviceFormatProperties(pyhsical_device,
+                                        format,
+                                        &format_props);
+
+    VkFormatFeatureFlags const features = VK_FORMAT_FEATURE_BLIT_SRC_BIT
+                                          | VK_FORMAT_FEATURE_BLIT_DST_BIT
+                                          | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    return (format_props.optimalTilingFeatures & features) == features;
+}
+
 //-----------------------------------------------------------------------------
 bool support_vertex_buffer_format(VkPhysicalDevice pyhsical_device,
                                   VkFormat format) {
@@ -67,6 +67,13 @@ void format_block_dim(VkFormat format,
                       ui32& width,
                       ui32& height);
 
+/**
+ * @brief Check if format is block compressed
+ * @param format    Format to check
+ * @return Format is block compressed or not
+ */
+bool format_block_compressed(VkFormat format);
+
 /**
  * @brief Get align dimension of format
  * @param format    Target format
@@ -238,6 +245,15 @@ VkSurfaceFormatKHR find_surface_format(VkPhysicalDevice device,
 bool support_blit(VkPhysicalDevice device,
                   VkFormat format);
 
+/**
+ * @brief Check if format supports linear blitting of mip levels
+ * @param device    Vulkan physical device
+ * @param format    Format to check
+ * @return Mip blitting is supported or not
+ */
+bool support_mip_blit(VkPhysicalDevice device,
+                      VkFormat format);
+
 /**
  * @brief Check if vertex buffer format is supported
  * @param device    Vulkan physical device
@@ -0,0 +1,335 @@
+/**
+ * @file         liblava/resource/geometry_pool.cpp
+ * @brief        Shared vertex and index buffers for many meshes
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/geometry_pool.hpp"
+#include <numeric>
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+void range_allocator::reset(ui32 capacity) {
+    m_free.clear();
+    m_capacity = capacity;
+    m_free_count = capacity;
+
+    if (capacity > 0)
+        m_free.emplace(0, capacity);
+}
+
+//-----------------------------------------------------------------------------
+ui32 range_allocator::allocate(ui32 count) {
+    if (count == 0 || count > m_free_count)
+        return no_index;
+
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        auto const [offset, size] = *it;
+        if (size < count)
+            continue;
+
+        m_free.erase(it);
+        if (size > count)
+            m_free.emplace(offset + count, size - count);
+
+        m_free_count -= count;
+        return offset;
+    }
+
+    return no_index;
+}
+
+//-----------------------------------------------------------------------------
+void range_allocator::free(ui32 offset,
+                           ui32 count) {
+    if (count == 0)
+        return;
+
+    m_free_count += count;
+
+    auto next = m_free.lower_bound(offset);
+
+    if (next != m_free.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            count += prev->second;
+            m_free.erase(prev);
+        }
+    }
+
+    if (next != m_free.end() && offset + count == next->first) {
+        count += next->second;
+        m_free.erase(next);
+    }
+
+    m_free.emplace(offset, count);
+}
+
+//-----------------------------------------------------------------------------
+range_move::list range_allocator::defragment(range::list& ranges) {
+    std::vector<index> order(ranges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](index a, index b) {
+        return ranges[a].offset < ranges[b].offset;
+    });
+
+    range_move::list result;
+
+    ui32 cursor = 0;
+    for (auto const i : order) {
+        auto& item = ranges[i];
+        if (item.offset != cursor) {
+            result.push_back({item.offset, cursor, item.count});
+            item.offset = cursor;
+        }
+
+        cursor += item.count;
+    }
+
+    reset(m_capacity);
+    if (cursor > 0)
+        allocate(cursor);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+ui32 range_allocator::get_largest_free() const {
+    ui32 result = 0;
+    for (auto const& [offset, size] : m_free)
+        result = std::max(result, size);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool geometry_pool::create(device::ptr device,
+                           ui32 vertex_stride,
+                           ui32 vertex_capacity,
+                           ui32 index_capacity,
+                           VkIndexType index_type,
+                           VmaMemoryUsage memory_usage) {
+    m_vertex_stride = vertex_stride;
+    m_index_type = index_type;
+
+    m_vertex_buffer = buffer::make();
+    if (!m_vertex_buffer->create_mapped(device,
+                                       nullptr,
+                                       size_t(vertex_stride) * vertex_capacity,
+                                       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                       memory_usage)) {
+        logger()->error("create geometry pool vertex buffer");
+        return false;
+    }
+
+    m_index_buffer = buffer::make();
+    if (!m_index_buffer->create_mapped(device,
+                                      nullptr,
+                                      index_type_size(index_type) * index_capacity,
+                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                      memory_usage)) {
+        logger()->error("create geometry pool index buffer");
+        return false;
+    }
+
+    m_vertex_allocator.reset(vertex_capacity);
+    m_index_allocator.reset(index_capacity);
+    m_ranges.clear();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void geometry_pool::destroy() {
+    m_vertex_buffer = nullptr;
+    m_index_buffer = nullptr;
+
+    m_vertex_allocator.reset(0);
+    m_index_allocator.reset(0);
+    m_ranges.clear();
+}
+
+//-----------------------------------------------------------------------------
+id geometry_pool::add(void const* vertices,
+                      ui32 vertex_count,
+                      index_list const& indices) {
+    if (!m_vertex_buffer || vertex_count == 0)
+        return undef_id;
+
+    // indices are relative to first vertex, pack_indices truncates
+    auto max_vertex_count = std::numeric_limits<ui32>::max();
+    if (m_index_type == VK_INDEX_TYPE_UINT8_EXT)
+        max_vertex_count = 0xff;
+    else if (m_index_type == VK_INDEX_TYPE_UINT16)
+        max_vertex_count = 0xffff;
+
+    if (vertex_count > max_vertex_count) {
+        logger()->error("geometry pool: {} vertices exceed {} bit indices",
+                        vertex_count, index_type_size(m_index_type) * 8);
+        return undef_id;
+    }
+
+    for (auto const idx : indices) {
+        if (idx >= vertex_count) {
+            logger()->error("geometry pool: index {} out of {} vertices", idx, vertex_count);
+            return undef_id;
+        }
+    }
+
+    auto index_count = to_ui32(indices.size());
+    if (index_count == 0)
+        index_count = vertex_count;
+
+    auto const first_vertex = m_vertex_allocator.allocate(vertex_count);
+    if (first_vertex == no_index)
+        return undef_id;
+
+    auto const first_index = m_index_allocator.allocate(index_count);
+    if (first_index == no_index) {
+        m_vertex_allocator.free(first_vertex, vertex_count);
+        return undef_id;
+    }
+
+    auto const vertex_offset = size_t(first_vertex) * m_vertex_stride;
+    auto const vertex_size = size_t(vertex_count) * m_vertex_stride;
+
+    memcpy(data::as_ptr(m_vertex_buffer->get_mapped_data()) + vertex_offset,
+           vertices, vertex_size);
+    m_vertex_buffer->flush(vertex_offset, vertex_size);
+
+    index_list sequential;
+    if (indices.empty()) {
+        sequential.resize(vertex_count);
+        for (auto i = 0u; i < vertex_count; ++i)
+            sequential[i] = i;
+    }
+
+    auto const index_data = pack_indices(indices.empty() ? sequential : indices,
+                                         m_index_type);
+    auto const index_offset = first_index * index_type_size(m_index_type);
+
+    memcpy(data::as_ptr(m_index_buffer->get_mapped_data()) + index_offset,
+           index_data.data(), index_data.size());
+    m_index_buffer->flush(index_offset, index_data.size());
+
+    auto const geometry = ids::instance().next();
+    m_ranges.emplace(geometry, geometry_range{
+                                   .first_vertex = first_vertex,
+                                   .vertex_count = vertex_count,
+                                   .first_index = first_index,
+                                   .index_count = index_count,
+                               });
+
+    return geometry;
+}
+
+//-----------------------------------------------------------------------------
+void geometry_pool::remove(id::ref geometry) {
+    if (!m_ranges.count(geometry))
+        return;
+
+    auto const& range = m_ranges.at(geometry);
+    m_vertex_allocator.free(range.first_vertex, range.vertex_count);
+    m_index_allocator.free(range.first_index, range.index_count);
+
+    m_ranges.erase(geometry);
+}
+
+//-----------------------------------------------------------------------------
+ui32 geometry_pool::defragment() {
+    if (!m_vertex_buffer)
+        return 0;
+
+    auto const move = [&](buffer::s_ptr& target,
+                          size_t element_size,
+                          auto first_member,
+                          auto count_member,
+                          range_allocator& allocator) {
+        range_allocator::range::list ranges;
+        ranges.reserve(m_ranges.size());
+        for (auto& [geometry, range] : m_ranges)
+            ranges.push_back({range.*first_member, range.*count_member});
+
+        auto const moves = allocator.defragment(ranges);
+
+        auto const base = data::as_ptr(target->get_mapped_data());
+        for (auto const& item : moves)
+            memmove(base + size_t(item.target) * element_size,
+                    base + size_t(item.source) * element_size,
+                    size_t(item.count) * element_size);
+
+        auto i = 0u;
+        for (auto& [geometry, range] : m_ranges)
+            range.*first_member = ranges[i++].offset;
+
+        target->flush();
+        return to_ui32(moves.size());
+    };
+
+    auto const moved_vertices = move(m_vertex_buffer,
+                                     m_vertex_stride,
+                                     &geometry_range::first_vertex,
+                                     &geometry_range::vertex_count,
+                                     m_vertex_allocator);
+
+    auto const moved_indices = move(m_index_buffer,
+                                    index_type_size(m_index_type),
+                                    &geometry_range::first_index,
+                                    &geometry_range::index_count,
+                                    m_index_allocator);
+
+    return std::max(moved_vertices, moved_indices);
+}
+
+//-----------------------------------------------------------------------------
+void geometry_pool::bind(VkCommandBuffer cmd_buf) const {
+    if (!m_vertex_buffer || !m_vertex_buffer->valid())
+        return;
+
+    VkDeviceSize const buffer_offset = 0;
+    auto const buffer = m_vertex_buffer->get();
+
+    vkCmdBindVertexBuffers(cmd_buf, 0,
+                           1, &buffer,
+                           &buffer_offset);
+
+    vkCmdBindIndexBuffer(cmd_buf,
+                         m_index_buffer->get(),
+                         0,
+                         m_index_type);
+}
+
+//-----------------------------------------------------------------------------
+void geometry_pool::draw(VkCommandBuffer cmd_buf,
+                         id::ref geometry,
+                         ui32 instance_count,
+                         ui32 first_instance) const {
+    auto const& range = m_ranges.at(geometry);
+
+    vkCmdDrawIndexed(cmd_buf,
+                     range.index_count,
+                     instance_count,
+                     range.first_index,
+                     i32(range.first_vertex),
+                     first_instance);
+}
+
+//-----------------------------------------------------------------------------
+VkDrawIndexedIndirectCommand geometry_pool::get_draw_command(id::ref geometry,
+                                                             ui32 instance_count,
+                                                             ui32 first_instance) const {
+    auto const& range = m_ranges.at(geometry);
+
+    return {
+        .indexCount = range.index_count,
+        .instanceCount = instance_count,
+        .firstIndex = range.first_index,
+        .vertexOffset = i32(range.first_vertex),
+        .firstInstance = first_instance,
+    };
+}
+
+} // namespace lava
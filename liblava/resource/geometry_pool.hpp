@@ -0,0 +1,344 @@
+/**
+ * @file         liblava/resource/geometry_pool.hpp
+ * @brief        Shared vertex and index buffers for many meshes
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief Move of a range on defragment
+ */
+struct range_move {
+    /// List of range moves
+    using list = std::vector<range_move>;
+
+    /// Offset before move
+    ui32 source = 0;
+
+    /// Offset after move
+    ui32 target = 0;
+
+    /// Number of elements
+    ui32 count = 0;
+};
+
+/**
+ * @brief Free-list allocator for element ranges
+ */
+struct range_allocator {
+    /**
+     * @brief Allocated range
+     */
+    struct range {
+        /// List of ranges
+        using list = std::vector<range>;
+
+        /// Offset of range
+        ui32 offset = 0;
+
+        /// Number of elements
+        ui32 count = 0;
+    };
+
+    /**
+     * @brief Reset the allocator
+     * @param capacity    Number of elements
+     */
+    void reset(ui32 capacity);
+
+    /**
+     * @brief Allocate a range (first fit)
+     * @param count    Number of elements
+     * @return ui32    Offset of range (no_index: out of space)
+     */
+    ui32 allocate(ui32 count);
+
+    /**
+     * @brief Free a range (merges with free neighbors)
+     * @param offset    Offset of range
+     * @param count     Number of elements
+     */
+    void free(ui32 offset,
+              ui32 count);
+
+    /**
+     * @brief Compact all allocated ranges to the front
+     *
+     * Ranges move in order of their offset to lower offsets, moving
+     * the data in list order with memmove is safe.
+     *
+     * @param ranges              All allocated ranges (offsets updated)
+     * @return range_move::list   Moves of ranges
+     */
+    range_move::list defragment(range::list& ranges);
+
+    /**
+     * @brief Get the capacity
+     * @return ui32    Number of elements
+     */
+    ui32 get_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Get the free elements
+     * @return ui32    Number of free elements
+     */
+    ui32 get_free() const {
+        return m_free_count;
+    }
+
+    /**
+     * @brief Get the largest free range
+     * @return ui32    Number of elements
+     */
+    ui32 get_largest_free() const;
+
+    /**
+     * @brief Get the number of free ranges
+     * @return size_t    Number of free ranges
+     */
+    size_t get_free_range_count() const {
+        return m_free.size();
+    }
+
+private:
+    /// Free ranges (offset, count)
+    std::map<ui32, ui32> m_free;
+
+    /// Capacity
+    ui32 m_capacity = 0;
+
+    /// Number of free elements
+    ui32 m_free_count = 0;
+};
+
+/**
+ * @brief Range of a mesh in geometry pool
+ */
+struct geometry_range {
+    /// Base vertex (vertex offset of draw)
+    ui32 first_vertex = 0;
+
+    /// Number of vertices
+    ui32 vertex_count = 0;
+
+    /// First index
+    ui32 first_index = 0;
+
+    /// Number of indices
+    ui32 index_count = 0;
+};
+
+/**
+ * @brief Shared vertex and index buffers for many meshes
+ *
+ * Indices are stored relative to the base vertex. Buffers stay mapped,
+ * so uploads and defragmentation are host copies.
+ */
+struct geometry_pool : entity {
+    /// Shared pointer to geometry pool
+    using s_ptr = std::shared_ptr<geometry_pool>;
+
+    /**
+     * @brief Make a new geometry pool
+     * @return s_ptr    Shared pointer to geometry pool
+     */
+    static s_ptr make() {
+        return std::make_shared<geometry_pool>();
+    }
+
+    /**
+     * @brief Destroy the geometry pool
+     */
+    ~geometry_pool() {
+        destroy();
+    }
+
+    /**
+     * @brief Create the geometry pool
+     * @param device             Vulkan device
+     * @param vertex_stride      Size of vertex
+     * @param vertex_capacity    Maximal number of vertices
+     * @param index_capacity     Maximal number of indices
+     * @param index_type         Index type (16 bit: meshes up to 65535 vertices)
+     * @param memory_usage       Memory usage (host visible)
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 vertex_stride,
+                ui32 vertex_capacity,
+                ui32 index_capacity,
+                VkIndexType index_type = VK_INDEX_TYPE_UINT32,
+                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+    /**
+     * @brief Destroy the geometry pool
+     */
+    void destroy();
+
+    /**
+     * @brief Add geometry to pool
+     * @param vertices        Vertex data
+     * @param vertex_count    Number of vertices
+     * @param indices         List of indices (empty: sequential)
+     * @return id             Geometry id (undef_id: out of space or invalid indices)
+     */
+    id add(void const* vertices,
+           ui32 vertex_count,
+           index_list const& indices);
+
+    /**
+     * @brief Add mesh data to pool
+     * @tparam T        Vertex struct
+     * @param data      Mesh data
+     * @return id       Geometry id (undef_id: out of space)
+     */
+    template <typename T>
+    id add(mesh_template_data<T> const& data) {
+        LAVA_ASSERT(sizeof(T) == m_vertex_stride);
+        return add(data.vertices.data(), to_ui32(data.vertices.size()), data.indices);
+    }
+
+    /**
+     * @brief Remove geometry from pool (ranges are reused)
+     * @param geometry    Geometry id
+     */
+    void remove(id::ref geometry);
+
+    /**
+     * @brief Check if geometry exists in pool
+     * @param geometry    Geometry id
+     * @return Geometry exists or not
+     */
+    bool exists(id::ref geometry) const {
+        return m_ranges.count(geometry);
+    }
+
+    /**
+     * @brief Get the range of geometry
+     * @param geometry           Geometry id
+     * @return geometry_range    Range in pool (changes on defragment)
+     */
+    geometry_range const& get_range(id::ref geometry) const {
+        return m_ranges.at(geometry);
+    }
+
+    /**
+     * @brief Compact all geometry to the front of the buffers
+     *
+     * Moves data on the host and changes the ranges: call only while
+     * the device is idle (device::wait_for_idle), recorded draws and
+     * draw commands of the pool are invalid afterwards.
+     *
+     * @return ui32    Number of moved geometries
+     */
+    ui32 defragment();
+
+    /**
+     * @brief Bind vertex (binding 0) and index buffer
+     * @param cmd_buf    Command buffer
+     */
+    void bind(VkCommandBuffer cmd_buf) const;
+
+    /**
+     * @brief Draw geometry (pool must be bound)
+     * @param cmd_buf           Command buffer
+     * @param geometry          Geometry id
+     * @param instance_count    Number of instances
+     * @param first_instance    First instance
+     */
+    void draw(VkCommandBuffer cmd_buf,
+              id::ref geometry,
+              ui32 instance_count = 1,
+              ui32 first_instance = 0) const;
+
+    /**
+     * @brief Get the indirect draw command of geometry
+     * @param geometry                          Geometry id
+     * @param instance_count                    Number of instances
+     * @param first_instance                    First instance
+     * @return VkDrawIndexedIndirectCommand    Draw command
+     */
+    VkDrawIndexedIndirectCommand get_draw_command(id::ref geometry,
+                                                  ui32 instance_count = 1,
+                                                  ui32 first_instance = 0) const;
+
+    /**
+     * @brief Get the vertex buffer
+     * @return buffer::s_ptr    Shared pointer to buffer
+     */
+    buffer::s_ptr get_vertex_buffer() const {
+        return m_vertex_buffer;
+    }
+
+    /**
+     * @brief Get the index buffer
+     * @return buffer::s_ptr    Shared pointer to buffer
+     */
+    buffer::s_ptr get_index_buffer() const {
+        return m_index_buffer;
+    }
+
+    /**
+     * @brief Get the index type
+     * @return VkIndexType    Index type
+     */
+    VkIndexType get_index_type() const {
+        return m_index_type;
+    }
+
+    /**
+     * @brief Get the vertex allocator
+     * @return range_allocator const&    Vertex ranges
+     */
+    range_allocator const& get_vertex_allocator() const {
+        return m_vertex_allocator;
+    }
+
+    /**
+     * @brief Get the index allocator
+     * @return range_allocator const&    Index ranges
+     */
+    range_allocator const& get_index_allocator() const {
+        return m_index_allocator;
+    }
+
+    /**
+     * @brief Get the number of geometries
+     * @return size_t    Number of geometries
+     */
+    size_t get_count() const {
+        return m_ranges.size();
+    }
+
+private:
+    /// Vertex buffer
+    buffer::s_ptr m_vertex_buffer;
+
+    /// Index buffer
+    buffer::s_ptr m_index_buffer;
+
+    /// Vertex ranges
+    range_allocator m_vertex_allocator;
+
+    /// Index ranges
+    range_allocator m_index_allocator;
+
+    /// Ranges of geometries
+    std::map<id, geometry_range> m_ranges;
+
+    /// Size of vertex
+    ui32 m_vertex_stride = 0;
+
+    /// Index type
+    VkIndexType m_index_type = VK_INDEX_TYPE_UINT32;
+};
+
+} // namespace lava
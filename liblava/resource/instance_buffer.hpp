@@ -0,0 +1,213 @@
+/**
+ * @file         liblava/resource/instance_buffer.hpp
+ * @brief        Per-instance vertex data
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/buffer.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+/**
+ * @brief Per-instance vertex data
+ *
+ * Keeps a host list of instances and uploads it into a ring of mapped
+ * buffers, one per frame in flight. A buffer grows geometrically when
+ * the list outgrows it.
+ *
+ * @tparam T    Instance struct
+ */
+template <typename T>
+struct instance_buffer : entity {
+    /// Shared pointer to instance buffer
+    using s_ptr = std::shared_ptr<instance_buffer<T>>;
+
+    /// List of instances
+    using list = std::vector<T>;
+
+    /**
+     * @brief Make a new instance buffer
+     * @return s_ptr    Shared pointer to instance buffer
+     */
+    static s_ptr make() {
+        return std::make_shared<instance_buffer<T>>();
+    }
+
+    /**
+     * @brief Destroy the instance buffer
+     */
+    ~instance_buffer() {
+        destroy();
+    }
+
+    /**
+     * @brief Create the instance buffer
+     * @param device         Vulkan device
+     * @param frame_count    Number of frames in flight
+     * @param capacity       Initial number of instances
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                ui32 frame_count,
+                ui32 capacity = 1024);
+
+    /**
+     * @brief Destroy the instance buffer
+     */
+    void destroy() {
+        m_buffers.clear();
+        m_count = 0;
+        m_device = nullptr;
+    }
+
+    /**
+     * @brief Add instance
+     * @param value    Instance data
+     */
+    void add(T const& value) {
+        m_data.push_back(value);
+    }
+
+    /**
+     * @brief Clear all instances
+     */
+    void clear() {
+        m_data.clear();
+    }
+
+    /**
+     * @brief Get the instances
+     * @return list&    List of instances
+     */
+    list& get_data() {
+        return m_data;
+    }
+
+    /**
+     * @brief Get the const instances
+     * @return list const&    List of instances
+     */
+    list const& get_data() const {
+        return m_data;
+    }
+
+    /**
+     * @brief Upload the instances to the next buffer of the ring
+     * @return Upload was successful or failed
+     */
+    bool upload();
+
+    /**
+     * @brief Get the current buffer
+     * @return VkBuffer    Vulkan buffer (last upload)
+     */
+    VkBuffer get() const {
+        return m_buffers.empty() ? VK_NULL_HANDLE : m_buffers[m_frame]->get();
+    }
+
+    /**
+     * @brief Get the number of uploaded instances
+     * @return ui32    Number of instances (last upload)
+     */
+    ui32 get_count() const {
+        return m_count;
+    }
+
+    /**
+     * @brief Get the capacity
+     * @return ui32    Number of instances fitting in a buffer
+     */
+    ui32 get_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief Get the vertex input binding of the instance struct
+     * @param binding                              Index of binding
+     * @return VkVertexInputBindingDescription    Binding description
+     */
+    static VkVertexInputBindingDescription get_binding(ui32 binding) {
+        return {binding, sizeof(T), VK_VERTEX_INPUT_RATE_INSTANCE};
+    }
+
+private:
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// List of instances
+    list m_data;
+
+    /// Ring of buffers (per frame)
+    buffer::s_list m_buffers;
+
+    /// Current buffer
+    index m_frame = 0;
+
+    /// Number of instances fitting in a buffer
+    ui32 m_capacity = 0;
+
+    /// Number of uploaded instances
+    ui32 m_count = 0;
+};
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool instance_buffer<T>::create(device::ptr device,
+                                ui32 frame_count,
+                                ui32 capacity) {
+    m_device = device;
+    m_capacity = std::max(capacity, 1u);
+    m_frame = 0;
+    m_count = 0;
+
+    m_buffers.clear();
+    for (auto i = 0u; i < std::max(frame_count, 1u); ++i)
+        m_buffers.push_back(buffer::make());
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool instance_buffer<T>::upload() {
+    if (m_buffers.empty())
+        return false;
+
+    m_frame = (m_frame + 1) % m_buffers.size();
+    m_count = 0;
+
+    auto const count = to_ui32(m_data.size());
+    if (count == 0)
+        return true;
+
+    if (count > m_capacity)
+        m_capacity = std::max(count, m_capacity * 2);
+
+    auto& target = m_buffers[m_frame];
+    auto const size = sizeof(T) * m_capacity;
+
+    if (!target->valid() || target->get_size() < sizeof(T) * count) {
+        if (target->valid())
+            target->destroy();
+
+        if (!target->create_mapped(m_device,
+                                   nullptr,
+                                   size,
+                                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
+            logger()->error("create instance buffer");
+            return false;
+        }
+    }
+
+    memcpy(target->get_mapped_data(), m_data.data(), sizeof(T) * count);
+    target->flush(0, sizeof(T) * count);
+
+    m_count = count;
+    return true;
+}
+
+} // namespace lava
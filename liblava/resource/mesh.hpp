@@ -8,13 +8,200 @@
 #pragma once
 
 #include "liblava/core/misc.hpp"
+#include "liblava/resource/bounds.hpp"
 #include "liblava/resource/buffer.hpp"
+#include "liblava/resource/instance_buffer.hpp"
 #include "liblava/resource/primitive.hpp"
+#include "liblava/resource/staging_ring.hpp"
 #include "liblava/util/hex.hpp"
 #include "liblava/util/log.hpp"
 
 namespace lava {
 
+/**
+ * @brief Select the smallest index type for indices
+ * @param indices         List of indices
+ * @param allow_uint8     Allow 8 bit indices (VK_EXT_index_type_uint8)
+ * @return VkIndexType    Index type
+ */
+inline VkIndexType select_index_type(index_list const& indices,
+                                     bool allow_uint8 = false) {
+    index max_index = 0;
+    for (auto const i : indices)
+        max_index = std::max(max_index, i);
+
+    // keep all-ones values free for primitive restart
+    if (allow_uint8 && max_index < 0xff)
+        return VK_INDEX_TYPE_UINT8_EXT;
+
+    if (max_index < 0xffff)
+        return VK_INDEX_TYPE_UINT16;
+
+    return VK_INDEX_TYPE_UINT32;
+}
+
+/**
+ * @brief Get the size of an index type
+ * @param type       Index type
+ * @return size_t    Size in bytes
+ */
+inline size_t index_type_size(VkIndexType type) {
+    switch (type) {
+    case VK_INDEX_TYPE_UINT8_EXT:
+        return sizeof(ui8);
+    case VK_INDEX_TYPE_UINT16:
+        return sizeof(ui16);
+    default:
+        return sizeof(ui32);
+    }
+}
+
+/**
+ * @brief Pack indices to index type
+ * @param indices                List of indices
+ * @param type                   Target index type
+ * @return std::vector<ui8>      Packed index data
+ */
+inline std::vector<ui8> pack_indices(index_list const& indices,
+                                     VkIndexType type) {
+    std::vector<ui8> result(indices.size() * index_type_size(type));
+
+    switch (type) {
+    case VK_INDEX_TYPE_UINT8_EXT: {
+        for (auto i = 0u; i < indices.size(); ++i)
+            result[i] = static_cast<ui8>(indices[i]);
+        break;
+    }
+    case VK_INDEX_TYPE_UINT16: {
+        auto target = reinterpret_cast<ui16*>(result.data());
+        for (auto i = 0u; i < indices.size(); ++i)
+            target[i] = static_cast<ui16>(indices[i]);
+        break;
+    }
+    default:
+        memcpy(result.data(), indices.data(), result.size());
+    }
+
+    return result;
+}
+
+/**
+ * @brief Mesh vertex attribute streams
+ */
+enum class mesh_stream : flag {
+    none = 0 << 0,
+    position = 1 << 0,
+    color = 1 << 1,
+    uv = 1 << 2,
+    normal = 1 << 3,
+    all = position | color | uv | normal,
+};
+
+ENUM_FLAG_OPERATORS(mesh_stream)
+
+/// Number of mesh streams
+constexpr ui32 const mesh_stream_count = 4;
+
+/// Default binding of instance buffers (after all mesh streams)
+constexpr ui32 const mesh_instance_binding = mesh_stream_count;
+
+/**
+ * @brief Get the vertex input binding of a split mesh stream
+ * @param stream    Single mesh stream
+ * @return ui32     Binding index
+ */
+inline ui32 get_mesh_stream_binding(mesh_stream stream) {
+    switch (stream) {
+    case mesh_stream::color:
+        return 1;
+    case mesh_stream::uv:
+        return 2;
+    case mesh_stream::normal:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Mesh level of detail (range in index list)
+ */
+struct mesh_lod {
+    /// List of mesh lods
+    using list = std::vector<mesh_lod>;
+
+    /// First index
+    index first_index = 0;
+
+    /// Number of indices
+    ui32 index_count = 0;
+
+    /// Geometric error to full detail in mesh units
+    r32 error = 0.f;
+};
+
+/**
+ * @brief Range of mesh elements (vertices or indices)
+ */
+struct mesh_range {
+    /// First element
+    index first = 0;
+
+    /// End of range (exclusive)
+    index last = 0;
+
+    /**
+     * @brief Check if range is empty
+     * @return Range is empty or not
+     */
+    bool empty() const {
+        return first >= last;
+    }
+
+    /**
+     * @brief Get the number of elements
+     * @return ui32    Number of elements
+     */
+    ui32 size() const {
+        return empty() ? 0 : last - first;
+    }
+
+    /**
+     * @brief Extend range to include elements
+     * @param first_element    First element
+     * @param count            Number of elements
+     */
+    void add(index first_element,
+             ui32 count) {
+        add({first_element, first_element + count});
+    }
+
+    /**
+     * @brief Extend range to include other range
+     * @param other    Range to include
+     */
+    void add(mesh_range const& other) {
+        if (other.empty())
+            return;
+
+        if (empty()) {
+            *this = other;
+            return;
+        }
+
+        first = std::min(first, other.first);
+        last = std::max(last, other.last);
+    }
+
+    /**
+     * @brief Clear the range
+     */
+    void clear() {
+        first = 0;
+        last = 0;
+    }
+};
+
 /**
  * @brief Templated mesh data
  * @tparam T    Input vertex struct
@@ -27,6 +214,51 @@ struct mesh_template_data {
     /// List of indices.
     index_list indices;
 
+    /// List of lods (empty: indices are a single level)
+    mesh_lod::list lods;
+
+    /// Changed vertices since last update
+    mesh_range dirty_vertices;
+
+    /// Changed indices since last update
+    mesh_range dirty_indices;
+
+    /**
+     * @brief Mark vertices as changed
+     * @param first    First vertex
+     * @param count    Number of vertices
+     */
+    void mark_vertices(index first,
+                       ui32 count) {
+        dirty_vertices.add(first, count);
+    }
+
+    /**
+     * @brief Mark indices as changed
+     * @param first    First index
+     * @param count    Number of indices
+     */
+    void mark_indices(index first,
+                      ui32 count) {
+        dirty_indices.add(first, count);
+    }
+
+    /**
+     * @brief Mark all vertices and indices as changed
+     */
+    void mark_all() {
+        mark_vertices(0, to_ui32(vertices.size()));
+        mark_indices(0, to_ui32(indices.size()));
+    }
+
+    /**
+     * @brief Clear changed ranges
+     */
+    void clear_dirty() {
+        dirty_vertices.clear();
+        dirty_indices.clear();
+    }
+
     /**
      * @brief Move mesh data by offset
      * @tparam PosType    Coordinate element typename
@@ -39,6 +271,8 @@ struct mesh_template_data {
                 vertex.position[i] += offset[i];
             }
         }
+
+        mark_vertices(0, to_ui32(vertices.size()));
     }
 
     /**
@@ -51,6 +285,8 @@ struct mesh_template_data {
                 vertex.position[i] *= factor;
             }
         }
+
+        mark_vertices(0, to_ui32(vertices.size()));
     }
 
     /**
@@ -65,6 +301,8 @@ struct mesh_template_data {
                 vertex.position[i] *= factors[i];
             }
         }
+
+        mark_vertices(0, to_ui32(vertices.size()));
     }
 };
 
@@ -103,14 +341,20 @@ struct mesh_template : entity {
 
     /**
      * @brief Create a new mesh
+     *
+     * Static meshes with GPU only memory are uploaded through staging
+     * buffers, submitted on the graphics queue without waiting (see
+     * staging_ring::submit). Mapped or dynamic meshes stay in host
+     * visible memory.
+     *
      * @param device          Vulkan device
      * @param mapped          Map mesh data
-     * @param memory_usage    Memory usage
+     * @param memory_usage    Memory usage (GPU only: CPU to GPU if mapped or dynamic)
      * @return Create was successful or failed
      */
     bool create(device::ptr device,
                 bool mapped = false,
-                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_GPU_ONLY);
 
     /**
      * @brief Destroy the mesh
@@ -121,7 +365,49 @@ struct mesh_template : entity {
      * @brief Bind the mesh
      * @param cmd_buf    Command buffer
      */
-    void bind(VkCommandBuffer cmd_buf) const;
+    void bind(VkCommandBuffer cmd_buf) const {
+        bind(cmd_buf, mesh_stream::all);
+    }
+
+    /**
+     * @brief Bind streams of the mesh (split streams only, else all)
+     * @param cmd_buf    Command buffer
+     * @param streams    Streams to bind (e.g. position for depth passes)
+     */
+    void bind(VkCommandBuffer cmd_buf,
+              mesh_stream streams) const;
+
+    /**
+     * @brief Bind the mesh with a per-instance buffer
+     * @param cmd_buf      Command buffer
+     * @param instances    Buffer with instance input rate
+     * @param binding      Binding of instance buffer
+     * @param offset       Offset in instance buffer
+     */
+    void bind(VkCommandBuffer cmd_buf,
+              VkBuffer instances,
+              ui32 binding = mesh_instance_binding,
+              VkDeviceSize offset = 0) const {
+        bind(cmd_buf);
+
+        vkCmdBindVertexBuffers(cmd_buf, binding,
+                               1, &instances,
+                               &offset);
+    }
+
+    /**
+     * @brief Bind the mesh with instance data
+     * @tparam I           Instance struct
+     * @param cmd_buf      Command buffer
+     * @param instances    Uploaded instance data
+     * @param binding      Binding of instance buffer
+     */
+    template <typename I>
+    void bind(VkCommandBuffer cmd_buf,
+              instance_buffer<I> const& instances,
+              ui32 binding = mesh_instance_binding) const {
+        bind(cmd_buf, instances.get(), binding);
+    }
 
     /**
      * @brief Draw the mesh
@@ -129,6 +415,26 @@ struct mesh_template : entity {
      */
     void draw(VkCommandBuffer cmd_buf) const;
 
+    /**
+     * @brief Draw instances of the mesh
+     * @param cmd_buf           Command buffer
+     * @param instance_count    Number of instances
+     * @param first_instance    First instance
+     * @param lod               Index of lod (clamped to available lods)
+     */
+    void draw_instanced(VkCommandBuffer cmd_buf,
+                        ui32 instance_count,
+                        ui32 first_instance = 0,
+                        index lod = 0) const;
+
+    /**
+     * @brief Draw a level of detail of the mesh
+     * @param cmd_buf    Command buffer
+     * @param lod        Index of lod (clamped to available lods)
+     */
+    void draw(VkCommandBuffer cmd_buf,
+              index lod) const;
+
     /**
      * @brief Bind and draw the mesh
      * @param cmd_buf    Command buffer
@@ -138,6 +444,24 @@ struct mesh_template : entity {
         draw(cmd_buf);
     }
 
+    /**
+     * @brief Bind and draw all uploaded instances of the mesh
+     * @tparam I           Instance struct
+     * @param cmd_buf      Command buffer
+     * @param instances    Uploaded instance data
+     * @param binding      Binding of instance buffer
+     */
+    template <typename I>
+    void bind_draw(VkCommandBuffer cmd_buf,
+                   instance_buffer<I> const& instances,
+                   ui32 binding = mesh_instance_binding) const {
+        if (instances.get_count() == 0)
+            return;
+
+        bind(cmd_buf, instances, binding);
+        draw_instanced(cmd_buf, instances.get_count());
+    }
+
     /**
      * @brief Check if mesh is empty
      * @return Mesh is empty or not
@@ -152,6 +476,7 @@ struct mesh_template : entity {
      */
     void set_data(mesh_template_data<T> const& value) {
         m_data = value;
+        m_data.mark_all();
     }
 
     /**
@@ -168,6 +493,7 @@ struct mesh_template : entity {
      */
     void add_data(mesh_template_data<T> const& value) {
         m_data = value;
+        m_data.mark_all();
     }
 
     /**
@@ -218,12 +544,39 @@ struct mesh_template : entity {
         return to_ui32(m_data.indices.size());
     }
 
+    /**
+     * @brief Get the lods of the mesh
+     * @return mesh_lod::list const&    List of lods
+     */
+    mesh_lod::list const& get_lods() const {
+        return m_data.lods;
+    }
+
+    /**
+     * @brief Get the bounds of the mesh
+     * @return mesh_bounds const&    Box and sphere (calculated on create and update)
+     */
+    mesh_bounds const& get_bounds() const {
+        return m_bounds;
+    }
+
     /**
      * @brief Reload the mesh data
      * @return Reload was successful or failed
      */
     bool reload();
 
+    /**
+     * @brief Write changed ranges of mesh data to the next buffers
+     *
+     * Dynamic meshes keep a ring of mapped buffers (one per frame in
+     * flight) which grow geometrically. Call once per frame at most.
+     * Static meshes are reloaded. Changed vertices recalculate the bounds.
+     *
+     * @return Update was successful or failed
+     */
+    bool update();
+
     /**
      * @brief Get the vertex buffer of the mesh
      * @return buffer::s_ptr    Shared pointer to buffer
@@ -240,13 +593,167 @@ struct mesh_template : entity {
         return m_index_buffer;
     }
 
+    /**
+     * @brief Get the index type of the index buffer
+     * @return VkIndexType    Index type (selected on create)
+     */
+    VkIndexType get_index_type() const {
+        return m_index_type;
+    }
+
+    /**
+     * @brief Keep mesh data in host visible memory on create
+     * @param value          Mesh data changes after create
+     * @param frame_count    Number of buffers for update (frames in flight)
+     */
+    void set_dynamic(bool value = true,
+                     ui32 frame_count = 2) {
+        m_dynamic = value;
+        m_frame_count = frame_count;
+    }
+
+    /**
+     * @brief Check if mesh is dynamic
+     * @return Dynamic or static mesh
+     */
+    bool dynamic() const {
+        return m_dynamic;
+    }
+
+    /**
+     * @brief Allow 8 bit indices on create
+     * @param value    Device has VK_EXT_index_type_uint8 enabled
+     */
+    void set_allow_index_uint8(bool value = true) {
+        m_allow_index_uint8 = value;
+    }
+
+    /**
+     * @brief Upload attributes in split streams on create
+     * @param value    One buffer per attribute instead of interleaved
+     */
+    void set_split_streams(bool value = true) {
+        m_split_streams = value;
+    }
+
+    /**
+     * @brief Check if mesh uses split streams
+     * @return Split or interleaved streams
+     */
+    bool split_streams() const {
+        return m_split_streams;
+    }
+
+    /**
+     * @brief Get the buffer of a split stream
+     * @param stream            Single mesh stream
+     * @return buffer::s_ptr    Shared pointer to buffer (nullptr: not split)
+     */
+    buffer::s_ptr get_stream_buffer(mesh_stream stream) {
+        return m_stream_buffers.at(get_mesh_stream_binding(stream));
+    }
+
+    /**
+     * @brief Get the streams of the vertex struct
+     * @return mesh_stream    Available streams
+     */
+    static mesh_stream get_streams() {
+        auto result = mesh_stream::position;
+        if constexpr (requires(T const t) { t.color; })
+            result |= mesh_stream::color;
+        if constexpr (requires(T const t) { t.uv; })
+            result |= mesh_stream::uv;
+        if constexpr (requires(T const t) { t.normal; })
+            result |= mesh_stream::normal;
+        return result;
+    }
+
+    /**
+     * @brief Get the vertex input bindings of split streams
+     * @param streams                              Streams used by pipeline
+     * @return VkVertexInputBindingDescriptions    Binding descriptions
+     */
+    static VkVertexInputBindingDescriptions get_stream_bindings(mesh_stream streams = mesh_stream::all) {
+        VkVertexInputBindingDescriptions result;
+
+        auto const add = [&](mesh_stream stream, size_t stride) {
+            if ((streams & get_streams() & stream) != mesh_stream::none)
+                result.push_back({get_mesh_stream_binding(stream),
+                                  to_ui32(stride),
+                                  VK_VERTEX_INPUT_RATE_VERTEX});
+        };
+
+        add(mesh_stream::position, sizeof(T::position));
+        if constexpr (requires(T const t) { t.color; })
+            add(mesh_stream::color, sizeof(T::color));
+        if constexpr (requires(T const t) { t.uv; })
+            add(mesh_stream::uv, sizeof(T::uv));
+        if constexpr (requires(T const t) { t.normal; })
+            add(mesh_stream::normal, sizeof(T::normal));
+
+        return result;
+    }
+
 private:
+    /**
+     * @brief Buffers of dynamic mesh for a frame
+     */
+    struct dynamic_storage {
+        /// Vertex buffer
+        buffer::s_ptr vertex_buffer;
+
+        /// Split stream buffers (by binding)
+        std::array<buffer::s_ptr, mesh_stream_count> stream_buffers;
+
+        /// Index buffer
+        buffer::s_ptr index_buffer;
+
+        /// Number of vertices fitting in buffers
+        ui32 vertex_capacity = 0;
+
+        /// Number of indices fitting in buffer
+        ui32 index_capacity = 0;
+
+        /// Vertices to write on next update
+        mesh_range vertices;
+
+        /// Indices to write on next update
+        mesh_range indices;
+    };
+
+    /**
+     * @brief Get the memory usage of host visible buffers
+     * @return VmaMemoryUsage    Memory usage
+     */
+    VmaMemoryUsage get_host_memory_usage() const {
+        return m_memory_usage == VMA_MEMORY_USAGE_GPU_ONLY
+                   ? VMA_MEMORY_USAGE_CPU_TO_GPU
+                   : m_memory_usage;
+    }
+
+    /**
+     * @brief Write changed vertices to storage (grow if needed)
+     * @param storage    Dynamic storage
+     * @return Write was successful or failed
+     */
+    bool update_vertices(dynamic_storage& storage);
+
+    /**
+     * @brief Write changed indices to storage (grow if needed)
+     * @param storage    Dynamic storage
+     * @return Write was successful or failed
+     */
+    bool update_indices(dynamic_storage& storage);
+
     /// Vulkan device
     device::ptr m_device = nullptr;
 
     /// Mesh data
     mesh_template_data<T> m_data;
 
+    /// Bounds of mesh data
+    mesh_bounds m_bounds;
+
     /// Vertex buffer
     buffer::s_ptr m_vertex_buffer;
 
@@ -257,13 +764,54 @@ private:
     bool m_mapped = false;
 
     /// Memory usage
-    VmaMemoryUsage m_memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    VmaMemoryUsage m_memory_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+    /// Dynamic state
+    bool m_dynamic = false;
+
+    /// Number of dynamic storages
+    ui32 m_frame_count = 2;
+
+    /// Ring of dynamic storages
+    std::vector<dynamic_storage> m_storage;
+
+    /// Current dynamic storage
+    index m_storage_index = 0;
+
+    /// Index type of index buffer
+    VkIndexType m_index_type = VK_INDEX_TYPE_UINT32;
+
+    /// Allow 8 bit indices
+    bool m_allow_index_uint8 = false;
+
+    /// Split streams state
+    bool m_split_streams = false;
+
+    /// Split stream buffers (by binding)
+    std::array<buffer::s_ptr, mesh_stream_count> m_stream_buffers;
 };
 
 //-----------------------------------------------------------------------------
 template <typename T>
-void mesh_template<T>::bind(VkCommandBuffer cmd_buf) const {
-    if (m_vertex_buffer && m_vertex_buffer->valid()) {
+void mesh_template<T>::bind(VkCommandBuffer cmd_buf,
+                            mesh_stream streams) const {
+    if (m_split_streams) {
+        for (auto i = 0u; i < mesh_stream_count; ++i) {
+            if ((streams & mesh_stream(1u << i)) == mesh_stream::none)
+                continue;
+
+            auto const& stream_buffer = m_stream_buffers[i];
+            if (!stream_buffer || !stream_buffer->valid())
+                continue;
+
+            VkDeviceSize const buffer_offset = 0;
+            auto const buffer = stream_buffer->get();
+
+            vkCmdBindVertexBuffers(cmd_buf, i,
+                                   1, &buffer,
+                                   &buffer_offset);
+        }
+    } else if (m_vertex_buffer && m_vertex_buffer->valid()) {
         std::array<VkDeviceSize, 1> const buffer_offsets = {0};
         std::array<VkBuffer, 1> const buffers = {m_vertex_buffer->get()};
 
@@ -276,20 +824,41 @@ void mesh_template<T>::bind(VkCommandBuffer cmd_buf) const {
         vkCmdBindIndexBuffer(cmd_buf,
                              m_index_buffer->get(),
                              0,
-                             VK_INDEX_TYPE_UINT32);
+                             m_index_type);
 }
 
 //-----------------------------------------------------------------------------
 template <typename T>
 void mesh_template<T>::draw(VkCommandBuffer cmd_buf) const {
-    if (!m_data.indices.empty())
+    draw_instanced(cmd_buf, 1);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void mesh_template<T>::draw(VkCommandBuffer cmd_buf,
+                            index lod) const {
+    draw_instanced(cmd_buf, 1, 0, lod);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void mesh_template<T>::draw_instanced(VkCommandBuffer cmd_buf,
+                                      ui32 instance_count,
+                                      ui32 first_instance,
+                                      index lod) const {
+    if (!m_data.lods.empty()) {
+        auto const& level = m_data.lods.at(std::min(lod, to_index(m_data.lods.size() - 1)));
+        vkCmdDrawIndexed(cmd_buf,
+                         level.index_count,
+                         instance_count, level.first_index, 0, first_instance);
+    } else if (!m_data.indices.empty())
         vkCmdDrawIndexed(cmd_buf,
                          to_ui32(m_data.indices.size()),
-                         1, 0, 0, 0);
+                         instance_count, 0, 0, first_instance);
     else
         vkCmdDraw(cmd_buf,
                   to_ui32(m_data.vertices.size()),
-                  1, 0, 0);
+                  instance_count, 0, first_instance);
 }
 
 //-----------------------------------------------------------------------------
@@ -297,6 +866,12 @@ template <typename T>
 void mesh_template<T>::destroy() {
     m_vertex_buffer = nullptr;
     m_index_buffer = nullptr;
+
+    for (auto& stream_buffer : m_stream_buffers)
+        stream_buffer = nullptr;
+
+    m_storage.clear();
+
     m_device = nullptr;
 }
 
@@ -309,6 +884,146 @@ bool mesh_template<T>::reload() {
     return create(dev, m_mapped, m_memory_usage);
 }
 
+//-----------------------------------------------------------------------------
+template <typename T>
+bool mesh_template<T>::update() {
+    if (m_storage.empty())
+        return reload();
+
+    for (auto& storage : m_storage) {
+        storage.vertices.add(m_data.dirty_vertices);
+        storage.indices.add(m_data.dirty_indices);
+    }
+
+    // moved vertices change the bounds of culling
+    if (!m_data.dirty_vertices.empty())
+        m_bounds = calc_bounds(m_data.vertices);
+
+    m_data.clear_dirty();
+
+    m_storage_index = to_index((m_storage_index + 1) % m_storage.size());
+    auto& storage = m_storage[m_storage_index];
+
+    if (!update_vertices(storage) || !update_indices(storage))
+        return false;
+
+    m_vertex_buffer = storage.vertex_buffer;
+    m_stream_buffers = storage.stream_buffers;
+    m_index_buffer = storage.index_buffer;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool mesh_template<T>::update_vertices(dynamic_storage& storage) {
+    auto const count = to_ui32(m_data.vertices.size());
+
+    auto const create_buffer = [&](buffer::s_ptr& target,
+                                   size_t stride) {
+        target = buffer::make();
+        return target->create_mapped(m_device,
+                                     nullptr,
+                                     stride * storage.vertex_capacity,
+                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                     get_host_memory_usage());
+    };
+
+    if (count > storage.vertex_capacity) {
+        storage.vertex_capacity = std::max(count, storage.vertex_capacity * 2);
+
+        if (m_split_streams) {
+            auto result = create_buffer(storage.stream_buffers[0], sizeof(T::position));
+            if constexpr (requires(T const t) { t.color; })
+                result = result && create_buffer(storage.stream_buffers[1], sizeof(T::color));
+            if constexpr (requires(T const t) { t.uv; })
+                result = result && create_buffer(storage.stream_buffers[2], sizeof(T::uv));
+            if constexpr (requires(T const t) { t.normal; })
+                result = result && create_buffer(storage.stream_buffers[3], sizeof(T::normal));
+
+            if (!result) {
+                logger()->error("create mesh stream buffer");
+                return false;
+            }
+        } else if (!create_buffer(storage.vertex_buffer, sizeof(T))) {
+            logger()->error("create mesh vertex buffer");
+            return false;
+        }
+
+        storage.vertices = {0, count};
+    }
+
+    auto range = storage.vertices;
+    storage.vertices.clear();
+
+    range.last = std::min(range.last, count);
+    if (range.empty())
+        return true;
+
+    auto const write = [&](buffer::s_ptr const& target, auto project) {
+        using field_type = std::decay_t<decltype(project(m_data.vertices.front()))>;
+
+        auto data = static_cast<field_type*>(target->get_mapped_data());
+        for (auto i = range.first; i < range.last; ++i)
+            data[i] = project(m_data.vertices[i]);
+
+        target->flush(range.first * sizeof(field_type),
+                      range.size() * sizeof(field_type));
+    };
+
+    if (m_split_streams) {
+        write(storage.stream_buffers[0], [](T const& v) { return v.position; });
+        if constexpr (requires(T const t) { t.color; })
+            write(storage.stream_buffers[1], [](T const& v) { return v.color; });
+        if constexpr (requires(T const t) { t.uv; })
+            write(storage.stream_buffers[2], [](T const& v) { return v.uv; });
+        if constexpr (requires(T const t) { t.normal; })
+            write(storage.stream_buffers[3], [](T const& v) { return v.normal; });
+    } else {
+        write(storage.vertex_buffer, [](T const& v) { return v; });
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool mesh_template<T>::update_indices(dynamic_storage& storage) {
+    auto const count = to_ui32(m_data.indices.size());
+
+    if (count > storage.index_capacity) {
+        storage.index_capacity = std::max(count, storage.index_capacity * 2);
+
+        storage.index_buffer = buffer::make();
+        if (!storage.index_buffer->create_mapped(m_device,
+                                                 nullptr,
+                                                 sizeof(index) * storage.index_capacity,
+                                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                 get_host_memory_usage())) {
+            logger()->error("create mesh index buffer");
+            return false;
+        }
+
+        storage.indices = {0, count};
+    }
+
+    auto range = storage.indices;
+    storage.indices.clear();
+
+    range.last = std::min(range.last, count);
+    if (range.empty())
+        return true;
+
+    memcpy(static_cast<index*>(storage.index_buffer->get_mapped_data()) + range.first,
+           m_data.indices.data() + range.first,
+           range.size() * sizeof(index));
+
+    storage.index_buffer->flush(range.first * sizeof(index),
+                                range.size() * sizeof(index));
+
+    return true;
+}
+
 /**
  * @brief Create a new primitive mesh_data
  * @tparam T                        Type of vertex struct
@@ -362,34 +1077,115 @@ bool mesh_template<T>::create(device::ptr dev,
     m_mapped = m;
     m_memory_usage = mu;
 
-    if (!m_data.vertices.empty()) {
-        m_vertex_buffer = buffer::make();
+    m_bounds = calc_bounds(m_data.vertices);
 
-        if (!m_vertex_buffer->create(m_device,
-                                     m_data.vertices.data(),
-                                     sizeof(T) * m_data.vertices.size(),
-                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                                     m_mapped,
-                                     m_memory_usage)) {
+    if (m_dynamic) {
+        // 32 bit indices: ranges are written in place
+        m_index_type = VK_INDEX_TYPE_UINT32;
+
+        m_storage.clear();
+        m_storage.resize(std::max(m_frame_count, 1u));
+        m_storage_index = to_index(m_storage.size() - 1);
+
+        m_data.mark_all();
+        return update();
+    }
+
+    auto const staged = !m_mapped
+                        && m_memory_usage == VMA_MEMORY_USAGE_GPU_ONLY;
+
+    auto const memory_usage = get_host_memory_usage();
+
+    buffer_upload::list uploads;
+
+    auto const create_buffer = [&](buffer::s_ptr& target,
+                                   void const* data,
+                                   size_t size,
+                                   VkBufferUsageFlags usage) {
+        if (staged) {
+            target = create_staged_buffer(m_device, data, size, usage, uploads);
+            return target != nullptr;
+        }
+
+        target = buffer::make();
+        return target->create(m_device,
+                              data,
+                              size,
+                              usage,
+                              m_mapped,
+                              memory_usage);
+    };
+
+    if (!m_data.vertices.empty() && m_split_streams) {
+        auto const create_stream = [&](mesh_stream stream, auto project) {
+            using field_type = std::decay_t<decltype(project(m_data.vertices.front()))>;
+
+            std::vector<field_type> stream_data;
+            stream_data.reserve(m_data.vertices.size());
+            for (auto const& vertex : m_data.vertices)
+                stream_data.push_back(project(vertex));
+
+            if (!create_buffer(m_stream_buffers[get_mesh_stream_binding(stream)],
+                               stream_data.data(),
+                               sizeof(field_type) * stream_data.size(),
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
+                logger()->error("create mesh stream buffer");
+                return false;
+            }
+
+            return true;
+        };
+
+        if (!create_stream(mesh_stream::position, [](T const& v) { return v.position; }))
+            return false;
+
+        if constexpr (requires(T const t) { t.color; })
+            if (!create_stream(mesh_stream::color, [](T const& v) { return v.color; }))
+                return false;
+
+        if constexpr (requires(T const t) { t.uv; })
+            if (!create_stream(mesh_stream::uv, [](T const& v) { return v.uv; }))
+                return false;
+
+        if constexpr (requires(T const t) { t.normal; })
+            if (!create_stream(mesh_stream::normal, [](T const& v) { return v.normal; }))
+                return false;
+    } else if (!m_data.vertices.empty()) {
+        if (!create_buffer(m_vertex_buffer,
+                           m_data.vertices.data(),
+                           sizeof(T) * m_data.vertices.size(),
+                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
             logger()->error("create mesh vertex buffer");
             return false;
         }
     }
 
     if (!m_data.indices.empty()) {
-        m_index_buffer = buffer::make();
-
-        if (!m_index_buffer->create(m_device,
-                                    m_data.indices.data(),
-                                    sizeof(ui32) * m_data.indices.size(),
-                                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                    m_mapped,
-                                    m_memory_usage)) {
+        // mapped: indices are written in place as 32 bit
+        m_index_type = m_mapped
+                           ? VK_INDEX_TYPE_UINT32
+                           : select_index_type(m_data.indices,
+                                               m_allow_index_uint8);
+
+        auto const index_data = pack_indices(m_data.indices,
+                                             m_index_type);
+
+        if (!create_buffer(m_index_buffer,
+                           index_data.data(),
+                           index_data.size(),
+                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
             logger()->error("create mesh index buffer");
             return false;
         }
     }
 
+    if (!submit_uploads(m_device, uploads)) {
+        logger()->error("upload mesh buffers");
+        return false;
+    }
+
+    m_data.clear_dirty();
+
     return true;
 }
 
@@ -0,0 +1,434 @@
+/**
+ * @file         liblava/resource/mesh_lod.cpp
+ * @brief        Mesh simplification and level of detail
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/mesh_lod.hpp"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace lava {
+
+namespace {
+
+/// Weight of planes which keep open borders in place
+constexpr r64 const boundary_weight = 10.0;
+
+/**
+ * @brief Error quadric (symmetric 4x4 matrix)
+ */
+struct quadric {
+    /// Matrix elements
+    r64 a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0,
+        b2 = 0.0, bc = 0.0, bd = 0.0,
+        c2 = 0.0, cd = 0.0,
+        d2 = 0.0;
+
+    /// Accumulated weight
+    r64 w = 0.0;
+
+    /**
+     * @brief Add a weighted plane
+     * @param n         Plane normal
+     * @param d         Plane distance
+     * @param weight    Plane weight
+     */
+    void add_plane(v3 const& n, r64 d, r64 weight) {
+        r64 const a = n.x, b = n.y, c = n.z;
+
+        a2 += a * a * weight;
+        ab += a * b * weight;
+        ac += a * c * weight;
+        ad += a * d * weight;
+        b2 += b * b * weight;
+        bc += b * c * weight;
+        bd += b * d * weight;
+        c2 += c * c * weight;
+        cd += c * d * weight;
+        d2 += d * d * weight;
+        w += weight;
+    }
+
+    /**
+     * @brief Add another quadric
+     * @param q    Quadric to add
+     */
+    void add(quadric const& q) {
+        a2 += q.a2;
+        ab += q.ab;
+        ac += q.ac;
+        ad += q.ad;
+        b2 += q.b2;
+        bc += q.bc;
+        bd += q.bd;
+        c2 += q.c2;
+        cd += q.cd;
+        d2 += q.d2;
+        w += q.w;
+    }
+
+    /**
+     * @brief Get the mean squared distance of point to all planes
+     * @param p       Point
+     * @return r64    Error
+     */
+    r64 error(v3 const& p) const {
+        r64 const x = p.x, y = p.y, z = p.z;
+
+        auto const r = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+                       + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+                       + c2 * z * z + 2.0 * cd * z
+                       + d2;
+
+        return w > 0.0 ? std::abs(r) / w : std::abs(r);
+    }
+};
+
+/**
+ * @brief Edge collapse candidate
+ */
+struct collapse_candidate {
+    /// Vertex to remove
+    index from = 0;
+
+    /// Vertex to keep
+    index to = 0;
+
+    /// Collapse error
+    r64 cost = 0.0;
+};
+
+/**
+ * @brief Hash of position
+ */
+struct position_hash {
+    size_t operator()(v3 const& p) const {
+        return hash_value(p.x, p.y, p.z);
+    }
+};
+
+/**
+ * @brief Get the undirected edge key
+ * @param a       First vertex
+ * @param b       Second vertex
+ * @return ui64   Edge key
+ */
+inline ui64 edge_key(index a, index b) {
+    return a < b ? (ui64(a) << 32) | b
+                 : (ui64(b) << 32) | a;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+r32 calc_mesh_extent(std::vector<v3> const& positions) {
+    if (positions.empty())
+        return 0.f;
+
+    auto min = positions.front();
+    auto max = min;
+    for (auto const& p : positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    auto const size = max - min;
+    return std::max(size.x, std::max(size.y, size.z));
+}
+
+//-----------------------------------------------------------------------------
+index_list simplify_mesh_indices(std::vector<v3> const& positions,
+                                 index_list const& indices,
+                                 size_t target_index_count,
+                                 r32 target_error,
+                                 r32* result_error) {
+    if (result_error)
+        *result_error = 0.f;
+
+    if (indices.size() % 3 != 0 || indices.size() <= target_index_count)
+        return indices;
+
+    auto const vertex_count = positions.size();
+
+    // normalize positions to extent
+
+    auto const extent = calc_mesh_extent(positions);
+    auto const inv_extent = extent > 0.f ? 1.f / extent : 1.f;
+
+    std::vector<v3> pos(vertex_count);
+    for (auto i = 0u; i < vertex_count; ++i)
+        pos[i] = positions[i] * inv_extent;
+
+    // weld vertices with equal positions (first vertex is canonical)
+
+    index_list weld(vertex_count);
+    {
+        std::unordered_map<v3, index, position_hash> unique;
+        unique.reserve(vertex_count);
+
+        for (auto i = 0u; i < vertex_count; ++i)
+            weld[i] = unique.emplace(positions[i], i).first->second;
+    }
+
+    index_list collapse(vertex_count);
+    std::iota(collapse.begin(), collapse.end(), 0);
+
+    auto find = [&](index v) {
+        auto root = v;
+        while (collapse[root] != root)
+            root = collapse[root];
+
+        while (collapse[v] != root) {
+            auto const next = collapse[v];
+            collapse[v] = root;
+            v = next;
+        }
+
+        return root;
+    };
+
+    index_list triangles;
+    triangles.reserve(indices.size());
+    for (auto i = 0u; i < indices.size(); i += 3) {
+        auto const a = weld[indices[i]];
+        auto const b = weld[indices[i + 1]];
+        auto const c = weld[indices[i + 2]];
+
+        if (a == b || b == c || a == c)
+            continue;
+
+        triangles.insert(triangles.end(), {a, b, c});
+    }
+
+    // quadrics of triangle planes and open borders
+
+    std::vector<quadric> quadrics(vertex_count);
+    std::unordered_map<ui64, ui32> edge_usage;
+    edge_usage.reserve(triangles.size());
+
+    for (auto t = 0u; t < triangles.size(); t += 3) {
+        auto const& p0 = pos[triangles[t]];
+        auto const& p1 = pos[triangles[t + 1]];
+        auto const& p2 = pos[triangles[t + 2]];
+
+        auto const normal = glm::cross(p1 - p0, p2 - p0);
+        auto const length = glm::length(normal);
+        if (length <= 0.f)
+            continue;
+
+        auto const n = normal / length;
+        auto const d = -glm::dot(n, p0);
+
+        for (auto k = 0u; k < 3; ++k) {
+            quadrics[triangles[t + k]].add_plane(n, d, length * 0.5f);
+            ++edge_usage[edge_key(triangles[t + k], triangles[t + (k + 1) % 3])];
+        }
+    }
+
+    for (auto t = 0u; t < triangles.size(); t += 3) {
+        auto const& p0 = pos[triangles[t]];
+        auto const& p1 = pos[triangles[t + 1]];
+        auto const& p2 = pos[triangles[t + 2]];
+
+        auto const normal = glm::cross(p1 - p0, p2 - p0);
+        if (glm::length(normal) <= 0.f)
+            continue;
+
+        for (auto k = 0u; k < 3; ++k) {
+            auto const a = triangles[t + k];
+            auto const b = triangles[t + (k + 1) % 3];
+            if (edge_usage[edge_key(a, b)] != 1)
+                continue;
+
+            auto const edge = pos[b] - pos[a];
+            auto const plane_normal = glm::cross(edge, normal);
+            auto const length = glm::length(plane_normal);
+            if (length <= 0.f)
+                continue;
+
+            auto const n = plane_normal / length;
+            auto const d = -glm::dot(n, pos[a]);
+            auto const weight = glm::dot(edge, edge) * boundary_weight;
+
+            quadrics[a].add_plane(n, d, weight);
+            quadrics[b].add_plane(n, d, weight);
+        }
+    }
+
+    // collapse passes
+
+    auto const max_error = r64(target_error) * r64(target_error);
+    auto const target_triangles = target_index_count / 3;
+    auto reached_error = 0.0;
+
+    std::vector<collapse_candidate> candidates;
+    index_list adjacency_offsets;
+    index_list adjacency;
+    std::vector<bool> locked;
+
+    auto flips = [&](index from, index to) {
+        for (auto a = adjacency_offsets[from]; a < adjacency_offsets[from + 1]; ++a) {
+            auto const t = adjacency[a] * 3;
+
+            std::array<index, 3> corners = {find(triangles[t]),
+                                            find(triangles[t + 1]),
+                                            find(triangles[t + 2])};
+
+            if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+                continue;
+
+            if (std::find(corners.begin(), corners.end(), to) != corners.end())
+                continue;
+
+            auto const before = glm::cross(pos[corners[1]] - pos[corners[0]],
+                                           pos[corners[2]] - pos[corners[0]]);
+
+            for (auto& corner : corners)
+                if (corner == from)
+                    corner = to;
+
+            auto const after = glm::cross(pos[corners[1]] - pos[corners[0]],
+                                          pos[corners[2]] - pos[corners[0]]);
+
+            if (glm::dot(before, after) <= 0.f)
+                return true;
+        }
+
+        return false;
+    };
+
+    while (triangles.size() / 3 > target_triangles) {
+        candidates.clear();
+
+        for (auto t = 0u; t < triangles.size(); t += 3) {
+            for (auto k = 0u; k < 3; ++k) {
+                auto const a = triangles[t + k];
+                auto const b = triangles[t + (k + 1) % 3];
+                // interior edges are visited from both sides
+                if (a > b && edge_usage[edge_key(a, b)] > 1)
+                    continue;
+
+                auto q = quadrics[a];
+                q.add(quadrics[b]);
+
+                auto const cost_ab = q.error(pos[b]);
+                auto const cost_ba = q.error(pos[a]);
+
+                if (cost_ab <= cost_ba)
+                    candidates.push_back({a, b, cost_ab});
+                else
+                    candidates.push_back({b, a, cost_ba});
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](collapse_candidate const& l, collapse_candidate const& r) {
+                      return l.cost < r.cost;
+                  });
+
+        adjacency_offsets.assign(vertex_count + 1, 0);
+        for (auto const v : triangles)
+            ++adjacency_offsets[v + 1];
+        for (auto v = 0u; v < vertex_count; ++v)
+            adjacency_offsets[v + 1] += adjacency_offsets[v];
+
+        adjacency.resize(triangles.size());
+        {
+            auto fill = adjacency_offsets;
+            for (auto i = 0u; i < triangles.size(); ++i)
+                adjacency[fill[triangles[i]]++] = i / 3;
+        }
+
+        locked.assign(vertex_count, false);
+
+        auto triangle_count = triangles.size() / 3;
+        auto collapses = 0u;
+
+        for (auto const& candidate : candidates) {
+            if (candidate.cost > max_error || triangle_count <= target_triangles)
+                break;
+
+            if (locked[candidate.from] || locked[candidate.to])
+                continue;
+
+            if (flips(candidate.from, candidate.to))
+                continue;
+
+            for (auto a = adjacency_offsets[candidate.from];
+                 a < adjacency_offsets[candidate.from + 1]; ++a) {
+                auto const t = adjacency[a] * 3;
+                for (auto k = 0u; k < 3; ++k) {
+                    if (find(triangles[t + k]) == candidate.to) {
+                        --triangle_count;
+                        break;
+                    }
+                }
+            }
+
+            collapse[candidate.from] = candidate.to;
+            quadrics[candidate.to].add(quadrics[candidate.from]);
+
+            locked[candidate.from] = true;
+            locked[candidate.to] = true;
+
+            reached_error = std::max(reached_error, candidate.cost);
+            ++collapses;
+        }
+
+        if (collapses == 0)
+            break;
+
+        index_list remaining;
+        remaining.reserve(triangles.size());
+        for (auto t = 0u; t < triangles.size(); t += 3) {
+            auto const a = find(triangles[t]);
+            auto const b = find(triangles[t + 1]);
+            auto const c = find(triangles[t + 2]);
+
+            if (a == b || b == c || a == c)
+                continue;
+
+            remaining.insert(remaining.end(), {a, b, c});
+        }
+
+        triangles = std::move(remaining);
+
+        edge_usage.clear();
+        for (auto t = 0u; t < triangles.size(); t += 3)
+            for (auto k = 0u; k < 3; ++k)
+                ++edge_usage[edge_key(triangles[t + k], triangles[t + (k + 1) % 3])];
+    }
+
+    // map back to original vertices, keep attributes where vertex survived
+
+    index_list result;
+    result.reserve(triangles.size());
+
+    for (auto i = 0u; i < indices.size(); i += 3) {
+        std::array<index, 3> corners{};
+
+        for (auto k = 0u; k < 3; ++k) {
+            auto const original = indices[i + k];
+            auto const canonical = weld[original];
+            auto const target = find(canonical);
+            corners[k] = target == canonical ? original : target;
+        }
+
+        if (find(weld[corners[0]]) == find(weld[corners[1]])
+            || find(weld[corners[1]]) == find(weld[corners[2]])
+            || find(weld[corners[0]]) == find(weld[corners[2]]))
+            continue;
+
+        result.insert(result.end(), corners.begin(), corners.end());
+    }
+
+    if (result_error)
+        *result_error = to_r32(std::sqrt(reached_error));
+
+    return result;
+}
+
+} // namespace lava
@@ -0,0 +1,138 @@
+/**
+ * @file         liblava/resource/mesh_lod.hpp
+ * @brief        Mesh simplification and level of detail
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief Simplify triangle indices with quadric error edge collapses
+ * @param positions             List of vertex positions
+ * @param indices               List of triangle indices
+ * @param target_index_count    Target number of indices
+ * @param target_error          Maximal error (relative to mesh extent)
+ * @param result_error          Reached error (relative to mesh extent)
+ * @return index_list           Simplified indices (referencing the same vertices)
+ */
+index_list simplify_mesh_indices(std::vector<v3> const& positions,
+                                 index_list const& indices,
+                                 size_t target_index_count,
+                                 r32 target_error = 0.02f,
+                                 r32* result_error = nullptr);
+
+/**
+ * @brief Get the extent (largest bounds axis) of positions
+ * @param positions    List of vertex positions
+ * @return r32         Mesh extent
+ */
+r32 calc_mesh_extent(std::vector<v3> const& positions);
+
+/**
+ * @brief Generate a lod chain into mesh data
+ *
+ * Each lod is simplified from full detail, so its error is measured
+ * against full detail (never below the error of finer lods).
+ *
+ * @tparam T           Vertex struct with position
+ * @param data         Mesh data (indices are extended with all lods)
+ * @param lod_count    Maximal number of lods (including full detail)
+ * @param reduction    Triangle ratio per lod step
+ * @param max_error    Maximal error per lod step (relative to mesh extent)
+ * @return ui32        Number of generated lods
+ */
+template <typename T>
+ui32 generate_mesh_lods(mesh_template_data<T>& data,
+                        ui32 lod_count = 4,
+                        r32 reduction = 0.5f,
+                        r32 max_error = 0.02f) {
+    if (data.vertices.empty())
+        return 0;
+
+    index_list full_detail;
+    if (!data.lods.empty()) {
+        auto const& base = data.lods.front();
+        full_detail.assign(data.indices.begin() + base.first_index,
+                           data.indices.begin() + base.first_index + base.index_count);
+    } else if (data.indices.empty()) {
+        full_detail.resize(data.vertices.size());
+        for (auto i = 0u; i < full_detail.size(); ++i)
+            full_detail[i] = i;
+    } else {
+        full_detail = data.indices;
+    }
+
+    std::vector<v3> positions;
+    positions.reserve(data.vertices.size());
+    for (auto const& vertex : data.vertices)
+        positions.emplace_back(vertex.position[0],
+                               vertex.position[1],
+                               vertex.position[2]);
+
+    auto const extent = calc_mesh_extent(positions);
+
+    data.indices = full_detail;
+    data.lods.clear();
+    data.lods.push_back({0, to_ui32(full_detail.size()), 0.f});
+
+    auto const base_triangle_count = to_r32(full_detail.size() / 3);
+    auto previous_count = full_detail.size();
+    auto ratio = 1.f;
+    auto error = 0.f;
+
+    for (auto l = 1u; l < lod_count; ++l) {
+        ratio *= reduction;
+        auto const target = to_size_t(base_triangle_count * ratio) * 3;
+
+        auto lod_error = 0.f;
+        auto next = simplify_mesh_indices(positions,
+                                          full_detail,
+                                          target,
+                                          max_error * to_r32(l),
+                                          &lod_error);
+
+        // stop if the lod would not save enough
+        if (next.empty() || to_r32(next.size()) > to_r32(previous_count) * 0.95f)
+            break;
+
+        error = std::max(error, lod_error * extent);
+
+        data.lods.push_back({to_index(data.indices.size()),
+                             to_ui32(next.size()),
+                             error});
+
+        data.indices.insert(data.indices.end(), next.begin(), next.end());
+        previous_count = next.size();
+    }
+
+    return to_ui32(data.lods.size());
+}
+
+/**
+ * @brief Select the coarsest lod within a projected error threshold
+ * @param lods                List of lods
+ * @param pixels_per_unit     Projected pixels per mesh unit at object distance
+ * @param pixel_threshold     Maximal projected error in pixels
+ * @return index              Index of lod
+ */
+inline index select_mesh_lod(mesh_lod::list const& lods,
+                             r32 pixels_per_unit,
+                             r32 pixel_threshold = 1.f) {
+    index result = 0;
+
+    for (auto i = 0u; i < lods.size(); ++i) {
+        if (lods[i].error * pixels_per_unit > pixel_threshold)
+            break;
+
+        result = i;
+    }
+
+    return result;
+}
+
+} // namespace lava
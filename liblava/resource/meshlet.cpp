@@ -0,0 +1,291 @@
+/**
+ * @file         liblava/resource/meshlet.cpp
+ * @brief        Meshlet builder and cluster culling
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/meshlet.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+namespace {
+
+/// Unused meshlet local vertex slot (local 255 is valid with 256 vertices)
+constexpr ui16 const no_local = 0xffff;
+
+/**
+ * @brief Calculate bounding sphere and normal cone of meshlet
+ * @param result       Target meshlet
+ * @param data         Meshlet data
+ * @param positions    List of vertex positions
+ */
+void calc_meshlet_bounds(meshlet& result,
+                         meshlet_data const& data,
+                         std::vector<v3> const& positions) {
+    auto min = positions[data.vertices[result.vertex_offset]];
+    auto max = min;
+    for (auto v = 0u; v < result.vertex_count; ++v) {
+        auto const& p = positions[data.vertices[result.vertex_offset + v]];
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    result.center = (min + max) * 0.5f;
+    result.radius = 0.f;
+    for (auto v = 0u; v < result.vertex_count; ++v)
+        result.radius = std::max(result.radius,
+                                 glm::length(positions[data.vertices[result.vertex_offset + v]]
+                                             - result.center));
+
+    std::vector<v3> normals;
+    normals.reserve(result.triangle_count);
+
+    auto axis = v3(0.f);
+    for (auto t = 0u; t < result.triangle_count; ++t) {
+        auto const base = (result.triangle_offset + t) * 3;
+        auto const& p0 = positions[data.vertices[result.vertex_offset + data.triangles[base]]];
+        auto const& p1 = positions[data.vertices[result.vertex_offset + data.triangles[base + 1]]];
+        auto const& p2 = positions[data.vertices[result.vertex_offset + data.triangles[base + 2]]];
+
+        auto const normal = glm::cross(p1 - p0, p2 - p0);
+        auto const length = glm::length(normal);
+        if (length <= 0.f)
+            continue;
+
+        normals.push_back(normal / length);
+        axis += normals.back();
+    }
+
+    result.cone_axis = v3(0.f);
+    result.cone_cutoff = 1.f;
+
+    auto const axis_length = glm::length(axis);
+    if (normals.empty() || axis_length <= 0.f)
+        return;
+
+    axis /= axis_length;
+
+    auto min_dot = 1.f;
+    for (auto const& normal : normals)
+        min_dot = std::min(min_dot, glm::dot(normal, axis));
+
+    result.cone_axis = axis;
+
+    // cone wider than a hemisphere can not be culled
+    if (min_dot <= 0.f)
+        return;
+
+    result.cone_cutoff = std::sqrt(1.f - min_dot * min_dot);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+meshlet_data build_meshlets(std::vector<v3> const& positions,
+                            index_list const& indices,
+                            ui32 max_vertices,
+                            ui32 max_triangles) {
+    meshlet_data result;
+
+    LAVA_ASSERT(max_vertices >= 3 && max_vertices <= 256);
+    LAVA_ASSERT(max_triangles >= 1);
+
+    auto const triangle_count = indices.size() / 3;
+    if (triangle_count == 0)
+        return result;
+
+    auto const vertex_count = positions.size();
+
+    // vertex to triangle adjacency
+
+    index_list adjacency_offsets(vertex_count + 1, 0);
+    for (auto const v : indices)
+        ++adjacency_offsets[v + 1];
+    for (auto v = 0u; v < vertex_count; ++v)
+        adjacency_offsets[v + 1] += adjacency_offsets[v];
+
+    index_list adjacency(indices.size());
+    {
+        auto fill = adjacency_offsets;
+        for (auto i = 0u; i < indices.size(); ++i)
+            adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<ui16> local(vertex_count, no_local);
+
+    meshlet current;
+    auto scan = 0u;
+
+    auto finish = [&]() {
+        if (current.triangle_count == 0)
+            return;
+
+        for (auto v = 0u; v < current.vertex_count; ++v)
+            local[result.vertices[current.vertex_offset + v]] = no_local;
+
+        calc_meshlet_bounds(current, result, positions);
+        result.meshlets.push_back(current);
+
+        current = {};
+        current.vertex_offset = to_ui32(result.vertices.size());
+        current.triangle_offset = to_ui32(result.triangles.size() / 3);
+    };
+
+    auto new_vertices = [&](index t) {
+        auto count = 0u;
+        for (auto k = 0u; k < 3; ++k)
+            if (local[indices[t * 3 + k]] == no_local)
+                ++count;
+        return count;
+    };
+
+    for (auto emitted_count = 0u; emitted_count < triangle_count; ++emitted_count) {
+        // prefer adjacent triangles with the fewest new vertices
+        auto best = no_index;
+        auto best_new = 4u;
+
+        for (auto v = 0u; v < current.vertex_count && best_new > 0; ++v) {
+            auto const vertex = result.vertices[current.vertex_offset + v];
+
+            for (auto a = adjacency_offsets[vertex]; a < adjacency_offsets[vertex + 1]; ++a) {
+                auto const t = adjacency[a];
+                if (emitted[t])
+                    continue;
+
+                auto const count = new_vertices(t);
+                if (count < best_new) {
+                    best = t;
+                    best_new = count;
+                }
+            }
+        }
+
+        if (best == no_index) {
+            while (emitted[scan])
+                ++scan;
+
+            best = scan;
+            best_new = new_vertices(best);
+        }
+
+        if (current.vertex_count + best_new > max_vertices
+            || current.triangle_count + 1 > max_triangles) {
+            finish();
+            best_new = new_vertices(best);
+        }
+
+        for (auto k = 0u; k < 3; ++k) {
+            auto const vertex = indices[best * 3 + k];
+
+            if (local[vertex] == no_local) {
+                local[vertex] = static_cast<ui16>(current.vertex_count++);
+                result.vertices.push_back(vertex);
+            }
+
+            result.triangles.push_back(static_cast<ui8>(local[vertex]));
+        }
+
+        ++current.triangle_count;
+        emitted[best] = true;
+    }
+
+    finish();
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+index_list cull_meshlets(meshlet_data const& data,
+                         mat4 const& view_projection,
+                         v3 camera_position) {
+    auto const planes = extract_frustum_planes(view_projection);
+
+    index_list result;
+    result.reserve(data.meshlets.size());
+
+    for (auto i = 0u; i < data.meshlets.size(); ++i) {
+        auto const& m = data.meshlets[i];
+
+        if (!sphere_in_frustum(planes, m.center, m.radius))
+            continue;
+
+        auto const view = m.center - camera_position;
+        if (glm::dot(view, m.cone_axis)
+            >= m.cone_cutoff * glm::length(view) + m.radius)
+            continue;
+
+        result.push_back(i);
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool meshlet_buffers::create(device::ptr device,
+                             meshlet_data const& data,
+                             VmaMemoryUsage memory_usage) {
+    if (data.meshlets.empty())
+        return false;
+
+    std::vector<meshlet_gpu> gpu_meshlets;
+    gpu_meshlets.reserve(data.meshlets.size());
+    for (auto const& m : data.meshlets)
+        gpu_meshlets.push_back({
+            .sphere = v4(m.center, m.radius),
+            .cone = v4(m.cone_axis, m.cone_cutoff),
+            .vertex_offset = m.vertex_offset,
+            .triangle_offset = m.triangle_offset,
+            .vertex_count = m.vertex_count,
+            .triangle_count = m.triangle_count,
+        });
+
+    auto triangles = data.triangles;
+    triangles.resize(align_up(triangles.size(), sizeof(ui32)), 0);
+
+    meshlets = buffer::make();
+    if (!meshlets->create(device,
+                          gpu_meshlets.data(),
+                          sizeof(meshlet_gpu) * gpu_meshlets.size(),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          false,
+                          memory_usage)) {
+        logger()->error("create meshlet buffer");
+        return false;
+    }
+
+    vertices = buffer::make();
+    if (!vertices->create(device,
+                          data.vertices.data(),
+                          sizeof(index) * data.vertices.size(),
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          false,
+                          memory_usage)) {
+        logger()->error("create meshlet vertex buffer");
+        return false;
+    }
+
+    this->triangles = buffer::make();
+    if (!this->triangles->create(device,
+                                 triangles.data(),
+                                 triangles.size(),
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 false,
+                                 memory_usage)) {
+        logger()->error("create meshlet triangle buffer");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void meshlet_buffers::destroy() {
+    meshlets = nullptr;
+    vertices = nullptr;
+    triangles = nullptr;
+}
+
+} // namespace lava
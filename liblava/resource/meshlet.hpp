@@ -0,0 +1,178 @@
+/**
+ * @file         liblava/resource/meshlet.hpp
+ * @brief        Meshlet builder and cluster culling
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/// Maximal number of vertices per meshlet
+constexpr ui32 const meshlet_max_vertices = 64;
+
+/// Maximal number of triangles per meshlet
+constexpr ui32 const meshlet_max_triangles = 124;
+
+/**
+ * @brief Meshlet (cluster of triangles)
+ */
+struct meshlet {
+    /// List of meshlets
+    using list = std::vector<meshlet>;
+
+    /// Offset in meshlet vertex list
+    ui32 vertex_offset = 0;
+
+    /// Offset in meshlet triangle list (in triangles)
+    ui32 triangle_offset = 0;
+
+    /// Number of vertices
+    ui32 vertex_count = 0;
+
+    /// Number of triangles
+    ui32 triangle_count = 0;
+
+    /// Bounding sphere center
+    v3 center = v3(0.f);
+
+    /// Bounding sphere radius
+    r32 radius = 0.f;
+
+    /// Normal cone axis
+    v3 cone_axis = v3(0.f);
+
+    /// Normal cone cutoff (1: cone can not be culled)
+    r32 cone_cutoff = 1.f;
+};
+
+/**
+ * @brief Meshlet data of a mesh
+ */
+struct meshlet_data {
+    /// List of meshlets
+    meshlet::list meshlets;
+
+    /// Meshlet local vertices (index into mesh vertices)
+    index_list vertices;
+
+    /// Meshlet local triangles (3 local vertex indices each)
+    std::vector<ui8> triangles;
+};
+
+/**
+ * @brief Build meshlets from triangle indices
+ * @param positions           List of vertex positions
+ * @param indices             List of triangle indices
+ * @param max_vertices        Maximal vertices per meshlet (<= 256)
+ * @param max_triangles       Maximal triangles per meshlet
+ * @return meshlet_data       Meshlets with bounds
+ */
+meshlet_data build_meshlets(std::vector<v3> const& positions,
+                            index_list const& indices,
+                            ui32 max_vertices = meshlet_max_vertices,
+                            ui32 max_triangles = meshlet_max_triangles);
+
+/**
+ * @brief Build meshlets from mesh data (first lod)
+ * @tparam T                  Vertex struct with position
+ * @param data                Mesh data
+ * @param max_vertices        Maximal vertices per meshlet (<= 256)
+ * @param max_triangles       Maximal triangles per meshlet
+ * @return meshlet_data       Meshlets with bounds
+ */
+template <typename T>
+meshlet_data build_meshlets(mesh_template_data<T> const& data,
+                            ui32 max_vertices = meshlet_max_vertices,
+                            ui32 max_triangles = meshlet_max_triangles) {
+    std::vector<v3> positions;
+    positions.reserve(data.vertices.size());
+    for (auto const& vertex : data.vertices)
+        positions.emplace_back(vertex.position[0],
+                               vertex.position[1],
+                               vertex.position[2]);
+
+    index_list indices;
+    if (!data.lods.empty())
+        indices.assign(data.indices.begin() + data.lods.front().first_index,
+                       data.indices.begin() + data.lods.front().first_index
+                           + data.lods.front().index_count);
+    else if (!data.indices.empty())
+        indices = data.indices;
+    else
+        for (auto i = 0u; i < data.vertices.size(); ++i)
+            indices.push_back(i);
+
+    return build_meshlets(positions, indices, max_vertices, max_triangles);
+}
+
+/**
+ * @brief Cull meshlets against frustum and normal cones
+ * @param data               Meshlet data
+ * @param view_projection    View projection matrix (object to clip space)
+ * @param camera_position    Camera position (object space)
+ * @return index_list        List of visible meshlets
+ */
+index_list cull_meshlets(meshlet_data const& data,
+                         mat4 const& view_projection,
+                         v3 camera_position);
+
+/**
+ * @brief Meshlet in storage buffer layout (std430)
+ */
+struct meshlet_gpu {
+    /// Bounding sphere (xyz: center, w: radius)
+    v4 sphere;
+
+    /// Normal cone (xyz: axis, w: cutoff)
+    v4 cone;
+
+    /// Offset in vertex buffer
+    ui32 vertex_offset;
+
+    /// Offset in triangle buffer (in triangles)
+    ui32 triangle_offset;
+
+    /// Number of vertices
+    ui32 vertex_count;
+
+    /// Number of triangles
+    ui32 triangle_count;
+};
+
+static_assert(sizeof(meshlet_gpu) == 48);
+
+/**
+ * @brief Meshlet storage buffers
+ */
+struct meshlet_buffers {
+    /// Meshlets (meshlet_gpu)
+    buffer::s_ptr meshlets;
+
+    /// Meshlet local vertices (ui32)
+    buffer::s_ptr vertices;
+
+    /// Meshlet local triangles (ui8, padded to ui32)
+    buffer::s_ptr triangles;
+
+    /**
+     * @brief Create the storage buffers
+     * @param device          Vulkan device
+     * @param data            Meshlet data
+     * @param memory_usage    Memory usage
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                meshlet_data const& data,
+                VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+    /**
+     * @brief Destroy the storage buffers
+     */
+    void destroy();
+};
+
+} // namespace lava
@@ -0,0 +1,366 @@
+/**
+ * @file         liblava/resource/quantized_mesh.hpp
+ * @brief        Quantized vertex formats
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "glm/gtc/packing.hpp"
+#include "liblava/resource/mesh.hpp"
+
+namespace lava {
+
+/**
+ * @brief Position encodings of quantized vertices
+ */
+enum class position_encoding : index {
+    snorm16 = 0, ///< normalized to mesh bounds, needs dequant transform
+    half,        ///< 16 bit float, no dequant transform needed
+};
+
+/**
+ * @brief Pack float to 16 bit signed normalized
+ * @param value    Value in range [-1, 1]
+ * @return i16     Packed value
+ */
+inline i16 pack_snorm16(r32 value) {
+    return static_cast<i16>(std::round(glm::clamp(value, -1.f, 1.f) * 32767.f));
+}
+
+/**
+ * @brief Unpack 16 bit signed normalized to float
+ * @param value    Packed value
+ * @return r32     Value in range [-1, 1]
+ */
+inline r32 unpack_snorm16(i16 value) {
+    return glm::max(to_r32(value) / 32767.f, -1.f);
+}
+
+/**
+ * @brief Pack float to 16 bit unsigned normalized
+ * @param value    Value in range [0, 1]
+ * @return ui16    Packed value
+ */
+inline ui16 pack_unorm16(r32 value) {
+    return static_cast<ui16>(std::round(glm::clamp(value, 0.f, 1.f) * 65535.f));
+}
+
+/**
+ * @brief Unpack 16 bit unsigned normalized to float
+ * @param value    Packed value
+ * @return r32     Value in range [0, 1]
+ */
+inline r32 unpack_unorm16(ui16 value) {
+    return to_r32(value) / 65535.f;
+}
+
+/**
+ * @brief Encode unit vector with octahedral mapping
+ * @param normal    Unit vector
+ * @return v2       Octahedral coordinates in range [-1, 1]
+ */
+inline v2 oct_encode(v3 normal) {
+    auto const sum = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+    if (sum == 0.f)
+        return v2(0.f);
+
+    normal /= sum;
+
+    if (normal.z >= 0.f)
+        return {normal.x, normal.y};
+
+    return {(1.f - glm::abs(normal.y)) * (normal.x >= 0.f ? 1.f : -1.f),
+            (1.f - glm::abs(normal.x)) * (normal.y >= 0.f ? 1.f : -1.f)};
+}
+
+/**
+ * @brief Decode octahedral mapped unit vector
+ * @param value    Octahedral coordinates in range [-1, 1]
+ * @return v3      Unit vector
+ */
+inline v3 oct_decode(v2 value) {
+    v3 normal{value.x, value.y, 1.f - glm::abs(value.x) - glm::abs(value.y)};
+
+    auto const t = glm::max(-normal.z, 0.f);
+    normal.x += normal.x >= 0.f ? -t : t;
+    normal.y += normal.y >= 0.f ? -t : t;
+
+    return glm::normalize(normal);
+}
+
+/**
+ * @brief Dequantization transform of mesh positions and uvs
+ */
+struct quantize_transform {
+    /// Center of mesh bounds
+    v3 offset = v3(0.f);
+
+    /// Half extent of mesh bounds
+    v3 scale = v3(1.f);
+
+    /// Minimum of uv bounds (uvs outside [0, 1])
+    v2 uv_offset = v2(0.f);
+
+    /// Extent of uv bounds (uvs outside [0, 1])
+    v2 uv_scale = v2(1.f);
+
+    /**
+     * @brief Get the dequantization matrix (pre-multiply with model)
+     * @return mat4    Dequantization matrix
+     */
+    mat4 get_matrix() const {
+        return glm::scale(glm::translate(mat4(1.f), offset), scale);
+    }
+
+    /**
+     * @brief Get the uv dequantization: uv * scale (xy) + offset (zw)
+     * @return v4    UV transform
+     */
+    v4 get_uv_transform() const {
+        return v4(uv_scale, uv_offset);
+    }
+};
+
+/**
+ * @brief Quantized vertex (16 bytes)
+ */
+struct quantized_vertex {
+    /// List of quantized vertices
+    using list = std::vector<quantized_vertex>;
+
+    /// Vertex position (snorm16 or half, w unused)
+    std::array<ui16, 4> position{};
+
+    /// Vertex uv (unorm16 in uv bounds)
+    std::array<ui16, 2> uv{};
+
+    /// Vertex normal (octahedral snorm16)
+    std::array<i16, 2> normal{};
+
+    /**
+     * @brief Get the vertex input binding description
+     * @param binding                              Binding index
+     * @return VkVertexInputBindingDescription    Binding description
+     */
+    static VkVertexInputBindingDescription binding_description(ui32 binding = 0) {
+        return {binding, sizeof(quantized_vertex), VK_VERTEX_INPUT_RATE_VERTEX};
+    }
+
+    /**
+     * @brief Get the vertex input attribute descriptions
+     * @param encoding                               Position encoding
+     * @param binding                                Binding index
+     * @return VkVertexInputAttributeDescriptions    List of attribute descriptions
+     */
+    static VkVertexInputAttributeDescriptions attribute_descriptions(position_encoding encoding = position_encoding::snorm16,
+                                                                     ui32 binding = 0) {
+        auto const position_format = encoding == position_encoding::half
+                                         ? VK_FORMAT_R16G16B16A16_SFLOAT
+                                         : VK_FORMAT_R16G16B16A16_SNORM;
+        return {
+            {0, binding, position_format, to_ui32(offsetof(quantized_vertex, position))},
+            {1, binding, VK_FORMAT_R16G16_UNORM, to_ui32(offsetof(quantized_vertex, uv))},
+            {2, binding, VK_FORMAT_R16G16_SNORM, to_ui32(offsetof(quantized_vertex, normal))},
+        };
+    }
+};
+
+/**
+ * @brief Quantized vertex with color (20 bytes)
+ */
+struct quantized_color_vertex {
+    /// List of quantized color vertices
+    using list = std::vector<quantized_color_vertex>;
+
+    /// Vertex position (snorm16 or half, w unused)
+    std::array<ui16, 4> position{};
+
+    /// Vertex uv (unorm16 in uv bounds)
+    std::array<ui16, 2> uv{};
+
+    /// Vertex normal (octahedral snorm16)
+    std::array<i16, 2> normal{};
+
+    /// Vertex color (unorm8)
+    std::array<ui8, 4> color{};
+
+    /**
+     * @brief Get the vertex input binding description
+     * @param binding                              Binding index
+     * @return VkVertexInputBindingDescription    Binding description
+     */
+    static VkVertexInputBindingDescription binding_description(ui32 binding = 0) {
+        return {binding, sizeof(quantized_color_vertex), VK_VERTEX_INPUT_RATE_VERTEX};
+    }
+
+    /**
+     * @brief Get the vertex input attribute descriptions
+     * @param encoding                               Position encoding
+     * @param binding                                Binding index
+     * @return VkVertexInputAttributeDescriptions    List of attribute descriptions
+     */
+    static VkVertexInputAttributeDescriptions attribute_descriptions(position_encoding encoding = position_encoding::snorm16,
+                                                                     ui32 binding = 0) {
+        auto const position_format = encoding == position_encoding::half
+                                         ? VK_FORMAT_R16G16B16A16_SFLOAT
+                                         : VK_FORMAT_R16G16B16A16_SNORM;
+        return {
+            {0, binding, position_format, to_ui32(offsetof(quantized_color_vertex, position))},
+            {1, binding, VK_FORMAT_R16G16_UNORM, to_ui32(offsetof(quantized_color_vertex, uv))},
+            {2, binding, VK_FORMAT_R16G16_SNORM, to_ui32(offsetof(quantized_color_vertex, normal))},
+            {3, binding, VK_FORMAT_R8G8B8A8_UNORM, to_ui32(offsetof(quantized_color_vertex, color))},
+        };
+    }
+};
+
+static_assert(sizeof(quantized_vertex) == 16);
+static_assert(sizeof(quantized_color_vertex) == 20);
+
+/**
+ * @brief Quantized mesh data with dequantization transform
+ * @tparam T    Quantized vertex struct
+ */
+template <typename T = quantized_vertex>
+struct quantized_mesh_template_data : mesh_template_data<T> {
+    /// Position encoding
+    position_encoding encoding = position_encoding::snorm16;
+
+    /// Dequantization transform (positions: identity for half)
+    quantize_transform transform;
+};
+
+/**
+ * @brief Quantize mesh data
+ * @tparam T                                  Quantized vertex struct
+ * @param source                              Source mesh data
+ * @param encoding                            Position encoding
+ * @return quantized_mesh_template_data<T>    Quantized mesh data
+ */
+template <typename T = quantized_vertex>
+quantized_mesh_template_data<T> quantize_mesh_data(mesh_data const& source,
+                                                   position_encoding encoding = position_encoding::snorm16) {
+    quantized_mesh_template_data<T> result;
+    result.encoding = encoding;
+    result.indices = source.indices;
+    result.lods = source.lods;
+
+    if (source.vertices.empty())
+        return result;
+
+    if (encoding == position_encoding::snorm16) {
+        auto min = source.vertices.front().position;
+        auto max = min;
+        for (auto const& vertex : source.vertices) {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+
+        result.transform.offset = (min + max) * 0.5f;
+        result.transform.scale = glm::max((max - min) * 0.5f, v3(1e-8f));
+    }
+
+    // uvs in [0, 1] keep the identity transform
+    auto uv_min = source.vertices.front().uv;
+    auto uv_max = uv_min;
+    for (auto const& vertex : source.vertices) {
+        uv_min = glm::min(uv_min, vertex.uv);
+        uv_max = glm::max(uv_max, vertex.uv);
+    }
+
+    if (glm::any(glm::lessThan(uv_min, v2(0.f)))
+        || glm::any(glm::greaterThan(uv_max, v2(1.f)))) {
+        result.transform.uv_offset = uv_min;
+        result.transform.uv_scale = glm::max(uv_max - uv_min, v2(1e-8f));
+    }
+
+    result.vertices.resize(source.vertices.size());
+
+    for (auto i = 0u; i < source.vertices.size(); ++i) {
+        auto const& src = source.vertices[i];
+        auto& dst = result.vertices[i];
+
+        for (auto c = 0u; c < 3; ++c) {
+            if (encoding == position_encoding::half)
+                dst.position[c] = glm::packHalf1x16(src.position[c]);
+            else
+                dst.position[c] = static_cast<ui16>(pack_snorm16((src.position[c] - result.transform.offset[c])
+                                                                 / result.transform.scale[c]));
+        }
+
+        dst.position[3] = encoding == position_encoding::half
+                              ? glm::packHalf1x16(1.f)
+                              : static_cast<ui16>(pack_snorm16(1.f));
+
+        auto const uv = (src.uv - result.transform.uv_offset) / result.transform.uv_scale;
+        dst.uv = {pack_unorm16(uv.x), pack_unorm16(uv.y)};
+
+        auto const oct = oct_encode(src.normal);
+        dst.normal = {pack_snorm16(oct.x), pack_snorm16(oct.y)};
+
+        if constexpr (requires { dst.color; }) {
+            for (auto c = 0u; c < 4; ++c)
+                dst.color[c] = static_cast<ui8>(std::round(glm::clamp(src.color[c], 0.f, 1.f) * 255.f));
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Dequantize mesh data (round trip on CPU)
+ * @tparam T              Quantized vertex struct
+ * @param source          Quantized mesh data
+ * @return mesh_data      Mesh data with default vertex
+ */
+template <typename T>
+mesh_data dequantize_mesh_data(quantized_mesh_template_data<T> const& source) {
+    mesh_data result;
+    result.indices = source.indices;
+    result.lods = source.lods;
+    result.vertices.resize(source.vertices.size());
+
+    for (auto i = 0u; i < source.vertices.size(); ++i) {
+        auto const& src = source.vertices[i];
+        auto& dst = result.vertices[i];
+
+        for (auto c = 0u; c < 3; ++c) {
+            if (source.encoding == position_encoding::half)
+                dst.position[c] = glm::unpackHalf1x16(src.position[c]);
+            else
+                dst.position[c] = source.transform.offset[c]
+                                  + unpack_snorm16(static_cast<i16>(src.position[c]))
+                                        * source.transform.scale[c];
+        }
+
+        dst.uv = source.transform.uv_offset
+                 + v2(unpack_unorm16(src.uv[0]), unpack_unorm16(src.uv[1]))
+                       * source.transform.uv_scale;
+        dst.normal = oct_decode({unpack_snorm16(src.normal[0]),
+                                 unpack_snorm16(src.normal[1])});
+
+        if constexpr (requires { src.color; }) {
+            for (auto c = 0u; c < 4; ++c)
+                dst.color[c] = to_r32(src.color[c]) / 255.f;
+        } else {
+            dst.color = v4(1.f);
+        }
+    }
+
+    return result;
+}
+
+/// Quantized mesh data
+using quantized_mesh_data = quantized_mesh_template_data<quantized_vertex>;
+
+/// Quantized mesh
+using quantized_mesh = mesh_template<quantized_vertex>;
+
+/// Quantized mesh data with color
+using quantized_color_mesh_data = quantized_mesh_template_data<quantized_color_vertex>;
+
+/// Quantized mesh with color
+using quantized_color_mesh = mesh_template<quantized_color_vertex>;
+
+} // namespace lava
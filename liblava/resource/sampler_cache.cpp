@@ -0,0 +1,160 @@
+/**
+ * @file         liblava/resource/sampler_cache.cpp
+ * @brief        Shared samplers of a device
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/sampler_cache.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+namespace {
+
+/**
+ * @brief Compare sampler create information
+ * @param a    First create information
+ * @param b    Second create information
+ * @return Create information is equal or not
+ */
+bool equal(VkSamplerCreateInfo const& a,
+           VkSamplerCreateInfo const& b) {
+    return a.flags == b.flags
+           && a.magFilter == b.magFilter
+           && a.minFilter == b.minFilter
+           && a.mipmapMode == b.mipmapMode
+           && a.addressModeU == b.addressModeU
+           && a.addressModeV == b.addressModeV
+           && a.addressModeW == b.addressModeW
+           && a.mipLodBias == b.mipLodBias
+           && a.anisotropyEnable == b.anisotropyEnable
+           && a.maxAnisotropy == b.maxAnisotropy
+           && a.compareEnable == b.compareEnable
+           && a.compareOp == b.compareOp
+           && a.minLod == b.minLod
+           && a.maxLod == b.maxLod
+           && a.borderColor == b.borderColor
+           && a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+void sampler_cache::destroy() {
+    std::lock_guard lock(m_mutex);
+
+    for (auto& item : m_entries)
+        destroy_sampler(item.sampler);
+
+    m_entries.clear();
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+VkSampler sampler_cache::acquire(VkSamplerCreateInfo const& info) {
+    std::lock_guard lock(m_mutex);
+
+    if (!m_device && !on_create)
+        return VK_NULL_HANDLE;
+
+    // chained structs are not compared
+    auto const shared = info.pNext == nullptr;
+
+    if (shared) {
+        for (auto& item : m_entries) {
+            if (item.shared && equal(item.info, info)) {
+                ++item.ref_count;
+                return item.sampler;
+            }
+        }
+    }
+
+    if (m_device
+        && m_entries.size()
+               >= m_device->get_properties().limits.maxSamplerAllocationCount)
+        logger()->warn("sampler cache: {} samplers exceed device limit",
+                       m_entries.size() + 1);
+
+    auto const sampler = create_sampler(info);
+    if (!sampler)
+        return VK_NULL_HANDLE;
+
+    entry item{info, sampler, 1, shared};
+    item.info.pNext = nullptr;
+    m_entries.push_back(item);
+
+    return sampler;
+}
+
+//-----------------------------------------------------------------------------
+void sampler_cache::release(VkSampler sampler) {
+    std::lock_guard lock(m_mutex);
+
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&](entry const& item) {
+                               return item.sampler == sampler;
+                           });
+    if (it == m_entries.end())
+        return;
+
+    if (--it->ref_count > 0)
+        return;
+
+    destroy_sampler(it->sampler);
+    m_entries.erase(it);
+}
+
+//-----------------------------------------------------------------------------
+VkSampler sampler_cache::create_sampler(VkSamplerCreateInfo const& info) {
+    if (on_create)
+        return on_create(info);
+
+    VkSampler result = VK_NULL_HANDLE;
+    if (!m_device->vkCreateSampler(&info, &result))
+        return VK_NULL_HANDLE;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void sampler_cache::destroy_sampler(VkSampler sampler) {
+    if (on_destroy)
+        on_destroy(sampler);
+    else if (m_device)
+        m_device->vkDestroySampler(sampler);
+}
+
+//-----------------------------------------------------------------------------
+size_t sampler_cache::get_count() const {
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+//-----------------------------------------------------------------------------
+size_t sampler_cache::get_reference_count() const {
+    std::lock_guard lock(m_mutex);
+
+    size_t result = 0;
+    for (auto const& item : m_entries)
+        result += item.ref_count;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+sampler_cache::s_ptr get_sampler_cache(device::ptr device) {
+    static std::mutex cache_mutex;
+    std::lock_guard lock(cache_mutex);
+
+    if (auto cache = device->get_sampler_cache())
+        return cache;
+
+    auto cache = sampler_cache::make();
+    cache->create(device);
+
+    device->set_sampler_cache(cache);
+    return cache;
+}
+
+} // namespace lava
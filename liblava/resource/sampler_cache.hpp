@@ -0,0 +1,141 @@
+/**
+ * @file         liblava/resource/sampler_cache.hpp
+ * @brief        Shared samplers of a device
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/base/device.hpp"
+#include <functional>
+#include <mutex>
+
+namespace lava {
+
+/**
+ * @brief Sampler cache
+ *
+ * One sampler per distinct create info, shared by reference count.
+ * Devices limit the number of samplers (maxSamplerAllocationCount),
+ * textures with the same settings get the same sampler. Create infos
+ * with a pNext chain are not compared: each gets its own sampler.
+ */
+struct sampler_cache {
+    /// Shared pointer to sampler cache
+    using s_ptr = std::shared_ptr<sampler_cache>;
+
+    /**
+     * @brief Make a new sampler cache
+     * @return s_ptr    Shared pointer to sampler cache
+     */
+    static s_ptr make() {
+        return std::make_shared<sampler_cache>();
+    }
+
+    /**
+     * @brief Destroy the sampler cache
+     */
+    ~sampler_cache() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new sampler cache
+     * @param device    Vulkan device
+     */
+    void create(device::ptr device) {
+        m_device = device;
+    }
+
+    /**
+     * @brief Destroy all samplers (device must be idle)
+     */
+    void destroy();
+
+    /**
+     * @brief Get a sampler and add a reference
+     * @param info          Sampler create information (pNext: not shared)
+     * @return VkSampler    Shared sampler (or none)
+     */
+    VkSampler acquire(VkSamplerCreateInfo const& info);
+
+    /**
+     * @brief Remove a reference, destroy the sampler when unused
+     * @param sampler    Sampler of cache
+     */
+    void release(VkSampler sampler);
+
+    /**
+     * @brief Get the number of samplers
+     * @return size_t    Number of distinct samplers
+     */
+    size_t get_count() const;
+
+    /**
+     * @brief Get the number of references
+     * @return size_t    Number of references of all samplers
+     */
+    size_t get_reference_count() const;
+
+    /// Create sampler function
+    using create_func = std::function<VkSampler(VkSamplerCreateInfo const&)>;
+
+    /// Called to create a sampler (default: device)
+    create_func on_create;
+
+    /// Destroy sampler function
+    using destroy_func = std::function<void(VkSampler)>;
+
+    /// Called to destroy a sampler (default: device)
+    destroy_func on_destroy;
+
+private:
+    /**
+     * @brief Create a sampler
+     * @param info          Sampler create information
+     * @return VkSampler    Vulkan sampler (or none)
+     */
+    VkSampler create_sampler(VkSamplerCreateInfo const& info);
+
+    /**
+     * @brief Destroy a sampler
+     * @param sampler    Vulkan sampler
+     */
+    void destroy_sampler(VkSampler sampler);
+
+    /**
+     * @brief Sampler in cache
+     */
+    struct entry {
+        /// Sampler create information
+        VkSamplerCreateInfo info = {};
+
+        /// Vulkan sampler
+        VkSampler sampler = VK_NULL_HANDLE;
+
+        /// Number of references
+        ui32 ref_count = 0;
+
+        /// Shared by equal create information (no pNext chain)
+        bool shared = true;
+    };
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// List of samplers
+    std::vector<entry> m_entries;
+
+    /// Cache mutex
+    mutable std::mutex m_mutex;
+};
+
+/**
+ * @brief Get the sampler cache of a device (created on first use)
+ * @param device                  Vulkan device
+ * @return sampler_cache::s_ptr   Shared pointer to sampler cache
+ */
+sampler_cache::s_ptr get_sampler_cache(device::ptr device);
+
+} // namespace lava
@@ -0,0 +1,442 @@
+/**
+ * @file         liblava/resource/staging_ring.cpp
+ * @brief        Staging ring buffer for uploads
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/staging_ring.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+bool staging_ring::create(device::ptr device,
+                          VkDeviceSize size) {
+    m_buffer = buffer::make();
+    if (!m_buffer->create_mapped(device,
+                                 nullptr,
+                                 size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) {
+        logger()->error("create staging ring");
+        m_buffer = nullptr;
+        return false;
+    }
+
+    m_size = size;
+    m_head = 0;
+    m_tail = 0;
+    m_used = 0;
+    m_peak = 0;
+    m_entries.clear();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void staging_ring::destroy() {
+    if (!m_buffer)
+        return;
+
+    collect(true);
+
+    if (m_pool) {
+        m_buffer->get_device()->vkDestroyCommandPool(m_pool);
+        m_pool = VK_NULL_HANDLE;
+    }
+
+    if (!m_entries.empty())
+        logger()->warn("staging ring destroyed with {} allocations in use",
+                       m_entries.size());
+
+    m_entries.clear();
+
+    m_buffer->destroy();
+    m_buffer = nullptr;
+
+    m_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+staging_allocation staging_ring::allocate(VkDeviceSize size,
+                                          VkDeviceSize alignment,
+                                          bool dedicated_if_full) {
+    if (!m_buffer || size == 0)
+        return {};
+
+    collect();
+
+    if (size <= m_size) {
+        std::lock_guard lock(m_mutex);
+
+        if (m_entries.empty()) {
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        auto offset = (m_head + alignment - 1) / alignment * alignment;
+        auto found = false;
+
+        if (m_entries.empty() || m_head > m_tail) {
+            // free: head to end, start to tail
+            if (offset + size <= m_size) {
+                found = true;
+            } else if (size <= m_tail) {
+                offset = 0;
+                found = true;
+            }
+        } else if (m_head < m_tail) {
+            // free: head to tail
+            found = offset + size <= m_tail;
+        }
+
+        if (found) {
+            // wrap pads the end of the ring
+            auto const used = offset >= m_head ? offset + size - m_head
+                                               : m_size - m_head + size;
+
+            m_head = offset + size;
+            m_used += used;
+            m_peak = std::max(m_peak, m_used);
+
+            auto const id = m_next_id++;
+            m_entries.push_back({id, m_head, used});
+
+            return {
+                .buffer = m_buffer->get(),
+                .offset = offset,
+                .size = size,
+                .data = static_cast<data::ptr>(m_buffer->get_mapped_data()) + offset,
+                .id = id,
+            };
+        }
+
+        if (!dedicated_if_full)
+            return {};
+    }
+
+    auto dedicated = buffer::make();
+    if (!dedicated->create_mapped(m_buffer->get_device(),
+                                  nullptr,
+                                  size,
+                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) {
+        logger()->error("create dedicated staging buffer");
+        return {};
+    }
+
+    logger()->trace("dedicated staging buffer: {} bytes", size);
+
+    return {
+        .buffer = dedicated->get(),
+        .offset = 0,
+        .size = size,
+        .data = static_cast<data::ptr>(dedicated->get_mapped_data()),
+        .dedicated = dedicated,
+    };
+}
+
+//-----------------------------------------------------------------------------
+staging_allocation staging_ring::upload(void const* data,
+                                        VkDeviceSize size,
+                                        VkDeviceSize alignment,
+                                        bool dedicated_if_full) {
+    auto result = allocate(size, alignment, dedicated_if_full);
+    if (!result.valid())
+        return result;
+
+    memcpy(result.data, data, size);
+    flush(result);
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void staging_ring::flush(staging_allocation const& allocation) {
+    if (allocation.dedicated)
+        allocation.dedicated->flush(0, allocation.size);
+    else if (allocation.valid())
+        m_buffer->flush(allocation.offset, allocation.size);
+}
+
+//-----------------------------------------------------------------------------
+void staging_ring::release(staging_allocation& allocation) {
+    if (allocation.id != 0) {
+        std::lock_guard lock(m_mutex);
+
+        auto it = std::lower_bound(m_entries.begin(),
+                                   m_entries.end(),
+                                   allocation.id,
+                                   [](entry const& e, ui64 id) {
+                                       return e.id < id;
+                                   });
+        if (it != m_entries.end() && it->id == allocation.id)
+            it->released = true;
+
+        while (!m_entries.empty() && m_entries.front().released) {
+            m_tail = m_entries.front().end;
+            m_used -= m_entries.front().used;
+
+            m_entries.pop_front();
+        }
+    }
+
+    allocation = {};
+}
+
+//-----------------------------------------------------------------------------
+bool staging_ring::submit(buffer_upload::list& uploads) {
+    if (uploads.empty())
+        return true;
+
+    if (!m_buffer)
+        return false;
+
+    auto device = m_buffer->get_device();
+    auto const& queue = device->graphics_queue();
+
+    std::lock_guard lock(m_submit_mutex);
+
+    if (!m_pool) {
+        VkCommandPoolCreateInfo const pool_info{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = to_ui32(queue.family),
+        };
+
+        if (!device->vkCreateCommandPool(&pool_info, &m_pool)) {
+            logger()->error("create staging ring command pool");
+            return false;
+        }
+    }
+
+    submission item;
+    if (!device->vkAllocateCommandBuffers(m_pool,
+                                          1,
+                                          &item.cmd_buf,
+                                          VK_COMMAND_BUFFER_LEVEL_PRIMARY))
+        return false;
+
+    VkCommandBufferBeginInfo const begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+
+    if (!check(device->call().vkBeginCommandBuffer(item.cmd_buf,
+                                                   &begin_info))) {
+        device->vkFreeCommandBuffers(m_pool, 1, &item.cmd_buf);
+        return false;
+    }
+
+    for (auto const& upload : uploads)
+        upload.record(item.cmd_buf);
+
+    device->call().vkEndCommandBuffer(item.cmd_buf);
+
+    VkFenceCreateInfo const fence_info{
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+    };
+
+    if (!device->vkCreateFence(&fence_info, &item.fence)) {
+        device->vkFreeCommandBuffers(m_pool, 1, &item.cmd_buf);
+        return false;
+    }
+
+    VkSubmitInfo const submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &item.cmd_buf,
+    };
+
+    if (!device->vkQueueSubmit(queue.vk_queue, 1, &submit_info, item.fence)) {
+        device->vkDestroyFence(item.fence);
+        device->vkFreeCommandBuffers(m_pool, 1, &item.cmd_buf);
+        return false;
+    }
+
+    item.uploads = std::move(uploads);
+    uploads.clear();
+
+    m_submits.push_back(std::move(item));
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void staging_ring::collect(bool wait) {
+    std::vector<submission> completed;
+
+    {
+        std::lock_guard lock(m_submit_mutex);
+
+        if (m_submits.empty())
+            return;
+
+        auto device = m_buffer->get_device();
+
+        while (!m_submits.empty()) {
+            auto& front = m_submits.front();
+
+            if (wait)
+                device->vkWaitForFences(1, &front.fence, VK_TRUE, UINT64_MAX);
+            else if (device->call().vkGetFenceStatus(device->get(),
+                                                     front.fence)
+                     != VK_SUCCESS)
+                break;
+
+            device->vkDestroyFence(front.fence);
+            device->vkFreeCommandBuffers(m_pool, 1, &front.cmd_buf);
+
+            completed.push_back(std::move(front));
+            m_submits.pop_front();
+        }
+    }
+
+    // ring lock: after submit lock
+    for (auto& item : completed)
+        for (auto& upload : item.uploads)
+            release(upload.source);
+}
+
+//-----------------------------------------------------------------------------
+staging_ring::s_ptr get_staging_ring(device::ptr device) {
+    static std::mutex ring_mutex;
+    std::lock_guard lock(ring_mutex);
+
+    if (auto ring = device->get_staging_ring())
+        return ring;
+
+    auto ring = staging_ring::make();
+    if (!ring->create(device))
+        return nullptr;
+
+    device->set_staging_ring(ring);
+    return ring;
+}
+
+//-----------------------------------------------------------------------------
+void buffer_upload::record(VkCommandBuffer cmd_buf) const {
+    auto device = target->get_device();
+
+    VkBufferCopy const region{
+        .srcOffset = source.offset,
+        .size = size,
+    };
+
+    device->call().vkCmdCopyBuffer(cmd_buf,
+                                   source.buffer,
+                                   target->get(),
+                                   1,
+                                   &region);
+
+    VkBufferMemoryBarrier const barrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = buffer_usage_to_possible_access(usage),
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = target->get(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    auto dst_stages = buffer_usage_to_possible_stages(usage);
+    if (!dst_stages)
+        dst_stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    device->call().vkCmdPipelineBarrier(cmd_buf,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        dst_stages,
+                                        0,
+                                        0, nullptr,
+                                        1, &barrier,
+                                        0, nullptr);
+}
+
+//-----------------------------------------------------------------------------
+buffer::s_ptr create_staged_buffer(device::ptr device,
+                                   void const* data,
+                                   size_t size,
+                                   VkBufferUsageFlags usage,
+                                   buffer_upload::list& uploads) {
+    auto ring = get_staging_ring(device);
+    if (!ring)
+        return nullptr;
+
+    // larger than the ring: dedicated buffer
+    auto source = ring->upload(data, size, 16, size > ring->get_size());
+    if (!source.valid()) {
+        // ring full: submit pending uploads and wait for all in flight
+        if (!uploads.empty() && !ring->submit(uploads))
+            logger()->warn("submit pending buffer uploads failed");
+
+        ring->collect(true);
+
+        source = ring->upload(data, size);
+    }
+
+    if (!source.valid()) {
+        // still held by frames in flight
+        logger()->warn("staging ring full, dedicated staging buffer: {} bytes", size);
+
+        source = ring->upload(data, size, 16, true);
+        if (!source.valid()) {
+            logger()->error("allocate staging memory");
+            return nullptr;
+        }
+    }
+
+    auto target = buffer::make();
+    if (!target->create(device,
+                        nullptr,
+                        size,
+                        usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        false,
+                        VMA_MEMORY_USAGE_GPU_ONLY)) {
+        logger()->error("create staged buffer");
+        ring->release(source);
+        return nullptr;
+    }
+
+    uploads.push_back({source, target, size, usage});
+
+    return target;
+}
+
+//-----------------------------------------------------------------------------
+bool submit_uploads(device::ptr device,
+                    buffer_upload::list& uploads,
+                    bool wait) {
+    if (uploads.empty())
+        return true;
+
+    if (!wait) {
+        auto ring = get_staging_ring(device);
+        if (ring && ring->submit(uploads))
+            return true;
+
+        logger()->warn("submit buffer uploads without wait failed, waiting");
+    }
+
+    auto const result = one_time_submit(device,
+                                        device->graphics_queue(),
+                                        [&](VkCommandBuffer cmd_buf) {
+                                            for (auto const& upload : uploads)
+                                                upload.record(cmd_buf);
+                                        });
+    if (!result) {
+        logger()->error("submit buffer uploads");
+
+        // staging memory may still be read
+        device->wait_for_idle();
+    }
+
+    if (auto ring = get_staging_ring(device))
+        for (auto& upload : uploads)
+            ring->release(upload.source);
+
+    uploads.clear();
+
+    return result;
+}
+
+} // namespace lava
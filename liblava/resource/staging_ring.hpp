@@ -0,0 +1,323 @@
+/**
+ * @file         liblava/resource/staging_ring.hpp
+ * @brief        Staging ring buffer for uploads
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/buffer.hpp"
+#include <deque>
+#include <mutex>
+
+namespace lava {
+
+/// Default size of staging ring
+constexpr VkDeviceSize const default_staging_ring_size = 64 * 1024 * 1024;
+
+/**
+ * @brief Host visible staging memory
+ */
+struct staging_allocation {
+    /// List of staging allocations
+    using list = std::vector<staging_allocation>;
+
+    /// Source buffer
+    VkBuffer buffer = VK_NULL_HANDLE;
+
+    /// Offset in source buffer
+    VkDeviceSize offset = 0;
+
+    /// Size of allocation
+    VkDeviceSize size = 0;
+
+    /// Mapped data
+    data::ptr data = nullptr;
+
+    /// Ring allocation id (0: dedicated)
+    ui64 id = 0;
+
+    /// Dedicated buffer (larger than ring)
+    buffer::s_ptr dedicated;
+
+    /**
+     * @brief Check if allocation is valid
+     * @return Allocation is valid or not
+     */
+    bool valid() const {
+        return buffer != VK_NULL_HANDLE;
+    }
+};
+
+/**
+ * @brief Staged upload into a device local buffer
+ */
+struct buffer_upload {
+    /// List of buffer uploads
+    using list = std::vector<buffer_upload>;
+
+    /// Host visible staging memory
+    staging_allocation source;
+
+    /// Device local target buffer
+    buffer::s_ptr target;
+
+    /// Size of data
+    VkDeviceSize size = 0;
+
+    /// Usage flags of target buffer
+    VkBufferUsageFlags usage = 0;
+
+    /**
+     * @brief Record copy and barrier to usage of target
+     * @param cmd_buf    Command buffer
+     */
+    void record(VkCommandBuffer cmd_buf) const;
+};
+
+/**
+ * @brief Staging ring buffer
+ *
+ * One persistently mapped buffer per device. Allocations are handed out
+ * in order and reclaimed in order: the tail moves over released
+ * allocations once the command buffer reading them has completed
+ * (the fence was waited). Released out of order, an allocation waits
+ * for the older ones.
+ */
+struct staging_ring {
+    /// Shared pointer to staging ring
+    using s_ptr = std::shared_ptr<staging_ring>;
+
+    /**
+     * @brief Make a new staging ring
+     * @return s_ptr    Shared pointer to staging ring
+     */
+    static s_ptr make() {
+        return std::make_shared<staging_ring>();
+    }
+
+    /**
+     * @brief Destroy the staging ring
+     */
+    ~staging_ring() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new staging ring
+     * @param device    Vulkan device
+     * @param size      Size of ring
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                VkDeviceSize size = default_staging_ring_size);
+
+    /**
+     * @brief Destroy the staging ring
+     */
+    void destroy();
+
+    /**
+     * @brief Allocate staging memory
+     *
+     * Larger than the ring: a dedicated buffer is created.
+     *
+     * @param size                   Size of allocation
+     * @param alignment              Alignment of offset
+     * @param dedicated_if_full      Create dedicated buffer if ring is full
+     * @return staging_allocation    Allocation (invalid: ring is full)
+     */
+    staging_allocation allocate(VkDeviceSize size,
+                                VkDeviceSize alignment = 16,
+                                bool dedicated_if_full = false);
+
+    /**
+     * @brief Allocate staging memory and copy data
+     * @param data                   Data to copy
+     * @param size                   Size of data
+     * @param alignment              Alignment of offset
+     * @param dedicated_if_full      Create dedicated buffer if ring is full
+     * @return staging_allocation    Allocation (invalid: ring is full)
+     */
+    staging_allocation upload(void const* data,
+                              VkDeviceSize size,
+                              VkDeviceSize alignment = 16,
+                              bool dedicated_if_full = false);
+
+    /**
+     * @brief Flush written data of allocation
+     * @param allocation    Staging allocation
+     */
+    void flush(staging_allocation const& allocation);
+
+    /**
+     * @brief Release allocation (command buffer has completed)
+     * @param allocation    Staging allocation (reset)
+     */
+    void release(staging_allocation& allocation);
+
+    /**
+     * @brief Submit buffer uploads on the graphics queue without waiting
+     *
+     * Draws submitted to the graphics queue afterwards see the data
+     * (barrier in submission order). Staging memory is released with
+     * collect once the fence is signaled.
+     *
+     * @param uploads    List of staged uploads (cleared)
+     * @return Submit was successful or failed
+     */
+    bool submit(buffer_upload::list& uploads);
+
+    /**
+     * @brief Release staging memory of completed submits
+     * @param wait    Wait for all submits
+     */
+    void collect(bool wait = false);
+
+    /**
+     * @brief Get the number of submits in flight
+     * @return size_t    Number of submits
+     */
+    size_t get_submit_count() const {
+        std::lock_guard lock(m_submit_mutex);
+        return m_submits.size();
+    }
+
+    /**
+     * @brief Get the size of the ring
+     * @return VkDeviceSize    Size in bytes
+     */
+    VkDeviceSize get_size() const {
+        return m_size;
+    }
+
+    /**
+     * @brief Get the used size of the ring
+     * @return VkDeviceSize    Size in bytes
+     */
+    VkDeviceSize get_used() const {
+        std::lock_guard lock(m_mutex);
+        return m_used;
+    }
+
+    /**
+     * @brief Get the peak used size of the ring
+     * @return VkDeviceSize    Size in bytes
+     */
+    VkDeviceSize get_peak() const {
+        std::lock_guard lock(m_mutex);
+        return m_peak;
+    }
+
+private:
+    /// Ring buffer
+    buffer::s_ptr m_buffer;
+
+    /// Size of ring
+    VkDeviceSize m_size = 0;
+
+    /// Next free offset
+    VkDeviceSize m_head = 0;
+
+    /// Oldest used offset
+    VkDeviceSize m_tail = 0;
+
+    /// Used size (with padding)
+    VkDeviceSize m_used = 0;
+
+    /// Peak used size
+    VkDeviceSize m_peak = 0;
+
+    /**
+     * @brief Allocation in order of the ring
+     */
+    struct entry {
+        /// Allocation id
+        ui64 id = 0;
+
+        /// End offset
+        VkDeviceSize end = 0;
+
+        /// Used size (with padding)
+        VkDeviceSize used = 0;
+
+        /// Released state
+        bool released = false;
+    };
+
+    /// Allocations in use
+    std::deque<entry> m_entries;
+
+    /// Next allocation id
+    ui64 m_next_id = 1;
+
+    /// Ring mutex
+    mutable std::mutex m_mutex;
+
+    /**
+     * @brief Submitted uploads waiting for their fence
+     */
+    struct submission {
+        /// Signaled when the copies have completed
+        VkFence fence = VK_NULL_HANDLE;
+
+        /// Command buffer of copies
+        VkCommandBuffer cmd_buf = VK_NULL_HANDLE;
+
+        /// Uploads (keep staging memory and targets)
+        buffer_upload::list uploads;
+    };
+
+    /// Command pool of submits (graphics queue family)
+    VkCommandPool m_pool = VK_NULL_HANDLE;
+
+    /// Submits in flight (in submit order)
+    std::deque<submission> m_submits;
+
+    /// Submit mutex
+    mutable std::mutex m_submit_mutex;
+};
+
+/**
+ * @brief Get the staging ring of a device (created on first use)
+ * @param device                 Vulkan device
+ * @return staging_ring::s_ptr   Shared pointer to staging ring
+ */
+staging_ring::s_ptr get_staging_ring(device::ptr device);
+
+/**
+ * @brief Create a device local buffer filled from the staging ring
+ *
+ * When the ring is full, the pending uploads are submitted (list is
+ * cleared) and all submits in flight are waited for.
+ *
+ * @param device            Vulkan device
+ * @param data              Buffer data
+ * @param size              Data size
+ * @param usage             Buffer usage flags (transfer destination added)
+ * @param uploads           List to add staged upload to
+ * @return buffer::s_ptr    Shared pointer to buffer (nullptr: failed)
+ */
+buffer::s_ptr create_staged_buffer(device::ptr device,
+                                   void const* data,
+                                   size_t size,
+                                   VkBufferUsageFlags usage,
+                                   buffer_upload::list& uploads);
+
+/**
+ * @brief Submit staged uploads on the graphics queue
+ *
+ * Without wait the staging memory is released later (see
+ * staging_ring::submit), the app collects it every frame.
+ *
+ * @param device     Vulkan device
+ * @param uploads    List of staged uploads (cleared)
+ * @param wait       Wait for completion (synchronous fallback)
+ * @return Submit was successful or failed
+ */
+bool submit_uploads(device::ptr device,
+                    buffer_upload::list& uploads,
+                    bool wait = false);
+
+} // namespace lava
@@ -0,0 +1,117 @@
+/**
+ * @file         liblava/resource/test/bounds.cpp
+ * @brief        Bounds and frustum culling unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "liblava/test.hpp"
+
+namespace {
+
+/// Random boxes in a cube around the origin
+culling_boxes make_boxes(size_t count) {
+    culling_boxes result;
+    result.reserve(count);
+
+    for (auto i = 0u; i < count; ++i)
+        result.add(v3(random(-100.f, 100.f), random(-100.f, 100.f), random(-100.f, 100.f)),
+                   v3(random(0.1f, 2.f)));
+
+    return result;
+}
+
+/// Camera at origin looking down -z
+mat4 make_view_projection() {
+    auto const projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 50.f);
+    auto const view = glm::lookAt(v3(0.f), v3(0.f, 0.f, -1.f), v3(0.f, 1.f, 0.f));
+    return projection * view;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("calc bounds", "[bounds]") {
+    std::vector<vertex> vertices(3);
+    vertices[0].position = v3(-1.f, 0.f, 0.f);
+    vertices[1].position = v3(1.f, 2.f, 0.f);
+    vertices[2].position = v3(0.f, 0.f, 4.f);
+
+    auto const bounds = calc_bounds(vertices);
+
+    REQUIRE(bounds.box.valid());
+    REQUIRE(bounds.box.min == v3(-1.f, 0.f, 0.f));
+    REQUIRE(bounds.box.max == v3(1.f, 2.f, 4.f));
+    REQUIRE(bounds.sphere.center == v3(0.f, 1.f, 2.f));
+
+    for (auto const& v : vertices)
+        REQUIRE(glm::distance(v.position, bounds.sphere.center) <= bounds.sphere.radius + 1e-5f);
+
+    REQUIRE_FALSE(calc_bounds(std::vector<vertex>{}).box.valid());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("transform bounding box", "[bounds]") {
+    bounding_box const box{v3(-1.f), v3(1.f)};
+
+    auto const moved = box.transform(glm::translate(mat4(1.f), v3(10.f, 0.f, 0.f)));
+    REQUIRE(moved.center() == v3(10.f, 0.f, 0.f));
+    REQUIRE(moved.extent() == v3(1.f));
+
+    auto const rotated = box.transform(glm::rotate(mat4(1.f), glm::radians(45.f), v3(0.f, 0.f, 1.f)));
+    REQUIRE(rotated.extent().x > 1.4f);
+    REQUIRE(rotated.extent().z == 1.f);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("cull frustum", "[bounds]") {
+    auto const view_projection = make_view_projection();
+    auto const planes = extract_frustum_planes(view_projection);
+
+    culling_boxes boxes;
+    boxes.add(v3(0.f, 0.f, -10.f), v3(1.f)); // in front
+    boxes.add(v3(0.f, 0.f, 10.f), v3(1.f));  // behind
+    boxes.add(v3(0.f, 0.f, -60.f), v3(1.f)); // beyond far
+    boxes.add(v3(0.f, 0.f, -49.5f), v3(1.f)); // crossing far
+    boxes.add(v3(100.f, 0.f, -10.f), v3(1.f)); // right
+
+    REQUIRE(cull_frustum(view_projection, boxes) == index_list{0, 3});
+
+    auto const random_boxes = make_boxes(1001);
+
+    index_list visible;
+    cull_frustum(planes, random_boxes, visible);
+
+    index_list expected;
+    for (auto i = 0u; i < random_boxes.size(); ++i)
+        if (box_in_frustum(planes,
+                           {random_boxes.center_x[i], random_boxes.center_y[i], random_boxes.center_z[i]},
+                           {random_boxes.extent_x[i], random_boxes.extent_y[i], random_boxes.extent_z[i]}))
+            expected.push_back(i);
+
+    REQUIRE(visible == expected);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("cull frustum benchmark", "[.][bounds][benchmark]") {
+    auto const boxes = make_boxes(1'000'000);
+    auto const planes = extract_frustum_planes(make_view_projection());
+
+    index_list visible;
+
+    BENCHMARK("cull 1M boxes") {
+        cull_frustum(planes, boxes, visible);
+        return visible.size();
+    };
+
+    BENCHMARK("cull 1M boxes (scalar)") {
+        visible.clear();
+        for (auto i = 0u; i < boxes.size(); ++i)
+            if (box_in_frustum(planes,
+                               {boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]},
+                               {boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]}))
+                visible.push_back(i);
+        return visible.size();
+    };
+}
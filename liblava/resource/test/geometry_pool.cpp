@@ -0,0 +1,115 @@
+/**
+ * @file         liblava/resource/test/geometry_pool.cpp
+ * @brief        Range allocator unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("range allocator - allocate and free", "[geometry_pool]") {
+    range_allocator allocator;
+    allocator.reset(100);
+
+    REQUIRE(allocator.get_capacity() == 100);
+    REQUIRE(allocator.get_free() == 100);
+
+    auto const a = allocator.allocate(30);
+    auto const b = allocator.allocate(50);
+    REQUIRE(a == 0);
+    REQUIRE(b == 30);
+    REQUIRE(allocator.get_free() == 20);
+
+    REQUIRE(allocator.allocate(0) == no_index);
+    REQUIRE(allocator.allocate(21) == no_index);
+
+    auto const c = allocator.allocate(20);
+    REQUIRE(c == 80);
+    REQUIRE(allocator.get_free() == 0);
+    REQUIRE(allocator.get_free_range_count() == 0);
+
+    allocator.free(b, 50);
+    REQUIRE(allocator.get_free() == 50);
+
+    // first fit reuses the freed range
+    REQUIRE(allocator.allocate(10) == 30);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("range allocator - coalesce neighbours", "[geometry_pool]") {
+    range_allocator allocator;
+    allocator.reset(90);
+
+    auto const a = allocator.allocate(30);
+    auto const b = allocator.allocate(30);
+    auto const c = allocator.allocate(30);
+
+    allocator.free(a, 30);
+    allocator.free(c, 30);
+    REQUIRE(allocator.get_free_range_count() == 2);
+    REQUIRE(allocator.get_largest_free() == 30);
+
+    // merges with both neighbours
+    allocator.free(b, 30);
+    REQUIRE(allocator.get_free_range_count() == 1);
+    REQUIRE(allocator.get_largest_free() == 90);
+    REQUIRE(allocator.allocate(90) == 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("range allocator - fragmentation", "[geometry_pool]") {
+    range_allocator allocator;
+    allocator.reset(100);
+
+    std::vector<ui32> offsets;
+    for (auto i = 0u; i < 10; ++i)
+        offsets.push_back(allocator.allocate(10));
+
+    // free every second range
+    for (auto i = 0u; i < offsets.size(); i += 2)
+        allocator.free(offsets[i], 10);
+
+    REQUIRE(allocator.get_free() == 50);
+    REQUIRE(allocator.get_largest_free() == 10);
+    REQUIRE(allocator.get_free_range_count() == 5);
+
+    REQUIRE(allocator.allocate(20) == no_index);
+    REQUIRE(allocator.allocate(10) == 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("range allocator - defragment", "[geometry_pool]") {
+    range_allocator allocator;
+    allocator.reset(100);
+
+    range_allocator::range::list ranges;
+    for (auto const count : {10u, 20u, 5u, 15u, 25u})
+        ranges.push_back({allocator.allocate(count), count});
+
+    // drop ranges 1 and 3, shuffle order
+    allocator.free(ranges[1].offset, ranges[1].count);
+    allocator.free(ranges[3].offset, ranges[3].count);
+    ranges = {ranges[4], ranges[0], ranges[2]};
+    REQUIRE(allocator.get_free_range_count() == 3);
+
+    auto const moves = allocator.defragment(ranges);
+
+    REQUIRE(ranges[1].offset == 0);
+    REQUIRE(ranges[2].offset == 10);
+    REQUIRE(ranges[0].offset == 15);
+
+    // first range stays, moves go to lower offsets in order
+    REQUIRE(moves.size() == 2);
+    REQUIRE(moves[0].source == 30);
+    REQUIRE(moves[0].target == 10);
+    REQUIRE(moves[0].count == 5);
+    REQUIRE(moves[1].source == 50);
+    REQUIRE(moves[1].target == 15);
+    REQUIRE(moves[1].count == 25);
+
+    REQUIRE(allocator.get_free() == 60);
+    REQUIRE(allocator.get_free_range_count() == 1);
+    REQUIRE(allocator.get_largest_free() == 60);
+    REQUIRE(allocator.allocate(60) == 40);
+}
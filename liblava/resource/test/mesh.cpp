@@ -0,0 +1,95 @@
+/**
+ * @file         liblava/resource/test/mesh.cpp
+ * @brief        Mesh unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh range", "[mesh]") {
+    mesh_range range;
+    REQUIRE(range.empty());
+    REQUIRE(range.size() == 0);
+
+    range.add(10, 5);
+    REQUIRE(range.first == 10);
+    REQUIRE(range.last == 15);
+
+    range.add(2, 3);
+    REQUIRE(range.first == 2);
+    REQUIRE(range.size() == 13);
+
+    range.add(20, 0);
+    REQUIRE(range.last == 15);
+
+    range.clear();
+    REQUIRE(range.empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh data dirty ranges", "[mesh]") {
+    auto data = create_mesh_data(mesh_type::cube);
+    REQUIRE(data.dirty_vertices.empty());
+
+    data.mark_vertices(4, 4);
+    data.mark_indices(0, 6);
+    REQUIRE(data.dirty_vertices.first == 4);
+    REQUIRE(data.dirty_vertices.size() == 4);
+    REQUIRE(data.dirty_indices.size() == 6);
+
+    data.move(std::array<r32, 3>{1.f, 0.f, 0.f});
+    REQUIRE(data.dirty_vertices.first == 0);
+    REQUIRE(data.dirty_vertices.size() == data.vertices.size());
+
+    data.clear_dirty();
+    data.mark_all();
+    REQUIRE(data.dirty_indices.size() == data.indices.size());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh index type", "[mesh]") {
+    // all-ones value of each type is kept for primitive restart
+    REQUIRE(select_index_type({0, 1, 254}) == VK_INDEX_TYPE_UINT16);
+    REQUIRE(select_index_type({0, 1, 254}, true) == VK_INDEX_TYPE_UINT8_EXT);
+    REQUIRE(select_index_type({0, 1, 255}, true) == VK_INDEX_TYPE_UINT16);
+    REQUIRE(select_index_type({0, 1, 256}, true) == VK_INDEX_TYPE_UINT16);
+    REQUIRE(select_index_type({0, 1, 65534}) == VK_INDEX_TYPE_UINT16);
+    REQUIRE(select_index_type({0, 1, 65535}) == VK_INDEX_TYPE_UINT32);
+    REQUIRE(select_index_type({0, 1, 65536}, true) == VK_INDEX_TYPE_UINT32);
+    REQUIRE(select_index_type({}) == VK_INDEX_TYPE_UINT16);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh pack indices", "[mesh]") {
+    index_list const indices = {0, 254, 255, 256, 65534, 65535, 65536};
+
+    SECTION("uint8") {
+        index_list const small = {0, 1, 254};
+        auto const data = pack_indices(small, VK_INDEX_TYPE_UINT8_EXT);
+
+        REQUIRE(data.size() == small.size());
+        REQUIRE(data[2] == 254);
+    }
+
+    SECTION("uint16") {
+        index_list const medium(indices.begin(), indices.begin() + 5);
+        auto const data = pack_indices(medium, VK_INDEX_TYPE_UINT16);
+        REQUIRE(data.size() == medium.size() * sizeof(ui16));
+
+        std::vector<ui16> result(medium.size());
+        memcpy(result.data(), data.data(), data.size());
+        for (auto i = 0u; i < medium.size(); ++i)
+            REQUIRE(result[i] == medium[i]);
+    }
+
+    SECTION("uint32") {
+        auto const data = pack_indices(indices, VK_INDEX_TYPE_UINT32);
+        REQUIRE(data.size() == indices.size() * sizeof(ui32));
+
+        index_list result(indices.size());
+        memcpy(result.data(), data.data(), data.size());
+        REQUIRE(result == indices);
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file         liblava/resource/test/mesh_lod.cpp
+ * @brief        Mesh simplification unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/// Wavy grid of quads in xy plane
+mesh_data make_wave_grid(ui32 size) {
+    mesh_data result;
+
+    for (auto y = 0u; y <= size; ++y)
+        for (auto x = 0u; x <= size; ++x) {
+            vertex item{};
+            item.position = v3(r32(x), r32(y),
+                               std::sin(r32(x) * 0.3f) * std::cos(r32(y) * 0.2f) * 2.f);
+            result.vertices.push_back(item);
+        }
+
+    for (auto y = 0u; y < size; ++y)
+        for (auto x = 0u; x < size; ++x) {
+            auto const i = y * (size + 1) + x;
+            result.indices.insert(result.indices.end(), {i, i + 1, i + size + 2,
+                                                         i, i + size + 2, i + size + 1});
+        }
+
+    return result;
+}
+
+/// Positions of mesh data
+std::vector<v3> get_positions(mesh_data const& data) {
+    std::vector<v3> result;
+    for (auto const& item : data.vertices)
+        result.push_back(item.position);
+
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh simplify - target index count", "[mesh_lod]") {
+    auto const data = make_wave_grid(32);
+    auto const positions = get_positions(data);
+
+    auto const target = data.indices.size() / 4;
+
+    r32 error = -1.f;
+    auto const result = simplify_mesh_indices(positions, data.indices,
+                                              target, 1.f, &error);
+
+    REQUIRE(result.size() % 3 == 0);
+    REQUIRE(result.size() <= target);
+    REQUIRE(result.size() >= target / 2);
+    REQUIRE(error > 0.f);
+
+    for (auto const idx : result)
+        REQUIRE(idx < positions.size());
+
+    // no error budget: nothing to collapse on a curved surface
+    auto const unchanged = simplify_mesh_indices(positions, data.indices,
+                                                 target, 0.f);
+    REQUIRE(unchanged.size() == data.indices.size());
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("mesh lods - generate chain", "[mesh_lod]") {
+    auto data = make_wave_grid(32);
+    auto const index_count = data.indices.size();
+
+    auto const lod_count = generate_mesh_lods(data, 4, 0.5f, 0.1f);
+
+    REQUIRE(lod_count > 1);
+    REQUIRE(data.lods.size() == lod_count);
+
+    auto const& full = data.lods.front();
+    REQUIRE(full.first_index == 0);
+    REQUIRE(full.index_count == index_count);
+    REQUIRE(full.error == 0.f);
+
+    for (auto l = 1u; l < data.lods.size(); ++l) {
+        auto const& lod = data.lods[l];
+        auto const& finer = data.lods[l - 1];
+
+        REQUIRE(lod.first_index == finer.first_index + finer.index_count);
+        REQUIRE(lod.index_count % 3 == 0);
+        REQUIRE(lod.index_count < finer.index_count);
+        REQUIRE(lod.error >= finer.error);
+
+        for (auto i = 0u; i < lod.index_count; ++i)
+            REQUIRE(data.indices[lod.first_index + i] < data.vertices.size());
+    }
+
+    REQUIRE(data.lods.back().error > 0.f);
+
+    // fine lods for close, coarse lods for far objects
+    REQUIRE(select_mesh_lod(data.lods, 1.e6f) == 0);
+    REQUIRE(select_mesh_lod(data.lods, 0.f) == data.lods.size() - 1);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file         liblava/resource/test/meshlet.cpp
+ * @brief        Meshlet unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/// Grid of quads in xy plane facing +z
+void make_grid(ui32 size,
+               std::vector<v3>& positions,
+               index_list& indices) {
+    for (auto y = 0u; y <= size; ++y)
+        for (auto x = 0u; x <= size; ++x)
+            positions.emplace_back(r32(x), r32(y), 0.f);
+
+    for (auto y = 0u; y < size; ++y)
+        for (auto x = 0u; x < size; ++x) {
+            auto const i = y * (size + 1) + x;
+            indices.insert(indices.end(), {i, i + 1, i + size + 2,
+                                           i, i + size + 2, i + size + 1});
+        }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("meshlet build - grid", "[meshlet]") {
+    std::vector<v3> positions;
+    index_list indices;
+    make_grid(32, positions, indices);
+
+    auto const data = build_meshlets(positions, indices);
+
+    REQUIRE(!data.meshlets.empty());
+
+    SECTION("respect limits") {
+        for (auto const& m : data.meshlets) {
+            REQUIRE(m.vertex_count <= meshlet_max_vertices);
+            REQUIRE(m.triangle_count <= meshlet_max_triangles);
+            REQUIRE(m.triangle_count > 0);
+        }
+    }
+
+    SECTION("cover all triangles") {
+        auto triangle_count = 0u;
+        for (auto const& m : data.meshlets)
+            triangle_count += m.triangle_count;
+
+        REQUIRE(triangle_count * 3 == indices.size());
+        REQUIRE(data.triangles.size() == indices.size());
+    }
+
+    SECTION("keep triangles") {
+        std::set<std::array<index, 3>> source;
+        for (auto i = 0u; i < indices.size(); i += 3)
+            source.insert({indices[i], indices[i + 1], indices[i + 2]});
+
+        for (auto const& m : data.meshlets)
+            for (auto t = 0u; t < m.triangle_count; ++t) {
+                auto const base = (m.triangle_offset + t) * 3;
+                std::array<index, 3> triangle;
+                for (auto k = 0u; k < 3; ++k)
+                    triangle[k] = data.vertices[m.vertex_offset
+                                                + data.triangles[base + k]];
+
+                REQUIRE(source.count(triangle) == 1);
+            }
+    }
+
+    SECTION("bound vertices") {
+        for (auto const& m : data.meshlets)
+            for (auto v = 0u; v < m.vertex_count; ++v) {
+                auto const& p = positions[data.vertices[m.vertex_offset + v]];
+                REQUIRE(glm::length(p - m.center) <= m.radius + 0.001f);
+            }
+    }
+
+    SECTION("flat normal cone") {
+        for (auto const& m : data.meshlets) {
+            REQUIRE(m.cone_axis.z > 0.99f);
+            REQUIRE(m.cone_cutoff < 0.01f);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("meshlet cull - grid", "[meshlet]") {
+    std::vector<v3> positions;
+    index_list indices;
+    make_grid(32, positions, indices);
+
+    auto const data = build_meshlets(positions, indices);
+
+    auto const projection = glm::perspective(glm::radians(60.f), 1.f, 0.1f, 256.f);
+
+    SECTION("front facing") {
+        auto const eye = v3(16.f, 16.f, 64.f);
+        auto const view = glm::lookAt(eye, v3(16.f, 16.f, 0.f), v3(0.f, 1.f, 0.f));
+
+        auto const visible = cull_meshlets(data, projection * view, eye);
+        REQUIRE(visible.size() == data.meshlets.size());
+    }
+
+    SECTION("back facing") {
+        auto const eye = v3(16.f, 16.f, -64.f);
+        auto const view = glm::lookAt(eye, v3(16.f, 16.f, 0.f), v3(0.f, 1.f, 0.f));
+
+        auto const visible = cull_meshlets(data, projection * view, eye);
+        REQUIRE(visible.empty());
+    }
+
+    SECTION("outside frustum") {
+        auto const eye = v3(16.f, 16.f, 64.f);
+        auto const view = glm::lookAt(eye, v3(16.f, 16.f, 128.f), v3(0.f, 1.f, 0.f));
+
+        auto const visible = cull_meshlets(data, projection * view, eye);
+        REQUIRE(visible.empty());
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("meshlet build - vertex limit", "[meshlet]") {
+    std::vector<v3> positions;
+    index_list indices;
+    make_grid(32, positions, indices);
+
+    for (auto const max_vertices : {255u, 256u}) {
+        auto const data = build_meshlets(positions, indices, max_vertices, 512);
+
+        auto triangle_count = 0u;
+        auto full = false;
+        for (auto const& m : data.meshlets) {
+            REQUIRE(m.vertex_count <= max_vertices);
+            full |= m.vertex_count == max_vertices;
+
+            for (auto t = 0u; t < m.triangle_count; ++t) {
+                auto const base = (m.triangle_offset + t) * 3;
+                for (auto k = 0u; k < 3; ++k)
+                    REQUIRE(data.triangles[base + k] < m.vertex_count);
+            }
+
+            triangle_count += m.triangle_count;
+        }
+
+        REQUIRE(full);
+        REQUIRE(triangle_count * 3 == indices.size());
+    }
+}
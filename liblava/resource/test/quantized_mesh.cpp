@@ -0,0 +1,109 @@
+/**
+ * @file         liblava/resource/test/quantized_mesh.cpp
+ * @brief        Quantized mesh unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/// Mesh with large positions, tiled uvs and spread normals
+mesh_data make_quantize_mesh() {
+    mesh_data data;
+
+    for (auto i = 0u; i < 64; ++i) {
+        auto const t = to_r32(i) / 63.f;
+        auto const angle = t * 6.2831853f * 3.f;
+
+        vertex item;
+        item.position = v3(std::cos(angle) * 250.f, t * 40.f - 20.f, std::sin(angle) * 0.5f);
+        item.uv = v2(t * 8.f - 3.f, 1.f - t * 2.5f);
+        item.normal = glm::normalize(v3(std::cos(angle), t * 2.f - 1.f, std::sin(angle * 0.5f)));
+        item.color = v4(t, 1.f - t, 0.5f, 1.f);
+
+        data.vertices.push_back(item);
+    }
+
+    for (auto i = 0u; i + 2 < data.vertices.size(); ++i)
+        data.indices.insert(data.indices.end(), {i, i + 1, i + 2});
+
+    return data;
+}
+
+/// Compare uvs with tolerance
+bool near_uv(v2 a,
+             v2 b,
+             r32 tolerance) {
+    return glm::abs(a.x - b.x) <= tolerance && glm::abs(a.y - b.y) <= tolerance;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("quantized mesh round trip", "[quantized_mesh]") {
+    auto const source = make_quantize_mesh();
+
+    SECTION("snorm16 positions") {
+        auto const data = quantize_mesh_data(source);
+        auto const result = dequantize_mesh_data(data);
+
+        REQUIRE(result.vertices.size() == source.vertices.size());
+        REQUIRE(result.indices == source.indices);
+
+        // half a step of each bounds axis
+        auto const position_error = data.transform.scale / 32767.f;
+        auto const uv_error = data.transform.uv_scale / 65535.f;
+
+        for (auto i = 0u; i < source.vertices.size(); ++i) {
+            auto const& a = source.vertices[i];
+            auto const& b = result.vertices[i];
+
+            for (auto c = 0u; c < 3; ++c)
+                REQUIRE(glm::abs(a.position[c] - b.position[c]) <= position_error[c]);
+
+            for (auto c = 0u; c < 2; ++c)
+                REQUIRE(glm::abs(a.uv[c] - b.uv[c]) <= uv_error[c]);
+
+            REQUIRE(glm::dot(a.normal, b.normal) > 0.99999f);
+        }
+    }
+
+    SECTION("half positions") {
+        auto const data = quantize_mesh_data(source, position_encoding::half);
+        auto const result = dequantize_mesh_data(data);
+
+        REQUIRE(data.transform.get_matrix() == mat4(1.f));
+
+        for (auto i = 0u; i < source.vertices.size(); ++i) {
+            auto const& a = source.vertices[i];
+            auto const& b = result.vertices[i];
+
+            // 11 bit mantissa
+            for (auto c = 0u; c < 3; ++c)
+                REQUIRE(glm::abs(a.position[c] - b.position[c])
+                        <= glm::max(glm::abs(a.position[c]) / 2048.f, 1e-4f));
+        }
+    }
+
+    SECTION("uvs outside [0, 1]") {
+        auto const data = quantize_mesh_data(source);
+        auto const result = dequantize_mesh_data(data);
+
+        REQUIRE(near_uv(data.transform.uv_offset, v2(-3.f, -1.5f), 0.0001f));
+        REQUIRE(near_uv(data.transform.uv_scale, v2(8.f, 2.5f), 0.0001f));
+
+        REQUIRE(near_uv(result.vertices.front().uv, v2(-3.f, 1.f), 0.001f));
+        REQUIRE(near_uv(result.vertices.back().uv, v2(5.f, -1.5f), 0.001f));
+    }
+
+    SECTION("uvs in [0, 1]") {
+        auto unit_source = source;
+        for (auto& item : unit_source.vertices)
+            item.uv = glm::fract(glm::abs(item.uv));
+
+        auto const data = quantize_mesh_data(unit_source);
+        REQUIRE(data.transform.get_uv_transform() == v4(1.f, 1.f, 0.f, 0.f));
+    }
+}
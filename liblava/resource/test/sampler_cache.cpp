@@ -0,0 +1,114 @@
+/**
+ * @file         liblava/resource/test/sampler_cache.cpp
+ * @brief        Sampler cache unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+namespace {
+
+/**
+ * @brief Sampler cache with fake samplers
+ */
+struct fake_samplers {
+    /// Number of created samplers
+    ui32 created = 0;
+
+    /// Number of destroyed samplers
+    ui32 destroyed = 0;
+
+    /// Sampler cache (destroyed before counters)
+    sampler_cache cache;
+
+    /**
+     * @brief Construct the fake samplers
+     */
+    fake_samplers() {
+        cache.on_create = [&](VkSamplerCreateInfo const&) {
+            ++created;
+            return (VkSampler)(uintptr_t)created;
+        };
+
+        cache.on_destroy = [&](VkSampler) {
+            ++destroyed;
+        };
+    }
+};
+
+/// Sampler create information
+VkSamplerCreateInfo make_info(VkFilter filter) {
+    VkSamplerCreateInfo result{};
+    result.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    result.magFilter = filter;
+    result.minFilter = filter;
+    result.maxLod = VK_LOD_CLAMP_NONE;
+    return result;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+TEST_CASE("sampler cache - reference count", "[sampler_cache]") {
+    fake_samplers fake;
+    auto& cache = fake.cache;
+
+    auto const linear = cache.acquire(make_info(VK_FILTER_LINEAR));
+    auto const linear_again = cache.acquire(make_info(VK_FILTER_LINEAR));
+    auto const nearest = cache.acquire(make_info(VK_FILTER_NEAREST));
+
+    REQUIRE(linear != VK_NULL_HANDLE);
+    REQUIRE(linear == linear_again);
+    REQUIRE(nearest != linear);
+
+    REQUIRE(fake.created == 2);
+    REQUIRE(cache.get_count() == 2);
+    REQUIRE(cache.get_reference_count() == 3);
+
+    cache.release(linear);
+    REQUIRE(fake.destroyed == 0);
+    REQUIRE(cache.get_reference_count() == 2);
+
+    cache.release(linear);
+    REQUIRE(fake.destroyed == 1);
+    REQUIRE(cache.get_count() == 1);
+
+    // unknown sampler is ignored
+    cache.release(linear);
+    REQUIRE(fake.destroyed == 1);
+
+    cache.destroy();
+    REQUIRE(fake.destroyed == 2);
+    REQUIRE(cache.get_count() == 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("sampler cache - chained create info", "[sampler_cache]") {
+    fake_samplers fake;
+    auto& cache = fake.cache;
+
+    VkSamplerReductionModeCreateInfo reduction{};
+    reduction.sType = VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO;
+    reduction.reductionMode = VK_SAMPLER_REDUCTION_MODE_MIN;
+
+    auto info = make_info(VK_FILTER_LINEAR);
+    auto const shared = cache.acquire(info);
+
+    info.pNext = &reduction;
+    auto const chained = cache.acquire(info);
+    auto const chained_again = cache.acquire(info);
+
+    // chained structs are not compared: no sharing
+    REQUIRE(chained != shared);
+    REQUIRE(chained_again != chained);
+    REQUIRE(fake.created == 3);
+
+    cache.release(chained);
+    cache.release(chained_again);
+    REQUIRE(fake.destroyed == 2);
+    REQUIRE(cache.get_count() == 1);
+
+    cache.release(shared);
+    REQUIRE(fake.destroyed == 3);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file         liblava/resource/test/texture_atlas.cpp
+ * @brief        Texture atlas unit tests
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/test.hpp"
+
+//-----------------------------------------------------------------------------
+TEST_CASE("skyline packer", "[atlas]") {
+    skyline_packer packer;
+    packer.reset({64, 64});
+
+    struct rect {
+        uv2 position;
+        uv2 size;
+    };
+    std::vector<rect> rects;
+
+    // fixed sizes between 1 and 12
+    for (auto i = 0u; i < 200; ++i) {
+        uv2 const size = {1 + (i * 7) % 12, 1 + (i * 5 + 3) % 12};
+        auto const position = packer.insert(size);
+        if (!position)
+            continue;
+
+        REQUIRE(position->x + size.x <= 64);
+        REQUIRE(position->y + size.y <= 64);
+
+        for (auto const& other : rects) {
+            auto const overlap = position->x < other.position.x + other.size.x
+                                 && other.position.x < position->x + size.x
+                                 && position->y < other.position.y + other.size.y
+                                 && other.position.y < position->y + size.y;
+            REQUIRE_FALSE(overlap);
+        }
+
+        rects.push_back({*position, size});
+    }
+
+    REQUIRE(packer.get_occupancy() > 0.5f);
+
+    packer.reset({8, 8});
+    for (auto i = 0u; i < 4; ++i)
+        REQUIRE(packer.insert({4, 4}));
+
+    REQUIRE(packer.get_occupancy() == 1.f);
+    REQUIRE_FALSE(packer.insert({1, 1}));
+}
+
+//-----------------------------------------------------------------------------
+TEST_CASE("texture atlas pack", "[atlas]") {
+    texture_atlas atlas;
+
+    std::vector<ui8> const texels(24 * 24 * 4);
+    for (auto i = 0u; i < 10; ++i)
+        atlas.add({24, 24}, {texels.data(), texels.size()});
+
+    // 4 padded regions per 64x64 layer
+    REQUIRE(atlas.pack({64, 64}, 4));
+    REQUIRE(atlas.get_layer_count() == 3);
+
+    auto const& region = atlas.get_region(0);
+    REQUIRE(region.size == uv2(24, 24));
+    REQUIRE(region.offset.x >= 4);
+    REQUIRE(region.offset.y >= 4);
+
+    auto const uv_table = atlas.get_uv_table();
+    REQUIRE(uv_table.size() == 10);
+    REQUIRE(uv_table[0] == v4(24.f / 64.f, 24.f / 64.f,
+                              region.offset.x / 64.f, region.offset.y / 64.f));
+
+    for (auto const& r : atlas.get_regions())
+        REQUIRE(r.layer < 3);
+
+    // does not fit with padding
+    atlas.add({60, 8}, {texels.data(), 60 * 8 * 4});
+    REQUIRE_FALSE(atlas.pack({64, 64}, 4));
+}
@@ -8,7 +8,9 @@
 #include "liblava/resource/texture.hpp"
 #include "liblava/core/misc.hpp"
 #include "liblava/resource/format.hpp"
+#include "liblava/resource/sampler_cache.hpp"
 #include "liblava/util/log.hpp"
+#include <numeric>
 
 namespace lava {
 
@@ -35,7 +37,9 @@ bool texture::create(device::ptr device,
     if (m_type == texture_type::array || m_type == texture_type::cube_map)
         sampler_address_mode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
 
-    VkSamplerCreateInfo sampler_info{
+    auto const min_lod = m_sampler_info.minLod;
+
+    m_sampler_info = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .magFilter = VK_FILTER_LINEAR,
         .minFilter = VK_FILTER_LINEAR,
@@ -48,13 +52,14 @@ bool texture::create(device::ptr device,
         .maxAnisotropy = device->get_properties().limits.maxSamplerAnisotropy,
         .compareEnable = VK_FALSE,
         .compareOp = VK_COMPARE_OP_NEVER,
-        .minLod = 0.f,
-        .maxLod = to_r32(m_layers.front().levels.size()),
+        .minLod = min_lod,
+        .maxLod = VK_LOD_CLAMP_NONE, // view limits the levels, samplers are shared
         .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
         .unnormalizedCoordinates = VK_FALSE,
     };
 
-    if (!device->vkCreateSampler(&sampler_info, &m_sampler)) {
+    m_sampler = get_sampler_cache(device)->acquire(m_sampler_info);
+    if (!m_sampler) {
         logger()->error("create texture sampler");
         return false;
     }
@@ -93,7 +98,8 @@ void texture::destroy() {
     if (m_sampler) {
         if (m_img)
             if (auto device = m_img->get_device())
-                device->vkDestroySampler(m_sampler);
+                if (auto cache = device->get_sampler_cache())
+                    cache->release(m_sampler);
 
         m_sampler = VK_NULL_HANDLE;
     }
@@ -104,44 +110,373 @@ void texture::destroy() {
     }
 }
 
+//-----------------------------------------------------------------------------
+VkSampler texture::set_min_lod(r32 value) {
+    if (!m_sampler || !m_img) {
+        m_sampler_info.minLod = value;
+        return VK_NULL_HANDLE;
+    }
+
+    auto info = m_sampler_info;
+    info.minLod = value;
+
+    auto const sampler = get_sampler_cache(m_img->get_device())->acquire(info);
+    if (!sampler) {
+        logger()->error("create texture sampler (min lod {})", value);
+        return VK_NULL_HANDLE;
+    }
+
+    auto const replaced = m_sampler;
+
+    m_sampler = sampler;
+    m_sampler_info = info;
+    m_descriptor.sampler = m_sampler;
+
+    return replaced;
+}
+
 //-----------------------------------------------------------------------------
 void texture::destroy_upload_buffer() {
-    m_upload_buffer = nullptr;
+    if (m_upload.valid() && m_img && m_img->get_device()) {
+        if (auto ring = m_img->get_device()->get_staging_ring())
+            ring->release(m_upload);
+    }
+
+    m_upload = {};
+    m_upload_data = {};
 }
 
 //-----------------------------------------------------------------------------
 bool texture::upload(void const* data,
                      size_t data_size) {
-    m_upload_buffer = buffer::make();
-
-    return m_upload_buffer->create(m_img->get_device(),
-                                   data,
-                                   data_size,
-                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                   false,
-                                   VMA_MEMORY_USAGE_CPU_TO_GPU);
+    destroy_upload_buffer();
+
+    auto ring = get_staging_ring(m_img->get_device());
+    if (!ring)
+        return false;
+
+    m_upload_size = data_size;
+    m_staged_size = 0;
+    m_staged_levels = 0;
+    m_staged_rows = 0;
+
+    m_upload = ring->upload(data,
+                            data_size,
+                            texture_upload_alignment(get_format()));
+
+    if (!m_upload.valid()) {
+        // ring is full: copy on stage
+        auto const bytes = static_cast<ui8 const*>(data);
+        m_upload_data.assign(bytes, bytes + data_size);
+    }
+
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-bool texture::stage(VkCommandBuffer cmd_buf) {
-    if (!m_upload_buffer || !m_upload_buffer->valid()) {
+bool texture::prepare_upload() {
+    if (m_upload.valid())
+        return true;
+
+    if (m_upload_data.empty()) {
         logger()->error("stage texture");
         return false;
     }
 
-    VkImageSubresourceRange subresource_range{
+    auto ring = get_staging_ring(m_img->get_device());
+    if (!ring)
+        return false;
+
+    m_upload = ring->upload(m_upload_data.data(),
+                            m_upload_data.size(),
+                            texture_upload_alignment(get_format()));
+
+    // ring is still full: next frame
+    if (!m_upload.valid())
+        return false;
+
+    m_upload_data = {};
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+VkImageSubresourceRange texture::get_subresource_range() const {
+    return {
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
         .baseMipLevel = 0,
         .levelCount = to_ui32(m_layers.front().levels.size()),
         .baseArrayLayer = 0,
         .layerCount = to_ui32(m_layers.size()),
     };
+}
+
+//-----------------------------------------------------------------------------
+bool texture::stage(VkCommandBuffer cmd_buf) {
+    if (!prepare_upload())
+        return false;
+
+    if (m_blit_mips && m_layers.front().levels.size() > 1) {
+        stage_blit_mips(cmd_buf);
+        m_staged_size = m_upload_size;
+
+        logger()->trace("texture staged: {} (blit mips)", get_id().value);
+
+        return true;
+    }
+
+    record_copy(cmd_buf, VK_PIPELINE_STAGE_HOST_BIT);
+    m_staged_size = m_upload_size;
+
+    set_image_layout(m_img->get_device(),
+                     cmd_buf,
+                     m_img->get(),
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                     get_subresource_range(),
+                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     texture_shader_stages);
+
+    logger()->trace("texture staged: {}", get_id().value);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool texture::stage_part(VkCommandBuffer cmd_buf,
+                         size_t max_size,
+                         size_t& staged_size) {
+    staged_size = 0;
+
+    auto const level_count = to_ui32(m_layers.front().levels.size());
+    auto const layer_count = to_ui32(m_layers.size());
+
+    // blit needs the whole first level, a single part stages all
+    if ((m_blit_mips && level_count > 1)
+        || (m_staged_size == 0 && m_upload_size <= max_size)) {
+        if (!stage(cmd_buf))
+            return false;
+
+        staged_size = m_upload_size;
+        return true;
+    }
+
+    if (!prepare_upload())
+        return false;
+
+    auto const format = get_format();
+
+    ui32 block_width = 1;
+    ui32 block_height = 1;
+    format_block_dim(format, block_width, block_height);
+
+    // offsets of levels in upload data (layer by layer)
+    std::vector<VkDeviceSize> layer_offsets(layer_count, 0);
+    for (auto layer = 1u; layer < layer_count; ++layer) {
+        layer_offsets[layer] = layer_offsets[layer - 1];
+        for (auto const& level : m_layers[layer - 1].levels)
+            layer_offsets[layer] += level.size;
+    }
+
+    auto level_offset = [&](ui32 layer, ui32 level) {
+        auto offset = layer_offsets[layer];
+        for (auto i = 0u; i < level; ++i)
+            offset += m_layers[layer].levels[i].size;
+        return offset;
+    };
+
+    std::vector<VkBufferImageCopy> regions;
+
+    // levels go coarse to fine, contiguous ranges
+    auto begin_first = level_count;
+    auto begin_last = 0u;
+    auto done_first = level_count;
+    auto done_last = 0u;
+
+    while (m_staged_levels < level_count) {
+        auto const level = level_count - 1 - m_staged_levels;
+        auto const extent = m_layers.front().levels[level].extent;
+        auto const level_size = m_layers.front().levels[level].size;
+
+        auto const rows = std::max((extent.y + block_height - 1) / block_height, 1u);
+        auto const row_size = size_t(level_size / rows) * layer_count;
+
+        auto band = rows - m_staged_rows;
+        if (staged_size + band * row_size > max_size) {
+            band = to_ui32((max_size - std::min(staged_size, max_size)) / row_size);
+
+            // at least one band per part
+            if (band == 0 && staged_size == 0)
+                band = 1;
+
+            if (band == 0)
+                break;
+        }
+
+        if (m_staged_rows == 0) {
+            begin_first = level;
+            begin_last = std::max(begin_last, level);
+        }
+
+        auto const first_row = m_staged_rows * block_height;
+        auto const end_row = std::min((m_staged_rows + band) * block_height, extent.y);
+
+        for (auto layer = 0u; layer < layer_count; ++layer) {
+            regions.push_back({
+                .bufferOffset = m_upload.offset + level_offset(layer, level)
+                                + VkDeviceSize(m_staged_rows) * (level_size / rows),
+                .imageSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = layer,
+                    .layerCount = 1,
+                },
+                .imageOffset = {0, to_i32(first_row), 0},
+                .imageExtent = {extent.x, std::max(end_row - first_row, 1u), 1},
+            });
+        }
+
+        staged_size += band * row_size;
+        m_staged_rows += band;
+
+        if (m_staged_rows < rows)
+            break;
+
+        done_first = level;
+        done_last = std::max(done_last, level);
+
+        m_staged_rows = 0;
+        ++m_staged_levels;
+    }
+
+    auto device = m_img->get_device();
+
+    if (begin_first < level_count) {
+        VkImageSubresourceRange const range{
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = begin_first,
+            .levelCount = begin_last - begin_first + 1,
+            .baseArrayLayer = 0,
+            .layerCount = layer_count,
+        };
+
+        set_image_layout(device, cmd_buf, m_img->get(), VK_IMAGE_LAYOUT_UNDEFINED,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range,
+                         VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+
+    device->call().vkCmdCopyBufferToImage(cmd_buf,
+                                          m_upload.buffer,
+                                          m_img->get(),
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          to_ui32(regions.size()),
+                                          regions.data());
+
+    if (done_first < level_count) {
+        VkImageSubresourceRange const range{
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = done_first,
+            .levelCount = done_last - done_first + 1,
+            .baseArrayLayer = 0,
+            .layerCount = layer_count,
+        };
+
+        set_image_layout(device, cmd_buf, m_img->get(),
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         texture_shader_stages);
+    }
+
+    m_staged_size = m_staged_levels == level_count
+                        ? m_upload_size
+                        : std::min(m_staged_size + staged_size, m_upload_size);
+
+    logger()->trace("texture staged: {} (part {} / {} levels)",
+                    get_id().value, m_staged_levels, level_count);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool texture::stage_transfer(VkCommandBuffer cmd_buf,
+                             index src_family,
+                             index dst_family) {
+    if (!prepare_upload())
+        return false;
+
+    record_copy(cmd_buf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+    // release to graphics queue family, the semaphore makes it visible
+    auto const transfer = src_family != dst_family;
+
+    VkImageMemoryBarrier const barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = 0,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcQueueFamilyIndex = transfer ? to_ui32(src_family) : VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = transfer ? to_ui32(dst_family) : VK_QUEUE_FAMILY_IGNORED,
+        .image = m_img->get(),
+        .subresourceRange = get_subresource_range(),
+    };
+
+    m_img->get_device()->call().vkCmdPipelineBarrier(cmd_buf,
+                                                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                     0,
+                                                     0, nullptr,
+                                                     0, nullptr,
+                                                     1, &barrier);
+
+    logger()->trace("texture staged: {} (transfer queue)", get_id().value);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void texture::acquire(VkCommandBuffer cmd_buf,
+                      index src_family,
+                      index dst_family,
+                      VkPipelineStageFlags wait_stage) {
+    // transfer is complete
+    m_staged_size = m_upload_size;
+
+    if (src_family == dst_family)
+        return;
+
+    VkImageMemoryBarrier const barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcQueueFamilyIndex = to_ui32(src_family),
+        .dstQueueFamilyIndex = to_ui32(dst_family),
+        .image = m_img->get(),
+        .subresourceRange = get_subresource_range(),
+    };
+
+    m_img->get_device()->call().vkCmdPipelineBarrier(cmd_buf,
+                                                     wait_stage,
+                                                     texture_shader_stages,
+                                                     0,
+                                                     0, nullptr,
+                                                     0, nullptr,
+                                                     1, &barrier);
+}
+
+//-----------------------------------------------------------------------------
+void texture::record_copy(VkCommandBuffer cmd_buf,
+                          VkPipelineStageFlags src_stage) {
+    auto const subresource_range = get_subresource_range();
 
     auto device = m_img->get_device();
 
     set_image_layout(device, cmd_buf, m_img->get(), VK_IMAGE_LAYOUT_UNDEFINED,
                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range,
-                     VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+                     src_stage, VK_PIPELINE_STAGE_TRANSFER_BIT);
 
     std::vector<VkBufferImageCopy> regions;
 
@@ -166,7 +501,7 @@ bool texture::stage(VkCommandBuffer cmd_buf) {
                 };
 
                 VkBufferImageCopy buffer_copy_region{
-                    .bufferOffset = offset,
+                    .bufferOffset = m_upload.offset + offset,
                     .imageSubresource = image_subresource,
                     .imageExtent = image_extent,
                 };
@@ -187,7 +522,7 @@ bool texture::stage(VkCommandBuffer cmd_buf) {
         auto size = m_img->get_size();
 
         VkBufferImageCopy region{
-            .bufferOffset = 0,
+            .bufferOffset = m_upload.offset,
             .bufferRowLength = size.x,
             .bufferImageHeight = size.y,
             .imageSubresource = subresource_layers,
@@ -199,29 +534,174 @@ bool texture::stage(VkCommandBuffer cmd_buf) {
     }
 
     device->call().vkCmdCopyBufferToImage(cmd_buf,
-                                          m_upload_buffer->get(),
+                                          m_upload.buffer,
                                           m_img->get(),
                                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                           to_ui32(regions.size()),
                                           regions.data());
+}
 
-    set_image_layout(device,
-                     cmd_buf,
-                     m_img->get(),
-                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                     subresource_range,
-                     VK_PIPELINE_STAGE_TRANSFER_BIT,
-                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+//-----------------------------------------------------------------------------
+void texture::stage_blit_mips(VkCommandBuffer cmd_buf) {
+    auto device = m_img->get_device();
+    auto const level_count = to_ui32(m_layers.front().levels.size());
+    auto const layer_count = to_ui32(m_layers.size());
 
-    logger()->trace("texture staged: {}", get_id().value);
+    VkImageSubresourceRange subresource_range{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = level_count,
+        .baseArrayLayer = 0,
+        .layerCount = layer_count,
+    };
 
-    return true;
+    set_image_layout(device, cmd_buf, m_img->get(), VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range,
+                     VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    auto const size = m_img->get_size();
+
+    VkBufferImageCopy const region{
+        .bufferOffset = m_upload.offset,
+        .bufferRowLength = size.x,
+        .bufferImageHeight = size.y,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = layer_count,
+        },
+        .imageOffset = {},
+        .imageExtent = {size.x, size.y, 1},
+    };
+
+    device->call().vkCmdCopyBufferToImage(cmd_buf,
+                                          m_upload.buffer,
+                                          m_img->get(),
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          1,
+                                          &region);
+
+    auto level_range = subresource_range;
+    level_range.levelCount = 1;
+
+    for (auto level = 1u; level < level_count; ++level) {
+        level_range.baseMipLevel = level - 1;
+
+        insert_image_memory_barrier(device,
+                                    cmd_buf,
+                                    m_img->get(),
+                                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                                    VK_ACCESS_TRANSFER_READ_BIT,
+                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    level_range);
+
+        auto const src_extent = m_layers.front().levels[level - 1].extent;
+        auto const dst_extent = m_layers.front().levels[level].extent;
+
+        VkImageBlit const blit{
+            .srcSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = level - 1,
+                .baseArrayLayer = 0,
+                .layerCount = layer_count,
+            },
+            .srcOffsets = {{0, 0, 0},
+                           {to_i32(src_extent.x), to_i32(src_extent.y), 1}},
+            .dstSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = level,
+                .baseArrayLayer = 0,
+                .layerCount = layer_count,
+            },
+            .dstOffsets = {{0, 0, 0},
+                           {to_i32(dst_extent.x), to_i32(dst_extent.y), 1}},
+        };
+
+        device->call().vkCmdBlitImage(cmd_buf,
+                                      m_img->get(),
+                                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                      m_img->get(),
+                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      1,
+                                      &blit,
+                                      VK_FILTER_LINEAR);
+    }
+
+    // all but the last level are transfer sources now
+    level_range.baseMipLevel = 0;
+    level_range.levelCount = level_count - 1;
+
+    insert_image_memory_barrier(device,
+                                cmd_buf,
+                                m_img->get(),
+                                VK_ACCESS_TRANSFER_READ_BIT,
+                                VK_ACCESS_SHADER_READ_BIT,
+                                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                texture_shader_stages,
+                                level_range);
+
+    level_range.baseMipLevel = level_count - 1;
+    level_range.levelCount = 1;
+
+    insert_image_memory_barrier(device,
+                                cmd_buf,
+                                m_img->get(),
+                                VK_ACCESS_TRANSFER_WRITE_BIT,
+                                VK_ACCESS_SHADER_READ_BIT,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                texture_shader_stages,
+                                level_range);
+}
+
+//-----------------------------------------------------------------------------
+VkDeviceSize texture_upload_alignment(VkFormat format) {
+    return std::lcm(VkDeviceSize(std::max(format_block_size(format), 1u)),
+                    VkDeviceSize(4));
+}
+
+//-----------------------------------------------------------------------------
+texture::layer::list make_mip_layers(uv2 size,
+                                     ui32 texel_size,
+                                     ui32 layer_count) {
+    texture::layer layer;
+
+    auto extent = size;
+    for (auto i = 0u; i < calc_mip_levels(size); ++i) {
+        layer.levels.push_back({extent, extent.x * extent.y * texel_size});
+
+        extent = glm::max(extent / 2u, uv2(1u));
+    }
+
+    return texture::layer::list(layer_count, layer);
+}
+
+//-----------------------------------------------------------------------------
+void staging::add(texture::s_ptr texture,
+                  staging_priority priority) {
+    auto it = std::upper_bound(m_todo.begin(),
+                               m_todo.end(),
+                               priority,
+                               [](staging_priority p, item const& i) {
+                                   return p < i.priority;
+                               });
+
+    m_todo.insert(it, {texture, priority});
 }
 
 //-----------------------------------------------------------------------------
 bool staging::stage(VkCommandBuffer cmd_buf,
                     index frame) {
+    m_frame_wait_value = 0;
+    m_staged_size = 0;
+
     if (!m_staged.empty() && m_staged.count(frame)
         && !m_staged.at(frame).empty()) {
         for (auto& texture : m_staged.at(frame))
@@ -230,16 +710,67 @@ bool staging::stage(VkCommandBuffer cmd_buf,
         m_staged.erase(frame);
     }
 
+    auto const acquired = async() && acquire_transfers(cmd_buf);
+
     if (m_todo.empty())
-        return false;
+        return acquired;
+
+    auto const unlimited = std::numeric_limits<size_t>::max();
+    auto const budget = m_frame_budget != 0 ? m_frame_budget : unlimited;
 
+    size_t budget_size = 0;
+    auto staged_any = false;
+
+    texture::s_list transfer_list;
     texture::s_list stage_done;
 
-    for (auto& texture : m_todo) {
-        if (!texture->stage(cmd_buf))
+    for (auto& [texture, priority] : m_todo) {
+        auto const visible = priority == staging_priority::visible;
+
+        // background only in frames without other uploads
+        if (priority == staging_priority::background && staged_any)
+            break;
+
+        auto const left = visible ? unlimited
+                                  : budget - std::min(budget, budget_size);
+        if (left == 0)
+            break;
+
+        auto const size = texture->get_stage_size();
+
+        if (async() && !texture->get_blit_mips()
+            && !texture->partly_staged() && size <= left) {
+            transfer_list.push_back(texture);
+
+            if (!visible)
+                budget_size += size;
+
+            staged_any = true;
+            continue;
+        }
+
+        size_t staged_size = 0;
+        if (!texture->stage_part(cmd_buf, left, staged_size))
             continue;
 
-        stage_done.push_back(texture);
+        m_staged_size += staged_size;
+        if (!visible)
+            budget_size += staged_size;
+
+        staged_any = true;
+
+        if (texture->get_stage_size() == 0)
+            stage_done.push_back(texture);
+    }
+
+    if (!transfer_list.empty() && submit_transfer(transfer_list)) {
+        for (auto& texture : transfer_list) {
+            m_staged_size += texture->get_upload_size();
+
+            std::erase_if(m_todo, [&](item const& i) {
+                return i.texture == texture;
+            });
+        }
     }
 
     if (!m_staged.count(frame))
@@ -249,9 +780,239 @@ bool staging::stage(VkCommandBuffer cmd_buf,
         if (!contains(m_staged.at(frame), texture))
             m_staged.at(frame).push_back(texture);
 
-        remove(m_todo, texture);
+        std::erase_if(m_todo, [&](item const& i) {
+            return i.texture == texture;
+        });
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+size_t staging::get_queue_depth(staging_priority priority) const {
+    return std::count_if(m_todo.begin(),
+                         m_todo.end(),
+                         [&](item const& i) {
+                             return i.priority == priority;
+                         });
+}
+
+//-----------------------------------------------------------------------------
+size_t staging::get_pending_size() const {
+    size_t result = 0;
+    for (auto const& [texture, priority] : m_todo)
+        result += texture->get_stage_size();
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+void staging::clear() {
+    m_todo.clear();
+    m_staged.clear();
+
+    destroy_async();
+}
+
+//-----------------------------------------------------------------------------
+bool staging::create_async(device::ptr device) {
+    destroy_async();
+
+    if (!device->timeline_semaphore_enabled()
+        || device->get_transfer_queues().empty()) {
+        logger()->info("async uploads not supported");
+        return false;
+    }
+
+    // default queue setup: transfer queue is the graphics queue
+    auto const& transfer_queue = device->transfer_queue();
+    auto const& graphics_queue = device->graphics_queue();
+    if (transfer_queue.vk_queue == graphics_queue.vk_queue) {
+        logger()->info("async uploads: no own transfer queue, uploads in frame");
+        return false;
+    }
+
+    if (transfer_queue.family == graphics_queue.family)
+        logger()->debug("async uploads: transfer queue shares graphics family {}",
+                        graphics_queue.family);
+
+    m_device = device;
+    m_transfer_queue = transfer_queue;
+    m_graphics_family = graphics_queue.family;
+
+    VkCommandPoolCreateInfo const pool_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = to_ui32(m_transfer_queue.family),
+    };
+
+    if (!device->vkCreateCommandPool(&pool_info, &m_pool)) {
+        logger()->error("create async upload command pool");
+        return false;
     }
 
+    VkSemaphoreTypeCreateInfo const type_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+
+    VkSemaphoreCreateInfo const semaphore_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_info,
+    };
+
+    if (!device->vkCreateSemaphore(&semaphore_info, &m_timeline)) {
+        logger()->error("create async upload timeline semaphore");
+        device->vkDestroyCommandPool(m_pool);
+        m_pool = VK_NULL_HANDLE;
+        return false;
+    }
+
+    m_timeline_value = 0;
+
+    logger()->info("async uploads on queue family {} (graphics {})",
+                   m_transfer_queue.family, m_graphics_family);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void staging::destroy_async() {
+    if (!m_device)
+        return;
+
+    for (auto& transfer : m_transfers) {
+        for (auto& texture : transfer.textures)
+            texture->destroy_upload_buffer();
+    }
+
+    m_transfers.clear();
+
+    if (m_timeline) {
+        m_device->vkDestroySemaphore(m_timeline);
+        m_timeline = VK_NULL_HANDLE;
+    }
+
+    // frees all command buffers
+    if (m_pool) {
+        m_device->vkDestroyCommandPool(m_pool);
+        m_pool = VK_NULL_HANDLE;
+    }
+
+    m_frame_wait_value = 0;
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool staging::acquire_transfers(VkCommandBuffer cmd_buf) {
+    if (m_transfers.empty())
+        return false;
+
+    ui64 completed = 0;
+    if (!check(m_device->call().vkGetSemaphoreCounterValue(m_device->get(),
+                                                           m_timeline,
+                                                           &completed)))
+        return false;
+
+    auto acquired = false;
+
+    for (auto& transfer : m_transfers) {
+        if (transfer.value > completed)
+            break;
+
+        // first use: the wait on a reached value does not stall
+        for (auto& texture : transfer.textures) {
+            texture->acquire(cmd_buf,
+                             m_transfer_queue.family,
+                             m_graphics_family,
+                             get_frame_wait_stage());
+
+            texture->destroy_upload_buffer();
+        }
+
+        m_device->vkFreeCommandBuffers(m_pool, 1, &transfer.cmd_buf);
+
+        m_frame_wait_value = transfer.value;
+        acquired = true;
+    }
+
+    std::erase_if(m_transfers, [&](transfer const& t) {
+        return t.value <= completed;
+    });
+
+    return acquired;
+}
+
+//-----------------------------------------------------------------------------
+bool staging::submit_transfer(texture::s_list& textures) {
+    VkCommandBuffer transfer_cmd_buf = VK_NULL_HANDLE;
+    if (!m_device->vkAllocateCommandBuffers(m_pool,
+                                            1,
+                                            &transfer_cmd_buf,
+                                            VK_COMMAND_BUFFER_LEVEL_PRIMARY))
+        return false;
+
+    VkCommandBufferBeginInfo const begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+
+    if (!check(m_device->call().vkBeginCommandBuffer(transfer_cmd_buf,
+                                                     &begin_info))) {
+        m_device->vkFreeCommandBuffers(m_pool, 1, &transfer_cmd_buf);
+        return false;
+    }
+
+    texture::s_list staged;
+    for (auto& texture : textures) {
+        if (texture->stage_transfer(transfer_cmd_buf,
+                                    m_transfer_queue.family,
+                                    m_graphics_family))
+            staged.push_back(texture);
+    }
+
+    m_device->call().vkEndCommandBuffer(transfer_cmd_buf);
+
+    if (staged.empty()) {
+        m_device->vkFreeCommandBuffers(m_pool, 1, &transfer_cmd_buf);
+        textures.clear();
+        return true;
+    }
+
+    auto const value = m_timeline_value + 1;
+
+    VkTimelineSemaphoreSubmitInfo const timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &value,
+    };
+
+    VkSubmitInfo const submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timeline_info,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &transfer_cmd_buf,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &m_timeline,
+    };
+
+    if (!m_device->vkQueueSubmit(m_transfer_queue.vk_queue,
+                                 1,
+                                 &submit_info,
+                                 VK_NULL_HANDLE)) {
+        // textures stay pending, nothing is staged
+        logger()->error("submit async upload");
+        m_device->vkFreeCommandBuffers(m_pool, 1, &transfer_cmd_buf);
+        return false;
+    }
+
+    m_timeline_value = value;
+    textures = staged;
+
+    // acquired by a later frame when complete
+    m_transfers.push_back({value, transfer_cmd_buf, staged});
+
     return true;
 }
 
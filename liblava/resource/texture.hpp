@@ -7,8 +7,9 @@
 
 #pragma once
 
-#include "liblava/resource/buffer.hpp"
 #include "liblava/resource/image.hpp"
+#include "liblava/resource/staging_ring.hpp"
+#include <bit>
 
 namespace lava {
 
@@ -22,6 +23,26 @@ enum class texture_type : index {
     cube_map
 };
 
+/**
+ * @brief Texture mip map generation
+ */
+enum class texture_mips : index {
+    none = 0,
+    gpu, ///< blit chain on stage
+    cpu, ///< box filter on load
+};
+
+/**
+ * @brief Texture block compression
+ */
+enum class texture_compression : index {
+    none = 0,
+    automatic, ///< BC1 if opaque, else BC3
+    bc1,       ///< RGB
+    bc3,       ///< RGBA
+    bc5,       ///< RG (e.g. normal maps)
+};
+
 /**
  * @brief Texture file path with format
  */
@@ -34,8 +55,20 @@ struct texture_file {
 
     /// File format
     VkFormat format = VK_FORMAT_UNDEFINED;
+
+    /// Mip map generation (if file has a single level)
+    texture_mips mips = texture_mips::gpu;
+
+    /// Block compression on load (needs cache path)
+    texture_compression compression = texture_compression::none;
 };
 
+/// Shader stages that sample textures (upload barriers and waits)
+constexpr VkPipelineStageFlags const texture_shader_stages =
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+    | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+    | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
 /**
  * @brief Texture
  */
@@ -110,7 +143,7 @@ struct texture : entity {
     void destroy();
 
     /**
-     * @brief Upload data to texture
+     * @brief Upload data to texture (staging ring, host copy when full)
      * @param data         Data to upload
      * @param data_size    Size of data
      * @return Upload was successful or failed
@@ -121,15 +154,124 @@ struct texture : entity {
     /**
      * @brief Stage the texture
      * @param cmd_buffer    Command buffer
-     * @return Stage was successful or failed
+     * @return Stage was successful or failed (staging ring full: retry)
      */
     bool stage(VkCommandBuffer cmd_buffer);
 
     /**
-     * @brief Destroy the upload buffer
+     * @brief Stage a part of the texture
+     *
+     * Copies levels coarse to fine and splits a level into bands of rows
+     * when it exceeds the size. Sample the texture when it is complete.
+     *
+     * @param cmd_buffer     Command buffer
+     * @param max_size       Size of part in bytes (at least one band)
+     * @param staged_size    Size of staged data in bytes
+     * @return Stage was successful or failed (staging ring full: retry)
+     */
+    bool stage_part(VkCommandBuffer cmd_buffer,
+                    size_t max_size,
+                    size_t& staged_size);
+
+    /**
+     * @brief Get the size of upload data
+     * @return size_t    Size in bytes
+     */
+    size_t get_upload_size() const {
+        return m_upload_size;
+    }
+
+    /**
+     * @brief Get the size of upload data not staged yet
+     * @return size_t    Size in bytes
+     */
+    size_t get_stage_size() const {
+        return m_upload_size - m_staged_size;
+    }
+
+    /**
+     * @brief Check if staging of the texture has started
+     * @return Texture is partly staged or not
+     */
+    bool partly_staged() const {
+        return m_staged_size > 0 && m_staged_size < m_upload_size;
+    }
+
+    /**
+     * @brief Stage the texture on a transfer queue
+     *
+     * Records the copy and releases the image to the graphics queue family
+     * (blit mips need a graphics queue: see stage). The texture counts as
+     * staged when the transfer is complete: see acquire.
+     *
+     * @param cmd_buffer    Command buffer of transfer queue
+     * @param src_family    Transfer queue family
+     * @param dst_family    Graphics queue family
+     * @return Stage was successful or failed (staging ring full: retry)
+     */
+    bool stage_transfer(VkCommandBuffer cmd_buffer,
+                        index src_family,
+                        index dst_family);
+
+    /**
+     * @brief Acquire the image staged on a transfer queue (after completion)
+     * @param cmd_buffer    Command buffer of graphics queue
+     * @param src_family    Transfer queue family
+     * @param dst_family    Graphics queue family
+     * @param wait_stage    Stage waiting for the transfer semaphore
+     */
+    void acquire(VkCommandBuffer cmd_buffer,
+                 index src_family,
+                 index dst_family,
+                 VkPipelineStageFlags wait_stage);
+
+    /**
+     * @brief Release the upload data
      */
     void destroy_upload_buffer();
 
+    /**
+     * @brief Generate mip levels by blitting on stage
+     * @param value    Upload data contains first level only
+     */
+    void set_blit_mips(bool value = true) {
+        m_blit_mips = value;
+    }
+
+    /**
+     * @brief Check if mip levels are generated by blitting on stage
+     * @return Blit mips or not
+     */
+    bool get_blit_mips() const {
+        return m_blit_mips;
+    }
+
+    /**
+     * @brief Set the minimum level of detail of the sampler
+     *
+     * Replaces the sampler when the texture exists already.
+     *
+     * @param value         Minimum level of detail
+     * @return VkSampler    Replaced sampler to release when unused (or none)
+     */
+    VkSampler set_min_lod(r32 value);
+
+    /**
+     * @brief Get the minimum level of detail of the sampler
+     * @return r32    Minimum level of detail
+     */
+    r32 get_min_lod() const {
+        return m_sampler_info.minLod;
+    }
+
+    /**
+     * @brief Get the layers of the texture
+     * @return layer::list const&    List of layers
+     */
+    layer::list const& get_layers() const {
+        return m_layers;
+    }
+
     /**
      * @brief Get the descriptor information
      * @return VkDescriptorImageInfo const*    Descriptor image information
@@ -183,15 +325,109 @@ private:
     /// Texture sampler
     VkSampler m_sampler = 0;
 
+    /// Sampler create information
+    VkSamplerCreateInfo m_sampler_info = {};
+
     /// Descriptor image information
     VkDescriptorImageInfo m_descriptor = {};
 
-    /// Upload buffer
-    buffer::s_ptr m_upload_buffer;
+    /// Upload data in staging ring
+    staging_allocation m_upload;
+
+    /// Upload data waiting for staging ring
+    std::vector<ui8> m_upload_data;
+
+    /// Blit mip levels on stage
+    bool m_blit_mips = false;
+
+    /// Size of upload data
+    size_t m_upload_size = 0;
+
+    /// Size of staged upload data
+    size_t m_staged_size = 0;
+
+    /// Number of staged levels (coarse to fine)
+    ui32 m_staged_levels = 0;
+
+    /// Number of staged block rows of next level
+    ui32 m_staged_rows = 0;
+
+    /**
+     * @brief Move upload data into the staging ring
+     * @return Upload data is in staging memory or not (ring full)
+     */
+    bool prepare_upload();
+
+    /**
+     * @brief Get the subresource range of all levels and layers
+     * @return VkImageSubresourceRange    Image subresource range
+     */
+    VkImageSubresourceRange get_subresource_range() const;
+
+    /**
+     * @brief Record copy of upload data (image left as transfer destination)
+     * @param cmd_buf      Command buffer
+     * @param src_stage    Source stage of layout transition
+     */
+    void record_copy(VkCommandBuffer cmd_buf,
+                     VkPipelineStageFlags src_stage);
+
+    /**
+     * @brief Record copy of first level and blit chain
+     * @param cmd_buf    Command buffer
+     */
+    void stage_blit_mips(VkCommandBuffer cmd_buf);
+};
+
+/**
+ * @brief Calculate the number of levels of a full mip chain
+ * @param size     Size of first level
+ * @return ui32    Number of mip levels
+ */
+inline ui32 calc_mip_levels(uv2 size) {
+    return to_ui32(std::bit_width(std::max({size.x, size.y, 1u})));
+}
+
+/**
+ * @brief Make texture layers with a full mip chain
+ * @param size                     Size of first level
+ * @param texel_size               Size of a texel in bytes
+ * @param layer_count              Number of layers
+ * @return texture::layer::list    List of layers
+ */
+texture::layer::list make_mip_layers(uv2 size,
+                                     ui32 texel_size,
+                                     ui32 layer_count = 1);
+
+/**
+ * @brief Get the alignment of texture data in staging memory
+ * @param format           Texture format
+ * @return VkDeviceSize    Texel block and copy alignment
+ */
+VkDeviceSize texture_upload_alignment(VkFormat format);
+
+/**
+ * @brief Staging priority classes
+ */
+enum class staging_priority : index {
+    visible = 0, ///< needed now, staged in this frame
+    prefetch,    ///< needed soon, staged under budget
+    background,  ///< staged under budget when nothing else waits
 };
 
+/// Default staging budget per frame
+constexpr size_t const default_staging_frame_budget = 16 * 1024 * 1024;
+
 /**
  * @brief Texture staging
+ *
+ * Visible textures are staged in the frame they were added. Prefetch and
+ * background textures share a byte budget per frame, larger ones are
+ * split by mip levels and rows over frames.
+ * Records copies into the frame command buffer. With async uploads the
+ * copies run on the transfer queue instead: the image is released to the
+ * graphics queue family and a timeline semaphore is signaled, which only
+ * the frame using the textures first waits for.
  */
 struct staging {
     /// Pointer to staging
@@ -199,11 +435,11 @@ struct staging {
 
     /**
      * @brief Add texture for staging
-     * @param texture    Texture to stage
+     * @param texture     Texture to stage
+     * @param priority    Staging priority
      */
-    void add(texture::s_ptr texture) {
-        m_todo.push_back(texture);
-    }
+    void add(texture::s_ptr texture,
+             staging_priority priority = staging_priority::visible);
 
     /**
      * @brief Stage textures
@@ -215,30 +451,196 @@ struct staging {
                index frame);
 
     /**
-     * @brief Clear staging
+     * @brief Clear staging (device must be idle)
      */
-    void clear() {
-        m_todo.clear();
-        m_staged.clear();
-    }
+    void clear();
 
     /**
      * @brief Check if staging is busy
      * @return Staging is busy or not
      */
     bool busy() const {
-        return !m_todo.empty() || !m_staged.empty();
+        return !m_todo.empty() || !m_staged.empty() || !m_transfers.empty();
+    }
+
+    /**
+     * @brief Set the budget of prefetch and background per frame
+     * @param value    Size in bytes (0: unlimited)
+     */
+    void set_frame_budget(size_t value) {
+        m_frame_budget = value;
+    }
+
+    /**
+     * @brief Get the budget of prefetch and background per frame
+     * @return size_t    Size in bytes
+     */
+    size_t get_frame_budget() const {
+        return m_frame_budget;
+    }
+
+    /**
+     * @brief Get the number of textures waiting
+     * @return size_t    Queue depth
+     */
+    size_t get_queue_depth() const {
+        return m_todo.size();
+    }
+
+    /**
+     * @brief Get the number of textures waiting with priority
+     * @param priority    Staging priority
+     * @return size_t     Queue depth
+     */
+    size_t get_queue_depth(staging_priority priority) const;
+
+    /**
+     * @brief Get the size of upload data waiting
+     * @return size_t    Size in bytes
+     */
+    size_t get_pending_size() const;
+
+    /**
+     * @brief Get the bytes staged in last stage
+     * @return size_t    Size in bytes
+     */
+    size_t get_staged_size() const {
+        return m_staged_size;
+    }
+
+    /**
+     * @brief Upload on the transfer queue
+     *
+     * Needs timeline semaphores and a transfer queue. Textures with
+     * blit mips are still staged in the frame command buffer. Frames
+     * do not wait for transfers: a texture is acquired by the first
+     * frame staging after its transfer completed, until then its stage
+     * size is not zero (do not sample it).
+     *
+     * @param device    Vulkan device
+     * @return Async uploads are enabled or not (not supported)
+     */
+    bool create_async(device::ptr device);
+
+    /**
+     * @brief Stop uploading on the transfer queue (device must be idle)
+     */
+    void destroy_async();
+
+    /**
+     * @brief Check if uploads run on the transfer queue
+     * @return Async uploads are enabled or not
+     */
+    bool async() const {
+        return m_timeline != VK_NULL_HANDLE;
+    }
+
+    /**
+     * @brief Get the timeline semaphore of transfer submits
+     * @return VkSemaphore    Timeline semaphore
+     */
+    VkSemaphore get_timeline_semaphore() const {
+        return m_timeline;
+    }
+
+    /**
+     * @brief Get the timeline value the current frame has to wait for
+     *
+     * Orders the acquire after the transfer, the value is reached
+     * already: the frame does not stall.
+     *
+     * @return ui64    Timeline value (0: no wait)
+     */
+    ui64 get_frame_wait_value() const {
+        return m_frame_wait_value;
+    }
+
+    /**
+     * @brief Get the pipeline stage the current frame waits at
+     * @return VkPipelineStageFlags    Pipeline wait stage
+     */
+    VkPipelineStageFlags get_frame_wait_stage() const {
+        return texture_shader_stages;
     }
 
 private:
-    /// List of textures to stage
-    texture::s_list m_todo;
+    /**
+     * @brief Texture waiting for staging
+     */
+    struct item {
+        /// Texture to stage
+        texture::s_ptr texture;
+
+        /// Staging priority
+        staging_priority priority = staging_priority::visible;
+    };
+
+    /// List of textures to stage (by priority)
+    std::vector<item> m_todo;
+
+    /// Budget of prefetch and background per frame
+    size_t m_frame_budget = default_staging_frame_budget;
+
+    /// Bytes staged in last stage
+    size_t m_staged_size = 0;
 
     /// Map of textures by frame index
     using frame_stage_map = std::map<index, texture::s_list>;
 
     /// Map of staged textures
     frame_stage_map m_staged;
+
+    /**
+     * @brief Submit on the transfer queue
+     */
+    struct transfer {
+        /// Timeline value signaled on completion
+        ui64 value = 0;
+
+        /// Command buffer of transfer queue
+        VkCommandBuffer cmd_buf = VK_NULL_HANDLE;
+
+        /// Staged textures
+        texture::s_list textures;
+    };
+
+    /// List of submitted transfers
+    std::vector<transfer> m_transfers;
+
+    /// Vulkan device of async uploads
+    device::ptr m_device = nullptr;
+
+    /// Transfer queue
+    queue m_transfer_queue;
+
+    /// Graphics queue family
+    index m_graphics_family = 0;
+
+    /// Command pool of transfer queue
+    VkCommandPool m_pool = VK_NULL_HANDLE;
+
+    /// Timeline semaphore of transfer submits
+    VkSemaphore m_timeline = VK_NULL_HANDLE;
+
+    /// Last signaled timeline value
+    ui64 m_timeline_value = 0;
+
+    /// Timeline value the current frame waits for
+    ui64 m_frame_wait_value = 0;
+
+    /**
+     * @brief Acquire the textures of completed transfers
+     * @param cmd_buf    Command buffer of graphics queue
+     * @return Any texture was acquired or not
+     */
+    bool acquire_transfers(VkCommandBuffer cmd_buf);
+
+    /**
+     * @brief Submit textures on the transfer queue
+     * @param textures    Textures to stage (after submit: staged ones, failed: unchanged)
+     * @return Submit was successful or failed
+     */
+    bool submit_transfer(texture::s_list& textures);
 };
 
 /// Texture registry
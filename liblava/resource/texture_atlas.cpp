@@ -0,0 +1,298 @@
+/**
+ * @file         liblava/resource/texture_atlas.cpp
+ * @brief        Texture atlas of small textures
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/texture_atlas.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/util/log.hpp"
+#include <numeric>
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+void skyline_packer::reset(uv2 size) {
+    m_size = size;
+    m_nodes = {{0, 0, size.x}};
+    m_used_area = 0;
+}
+
+//-----------------------------------------------------------------------------
+std::optional<ui32> skyline_packer::fit(size_t idx,
+                                        uv2 size) const {
+    if (m_nodes[idx].x + size.x > m_size.x)
+        return std::nullopt;
+
+    // highest segment below rectangle
+    auto y = 0u;
+    auto width_left = size.x;
+    for (auto i = idx; width_left > 0; ++i) {
+        if (i == m_nodes.size())
+            return std::nullopt;
+
+        y = std::max(y, m_nodes[i].y);
+        if (y + size.y > m_size.y)
+            return std::nullopt;
+
+        width_left -= std::min(width_left, m_nodes[i].width);
+    }
+
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+std::optional<uv2> skyline_packer::insert(uv2 size) {
+    if (size.x == 0 || size.y == 0)
+        return std::nullopt;
+
+    auto best_idx = m_nodes.size();
+    auto best_y = 0u;
+    auto best_top = std::numeric_limits<ui32>::max();
+    auto best_width = std::numeric_limits<ui32>::max();
+
+    for (auto i = 0u; i < m_nodes.size(); ++i) {
+        auto const y = fit(i, size);
+        if (!y)
+            continue;
+
+        // lowest top edge, then tightest segment
+        auto const top = *y + size.y;
+        if (top < best_top
+            || (top == best_top && m_nodes[i].width < best_width)) {
+            best_idx = i;
+            best_y = *y;
+            best_top = top;
+            best_width = m_nodes[i].width;
+        }
+    }
+
+    if (best_idx == m_nodes.size())
+        return std::nullopt;
+
+    uv2 const position = {m_nodes[best_idx].x, best_y};
+
+    m_nodes.insert(m_nodes.begin() + best_idx,
+                   {position.x, best_top, size.x});
+
+    // cut segments covered by the new one
+    for (auto i = best_idx + 1; i < m_nodes.size();) {
+        auto const& prev = m_nodes[i - 1];
+        auto& current = m_nodes[i];
+
+        auto const prev_end = prev.x + prev.width;
+        if (current.x >= prev_end)
+            break;
+
+        auto const shrink = prev_end - current.x;
+        if (current.width > shrink) {
+            current.x += shrink;
+            current.width -= shrink;
+            break;
+        }
+
+        m_nodes.erase(m_nodes.begin() + i);
+    }
+
+    // merge segments of same height
+    for (auto i = 0u; i + 1 < m_nodes.size();) {
+        if (m_nodes[i].y == m_nodes[i + 1].y) {
+            m_nodes[i].width += m_nodes[i + 1].width;
+            m_nodes.erase(m_nodes.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    m_used_area += size_t(size.x) * size.y;
+
+    return position;
+}
+
+//-----------------------------------------------------------------------------
+r32 skyline_packer::get_occupancy() const {
+    auto const area = size_t(m_size.x) * m_size.y;
+    return area > 0 ? to_r32(m_used_area) / to_r32(area) : 0.f;
+}
+
+//-----------------------------------------------------------------------------
+index texture_atlas::add(uv2 size,
+                         c_data::ref data) {
+    image_item item;
+    item.size = size;
+
+    auto const bytes = (ui8 const*)data.addr;
+    item.data.assign(bytes, bytes + data.size);
+
+    m_images.push_back(std::move(item));
+    m_regions.push_back({.size = size});
+
+    return to_index(m_images.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+bool texture_atlas::pack(uv2 layer_size,
+                         ui32 padding) {
+    m_layer_size = layer_size;
+    m_layer_count = 0;
+    m_padding = padding;
+
+    // tall images first
+    std::vector<index> order(m_images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](index a, index b) {
+        auto const& size_a = m_images[a].size;
+        auto const& size_b = m_images[b].size;
+        return size_a.y != size_b.y ? size_a.y > size_b.y
+                                    : size_a.x > size_b.x;
+    });
+
+    std::vector<skyline_packer> layers;
+
+    for (auto idx : order) {
+        auto const& size = m_images[idx].size;
+        auto const padded_size = size + uv2(padding * 2);
+        if (size.x == 0 || size.y == 0
+            || padded_size.x > layer_size.x || padded_size.y > layer_size.y) {
+            logger()->error("texture atlas: image {} empty or larger than layer", idx);
+            return false;
+        }
+
+        std::optional<uv2> position;
+        auto layer = 0u;
+        for (; layer < layers.size(); ++layer) {
+            position = layers[layer].insert(padded_size);
+            if (position)
+                break;
+        }
+
+        if (!position) {
+            layers.emplace_back().reset(layer_size);
+            position = layers.back().insert(padded_size);
+        }
+
+        auto& region = m_regions[idx];
+        region.layer = layer;
+        region.offset = *position + uv2(padding);
+        region.size = size;
+
+        auto const layer_extent = v2(layer_size);
+        region.uv_transform = v4(v2(region.size) / layer_extent,
+                                 v2(region.offset) / layer_extent);
+    }
+
+    m_layer_count = to_ui32(layers.size());
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool texture_atlas::create(device::ptr device,
+                           uv2 layer_size,
+                           VkFormat format,
+                           ui32 padding) {
+    destroy();
+
+    if (m_images.empty())
+        return false;
+
+    // padding and packing work on single texels
+    if (format_block_compressed(format)) {
+        logger()->error("texture atlas: block compressed format not supported");
+        return false;
+    }
+
+    auto const texel_size = format_block_size(format);
+    if (texel_size == 0) {
+        logger()->error("texture atlas: unknown texel size of format");
+        return false;
+    }
+
+    if (!pack(layer_size, padding))
+        return false;
+    auto const layer_data_size = size_t(layer_size.x) * layer_size.y * texel_size;
+
+    for (auto i = 0u; i < m_images.size(); ++i) {
+        if (m_images[i].data.size() != size_t(m_images[i].size.x) * m_images[i].size.y * texel_size) {
+            logger()->error("texture atlas: image {} does not match format", i);
+            return false;
+        }
+    }
+
+    std::vector<ui8> data(layer_data_size * m_layer_count);
+
+    for (auto i = 0u; i < m_images.size(); ++i) {
+        auto const& item = m_images[i];
+        auto const& region = m_regions[i];
+
+        auto const layer_data = data.data() + region.layer * layer_data_size;
+
+        // padding repeats the edge texels
+        auto const pad = i32(m_padding);
+        for (auto y = -pad; y < i32(item.size.y) + pad; ++y) {
+            auto const src_y = std::clamp(y, 0, i32(item.size.y) - 1);
+            auto const src_row = item.data.data() + size_t(src_y) * item.size.x * texel_size;
+            auto const dst_row = layer_data + (size_t(region.offset.y + y) * layer_size.x) * texel_size;
+
+            for (auto x = -pad; x < i32(item.size.x) + pad; ++x) {
+                auto const src_x = std::clamp(x, 0, i32(item.size.x) - 1);
+                memcpy(dst_row + size_t(region.offset.x + x) * texel_size,
+                       src_row + size_t(src_x) * texel_size,
+                       texel_size);
+            }
+        }
+    }
+
+    texture::layer::list layers(m_layer_count);
+    for (auto& layer : layers)
+        layer.levels.push_back({layer_size, to_ui32(layer_data_size)});
+
+    auto product = texture::make();
+    if (!product->create(device, layer_size, format, layers, texture_type::array)) {
+        logger()->error("texture atlas: create texture");
+        return false;
+    }
+
+    if (!product->upload(data.data(), data.size())) {
+        logger()->error("texture atlas: upload texture");
+        return false;
+    }
+
+    m_texture = product;
+
+    logger()->trace("texture atlas: {} images in {} layers", m_images.size(), m_layer_count);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void texture_atlas::destroy() {
+    if (m_texture) {
+        m_texture->destroy();
+        m_texture = nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void texture_atlas::clear() {
+    destroy();
+
+    m_images.clear();
+    m_regions.clear();
+
+    m_layer_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<v4> texture_atlas::get_uv_table() const {
+    std::vector<v4> result;
+    result.reserve(m_regions.size());
+
+    for (auto const& region : m_regions)
+        result.push_back(region.uv_transform);
+
+    return result;
+}
+
+} // namespace lava
@@ -0,0 +1,264 @@
+/**
+ * @file         liblava/resource/texture_atlas.hpp
+ * @brief        Texture atlas of small textures
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/resource/texture.hpp"
+#include <optional>
+
+namespace lava {
+
+/**
+ * @brief Skyline rectangle packer
+ *
+ * Keeps the top edge of the packed area as a list of segments and
+ * places each rectangle where its top ends lowest (bottom left rule).
+ */
+struct skyline_packer {
+    /**
+     * @brief Reset the packer
+     * @param size    Size of area
+     */
+    void reset(uv2 size);
+
+    /**
+     * @brief Insert a rectangle
+     * @param size                  Size of rectangle
+     * @return std::optional<uv2>   Position of rectangle (nullopt: full)
+     */
+    std::optional<uv2> insert(uv2 size);
+
+    /**
+     * @brief Get the size of area
+     * @return uv2    Size of area
+     */
+    uv2 get_size() const {
+        return m_size;
+    }
+
+    /**
+     * @brief Get the used part of area
+     * @return r32    Occupancy (0 - 1)
+     */
+    r32 get_occupancy() const;
+
+private:
+    /**
+     * @brief Segment of skyline
+     */
+    struct node {
+        /// Left edge
+        ui32 x = 0;
+
+        /// Top edge
+        ui32 y = 0;
+
+        /// Width of segment
+        ui32 width = 0;
+    };
+
+    /**
+     * @brief Find the position of a rectangle on a segment
+     * @param idx                    Index of first segment
+     * @param size                   Size of rectangle
+     * @return std::optional<ui32>   Top edge below rectangle (nullopt: no fit)
+     */
+    std::optional<ui32> fit(size_t idx,
+                            uv2 size) const;
+
+    /// Size of area
+    uv2 m_size{};
+
+    /// Segments of skyline (left to right)
+    std::vector<node> m_nodes;
+
+    /// Area of inserted rectangles
+    size_t m_used_area = 0;
+};
+
+/// Default size of atlas layers
+constexpr uv2 const default_atlas_layer_size = {1024, 1024};
+
+/**
+ * @brief Texture atlas
+ *
+ * Packs small images into the layers of one texture array: one image,
+ * sampler and descriptor for all of them. Regions are padded with
+ * their edge texels against filter bleeding. Shaders remap the texture
+ * coordinates with the UV table and sample the region layer.
+ */
+struct texture_atlas : entity {
+    /// Shared pointer to texture atlas
+    using s_ptr = std::shared_ptr<texture_atlas>;
+
+    /**
+     * @brief Region of image in atlas
+     */
+    struct region {
+        /// List of regions
+        using list = std::vector<region>;
+
+        /// Array layer
+        ui32 layer = 0;
+
+        /// Position in layer (texels)
+        uv2 offset{};
+
+        /// Size of image (texels)
+        uv2 size{};
+
+        /// UV remap: uv * scale (xy) + offset (zw)
+        v4 uv_transform = v4(1.f, 1.f, 0.f, 0.f);
+    };
+
+    /**
+     * @brief Make a new texture atlas
+     * @return s_ptr    Shared pointer to texture atlas
+     */
+    static s_ptr make() {
+        return std::make_shared<texture_atlas>();
+    }
+
+    /**
+     * @brief Destroy the texture atlas
+     */
+    ~texture_atlas() {
+        destroy();
+    }
+
+    /**
+     * @brief Add an image (packed on create)
+     * @param size     Size of image
+     * @param data     Texels of image (texel size of atlas format)
+     * @return index   Index of region
+     */
+    index add(uv2 size,
+              c_data::ref data);
+
+    /**
+     * @brief Pack all images into layers
+     * @param layer_size    Size of layers
+     * @param padding       Texels around each region
+     * @return Pack was successful or failed (image empty or larger than layer)
+     */
+    bool pack(uv2 layer_size = default_atlas_layer_size,
+              ui32 padding = 2);
+
+    /**
+     * @brief Pack all images and create the texture (stage it)
+     *
+     * Creating again repacks with all added images and replaces the
+     * texture: the old one must not be in use anymore.
+     *
+     * @param device        Vulkan device
+     * @param layer_size    Size of layers
+     * @param format        Texture format (block compressed fails)
+     * @param padding       Texels around each region
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                uv2 layer_size = default_atlas_layer_size,
+                VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+                ui32 padding = 2);
+
+    /**
+     * @brief Destroy the texture
+     */
+    void destroy();
+
+    /**
+     * @brief Destroy the texture and remove all images
+     */
+    void clear();
+
+    /**
+     * @brief Get the texture
+     * @return texture::s_ptr    Texture array (nullptr: not created)
+     */
+    texture::s_ptr get_texture() const {
+        return m_texture;
+    }
+
+    /**
+     * @brief Get a region of atlas
+     * @param idx                Index of region
+     * @return region const&     Region of image
+     */
+    region const& get_region(index idx) const {
+        return m_regions.at(idx);
+    }
+
+    /**
+     * @brief Get all regions of atlas
+     * @return region::list const&    List of regions
+     */
+    region::list const& get_regions() const {
+        return m_regions;
+    }
+
+    /**
+     * @brief Get the UV remap table
+     * @return std::vector<v4>    UV transform per region (scale xy, offset zw)
+     */
+    std::vector<v4> get_uv_table() const;
+
+    /**
+     * @brief Get the number of images
+     * @return size_t    Number of images
+     */
+    size_t get_count() const {
+        return m_images.size();
+    }
+
+    /**
+     * @brief Get the number of layers
+     * @return ui32    Number of layers (after pack)
+     */
+    ui32 get_layer_count() const {
+        return m_layer_count;
+    }
+
+    /**
+     * @brief Get the size of layers
+     * @return uv2    Size of layers (after pack)
+     */
+    uv2 get_layer_size() const {
+        return m_layer_size;
+    }
+
+private:
+    /**
+     * @brief Image in atlas
+     */
+    struct image_item {
+        /// Size of image
+        uv2 size{};
+
+        /// Texels of image
+        std::vector<ui8> data;
+    };
+
+    /// List of images
+    std::vector<image_item> m_images;
+
+    /// Regions of images
+    region::list m_regions;
+
+    /// Texture array
+    texture::s_ptr m_texture;
+
+    /// Size of layers
+    uv2 m_layer_size{};
+
+    /// Number of layers
+    ui32 m_layer_count = 0;
+
+    /// Texels around each region
+    ui32 m_padding = 0;
+};
+
+} // namespace lava
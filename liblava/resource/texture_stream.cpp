@@ -0,0 +1,462 @@
+/**
+ * @file         liblava/resource/texture_stream.cpp
+ * @brief        Progressive mip streaming of textures
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#include "liblava/resource/texture_stream.hpp"
+#include "liblava/resource/format.hpp"
+#include "liblava/resource/sampler_cache.hpp"
+#include "liblava/util/log.hpp"
+
+namespace lava {
+
+//-----------------------------------------------------------------------------
+void texture_stream_release::release() {
+    for (auto& [device, sampler] : samplers)
+        if (auto cache = device->get_sampler_cache())
+            cache->release(sampler);
+
+    for (auto& [device, allocation] : allocations)
+        if (auto ring = device->get_staging_ring())
+            ring->release(allocation);
+
+    samplers.clear();
+    allocations.clear();
+    textures.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool streamed_texture::create(device::ptr device,
+                              VkFormat format,
+                              texture::layer::list const& layers,
+                              c_data::ref data,
+                              texture_type type,
+                              ui32 tail_extent) {
+    if (layers.empty() || layers.front().levels.empty()) {
+        logger()->error("create streamed texture - no levels");
+        return false;
+    }
+
+    m_device = device;
+    m_format = format;
+    m_type = type;
+    m_layers = layers;
+
+    auto const level_count = get_level_count();
+    if (data.size < calc_size(0, level_count)) {
+        logger()->error("create streamed texture - data too small");
+        return false;
+    }
+
+    m_data.assign(data.addr, data.addr + data.size);
+
+    m_tail_level = level_count - 1;
+    for (auto level = 0u; level < level_count; ++level) {
+        auto const extent = m_layers.front().levels[level].extent;
+        if (std::max(extent.x, extent.y) <= tail_extent) {
+            m_tail_level = level;
+            break;
+        }
+    }
+
+    m_base_level = m_tail_level;
+    m_resident_level = level_count;
+    m_target_level = 0;
+    m_prepared = false;
+    m_unused_frames = 0;
+
+    m_texture = create_texture(m_base_level, m_resident_level);
+    if (!m_texture)
+        return false;
+
+    ++m_version;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void streamed_texture::destroy() {
+    m_texture = nullptr;
+
+    m_data.clear();
+    m_layers.clear();
+
+    m_device = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void streamed_texture::set_distance(r32 distance,
+                                    r32 detail_distance) {
+    if (detail_distance <= 0.f || distance <= detail_distance) {
+        set_target_level(0);
+        return;
+    }
+
+    set_target_level(to_ui32(std::log2(distance / detail_distance)));
+}
+
+//-----------------------------------------------------------------------------
+size_t streamed_texture::calc_size(ui32 first_level,
+                                   ui32 end_level) const {
+    size_t result = 0;
+
+    for (auto const& layer : m_layers)
+        for (auto level = first_level; level < end_level; ++level)
+            result += layer.levels[level].size;
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+texture::s_ptr streamed_texture::create_texture(ui32 base_level,
+                                                ui32 resident_level) const {
+    texture::layer::list layers;
+    for (auto const& layer : m_layers) {
+        texture::layer image_layer;
+        image_layer.levels.assign(layer.levels.begin() + base_level,
+                                  layer.levels.end());
+        layers.push_back(image_layer);
+    }
+
+    auto result = texture::make();
+
+    // nothing resident yet: mip tail arrives before first use
+    if (resident_level < get_level_count())
+        result->set_min_lod(to_r32(resident_level - base_level));
+
+    if (!result->create(m_device,
+                        layers.front().levels.front().extent,
+                        m_format,
+                        layers,
+                        m_type)) {
+        logger()->error("create streamed texture - level {}", base_level);
+        return nullptr;
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool streamed_texture::rebase(VkCommandBuffer cmd_buf,
+                              ui32 base_level,
+                              texture_stream_release& release) {
+    auto const level_count = get_level_count();
+    auto const layer_count = to_ui32(m_layers.size());
+
+    // dropped levels are no longer resident
+    auto const resident_level = m_resident_level < level_count
+                                    ? std::max(m_resident_level, base_level)
+                                    : level_count;
+
+    auto next = create_texture(base_level, resident_level);
+    if (!next)
+        return false;
+
+    auto const next_image = next->get_image()->get();
+
+    VkImageSubresourceRange const range{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = level_count - base_level,
+        .baseArrayLayer = 0,
+        .layerCount = layer_count,
+    };
+
+    set_image_layout(m_device, cmd_buf, next_image, VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range,
+                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    if (m_prepared && resident_level < level_count) {
+        auto const image = m_texture->get_image()->get();
+
+        VkImageSubresourceRange const source_range{
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = resident_level - m_base_level,
+            .levelCount = level_count - resident_level,
+            .baseArrayLayer = 0,
+            .layerCount = layer_count,
+        };
+
+        set_image_layout(m_device, cmd_buf, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, source_range,
+                         texture_shader_stages, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        std::vector<VkImageCopy> regions;
+        for (auto level = resident_level; level < level_count; ++level) {
+            auto const extent = m_layers.front().levels[level].extent;
+
+            regions.push_back({
+                .srcSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level - m_base_level,
+                    .baseArrayLayer = 0,
+                    .layerCount = layer_count,
+                },
+                .srcOffset = {},
+                .dstSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level - base_level,
+                    .baseArrayLayer = 0,
+                    .layerCount = layer_count,
+                },
+                .dstOffset = {},
+                .extent = {extent.x, extent.y, 1},
+            });
+        }
+
+        m_device->call().vkCmdCopyImage(cmd_buf,
+                                        image,
+                                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                        next_image,
+                                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                        to_ui32(regions.size()),
+                                        regions.data());
+    }
+
+    set_image_layout(m_device, cmd_buf, next_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, texture_shader_stages);
+
+    if (m_texture)
+        release.textures.push_back(m_texture);
+
+    m_texture = next;
+    m_base_level = base_level;
+    m_resident_level = resident_level;
+    m_prepared = true;
+
+    ++m_version;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool streamed_texture::upload(VkCommandBuffer cmd_buf,
+                              ui32 first_level,
+                              texture_stream_release& release) {
+    auto const level_count = get_level_count();
+    auto const end_level = m_resident_level;
+    if (first_level >= end_level || first_level < m_base_level)
+        return false;
+
+    auto ring = get_staging_ring(m_device);
+    if (!ring)
+        return false;
+
+    // staging ring is full: next frame
+    auto allocation = ring->allocate(calc_size(first_level, end_level),
+                                     texture_upload_alignment(m_format));
+    if (!allocation.valid())
+        return false;
+
+    std::vector<VkBufferImageCopy> regions;
+    VkDeviceSize upload_offset = 0;
+
+    size_t layer_offset = 0;
+    for (auto layer = 0u; layer < m_layers.size(); ++layer) {
+        auto const& levels = m_layers[layer].levels;
+
+        auto offset = layer_offset;
+        for (auto level = 0u; level < level_count; ++level) {
+            if (level >= first_level && level < end_level) {
+                regions.push_back({
+                    .bufferOffset = allocation.offset + upload_offset,
+                    .imageSubresource = {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = level - m_base_level,
+                        .baseArrayLayer = layer,
+                        .layerCount = 1,
+                    },
+                    .imageExtent = {levels[level].extent.x,
+                                    levels[level].extent.y,
+                                    1},
+                });
+
+                memcpy(allocation.data + upload_offset,
+                       m_data.data() + offset,
+                       levels[level].size);
+
+                upload_offset += levels[level].size;
+            }
+
+            offset += levels[level].size;
+        }
+
+        layer_offset = offset;
+    }
+
+    ring->flush(allocation);
+
+    // first upload prepares all levels of the image
+    auto const range_level = m_prepared ? first_level : m_base_level;
+    auto const range_end = m_prepared ? end_level : level_count;
+
+    VkImageSubresourceRange const range{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = range_level - m_base_level,
+        .levelCount = range_end - range_level,
+        .baseArrayLayer = 0,
+        .layerCount = to_ui32(m_layers.size()),
+    };
+
+    auto const image = m_texture->get_image()->get();
+
+    set_image_layout(m_device, cmd_buf, image, VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range,
+                     texture_shader_stages, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    m_device->call().vkCmdCopyBufferToImage(cmd_buf,
+                                            allocation.buffer,
+                                            image,
+                                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                            to_ui32(regions.size()),
+                                            regions.data());
+
+    set_image_layout(m_device, cmd_buf, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, texture_shader_stages);
+
+    release.allocations.emplace_back(m_device, allocation);
+
+    m_resident_level = first_level;
+    m_prepared = true;
+
+    update_min_lod(release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void streamed_texture::update_min_lod(texture_stream_release& release) {
+    auto const min_lod = to_r32(m_resident_level - m_base_level);
+    if (m_texture->get_min_lod() == min_lod)
+        return;
+
+    if (auto replaced = m_texture->set_min_lod(min_lod)) {
+        release.samplers.emplace_back(m_device, replaced);
+        ++m_version;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool texture_streamer::stream(VkCommandBuffer cmd_buf,
+                              index frame) {
+    if (m_release.count(frame)) {
+        m_release.at(frame).release();
+        m_release.erase(frame);
+    }
+
+    m_uploaded_size = 0;
+
+    if (m_textures.empty())
+        return false;
+
+    auto& release = m_release[frame];
+
+    streamed_texture::s_list streaming;
+
+    for (auto& texture : m_textures) {
+        if (!texture->m_texture)
+            continue;
+
+        if (texture->m_used) {
+            texture->m_used = false;
+            texture->m_unused_frames = 0;
+        } else {
+            ++texture->m_unused_frames;
+        }
+
+        // mip tail at once
+        if (texture->m_resident_level == texture->get_level_count()) {
+            auto const size = texture->calc_size(texture->m_base_level,
+                                                 texture->get_level_count());
+
+            if (!texture->upload(cmd_buf, texture->m_base_level, release))
+                continue;
+
+            m_uploaded_size += size;
+        }
+
+        auto target_level = texture->m_target_level;
+        if (m_unused_frames > 0 && texture->m_unused_frames >= m_unused_frames)
+            target_level = texture->m_tail_level;
+
+        // evict fine levels, keep one more against thrashing
+        if (target_level > texture->m_base_level + 1) {
+            if (!texture->rebase(cmd_buf, target_level, release))
+                continue;
+        }
+
+        if (texture->m_resident_level > target_level)
+            streaming.push_back(texture);
+    }
+
+    // largest deficit first
+    std::sort(streaming.begin(), streaming.end(), [](auto const& a, auto const& b) {
+        return a->m_resident_level - a->m_target_level
+               > b->m_resident_level - b->m_target_level;
+    });
+
+    auto budget = m_frame_budget;
+    auto streamed = false;
+
+    for (auto& texture : streaming) {
+        auto first_level = texture->m_resident_level;
+        size_t size = 0;
+
+        // at least one level per frame
+        while (first_level > texture->m_target_level) {
+            auto const level_size = texture->calc_size(first_level - 1, first_level);
+            if (size + level_size > budget && (size > 0 || streamed))
+                break;
+
+            size += level_size;
+            --first_level;
+        }
+
+        if (first_level == texture->m_resident_level)
+            continue;
+
+        if (first_level < texture->m_base_level
+            && !texture->rebase(cmd_buf, texture->m_target_level, release))
+            continue;
+
+        if (!texture->upload(cmd_buf, first_level, release))
+            continue;
+
+        budget -= std::min(budget, size);
+        m_uploaded_size += size;
+        streamed = true;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void texture_streamer::clear() {
+    for (auto& [frame, release] : m_release)
+        release.release();
+
+    m_release.clear();
+    m_textures.clear();
+}
+
+//-----------------------------------------------------------------------------
+size_t texture_streamer::get_resident_size() const {
+    size_t result = 0;
+
+    for (auto const& texture : m_textures)
+        result += texture->get_resident_size();
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+bool texture_streamer::busy() const {
+    for (auto const& texture : m_textures)
+        if (!texture->complete())
+            return true;
+
+    return false;
+}
+
+} // namespace lava
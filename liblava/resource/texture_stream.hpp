@@ -0,0 +1,397 @@
+/**
+ * @file         liblava/resource/texture_stream.hpp
+ * @brief        Progressive mip streaming of textures
+ * @authors      Lava Block OÜ and contributors
+ * @copyright    Copyright (c) 2018-present, MIT License
+ */
+
+#pragma once
+
+#include "liblava/core/misc.hpp"
+#include "liblava/resource/texture.hpp"
+
+namespace lava {
+
+/**
+ * @brief Resources to release when the frame using them is done
+ */
+struct texture_stream_release {
+    /// Replaced textures
+    texture::s_list textures;
+
+    /// Staging memory of uploads
+    std::vector<std::pair<device::ptr, staging_allocation>> allocations;
+
+    /// Replaced samplers
+    std::vector<std::pair<device::ptr, VkSampler>> samplers;
+
+    /**
+     * @brief Release all resources
+     */
+    void release();
+};
+
+/**
+ * @brief Texture with mip levels streamed in over frames
+ *
+ * Keeps all levels on the host. The image holds the levels from a base
+ * level down to the last one. The mip tail is uploaded on the first
+ * stream, finer levels follow under the frame budget of the streamer.
+ * The sampler's minLod hides levels which have not arrived yet.
+ *
+ * Sampler and image view change while streaming: rewrite the descriptor
+ * of the current frame when the version changed.
+ */
+struct streamed_texture : entity {
+    /// Shared pointer to streamed texture
+    using s_ptr = std::shared_ptr<streamed_texture>;
+
+    /// List of streamed textures
+    using s_list = std::vector<s_ptr>;
+
+    /**
+     * @brief Make a new streamed texture
+     * @return s_ptr    Shared pointer to streamed texture
+     */
+    static s_ptr make() {
+        return std::make_shared<streamed_texture>();
+    }
+
+    /**
+     * @brief Destroy the streamed texture
+     */
+    ~streamed_texture() {
+        destroy();
+    }
+
+    /**
+     * @brief Create a new streamed texture
+     * @param device         Vulkan device
+     * @param format         Texture format
+     * @param layers         List of layers with all mip levels
+     * @param data           Data of all levels (layer by layer, first level first)
+     * @param type           Texture type
+     * @param tail_extent    Largest extent of mip tail levels
+     * @return Create was successful or failed
+     */
+    bool create(device::ptr device,
+                VkFormat format,
+                texture::layer::list const& layers,
+                c_data::ref data,
+                texture_type type = texture_type::tex_2d,
+                ui32 tail_extent = 128);
+
+    /**
+     * @brief Destroy the streamed texture
+     */
+    void destroy();
+
+    /**
+     * @brief Set the finest level to stream in
+     * @param level    Mip level (0: full detail)
+     */
+    void set_target_level(ui32 level) {
+        m_target_level = std::min(level, m_tail_level);
+    }
+
+    /**
+     * @brief Get the finest level to stream in
+     * @return ui32    Mip level
+     */
+    ui32 get_target_level() const {
+        return m_target_level;
+    }
+
+    /**
+     * @brief Set the target level by viewer distance
+     *
+     * Drops one level each time the distance doubles.
+     *
+     * @param distance           Distance to viewer
+     * @param detail_distance    Distance up to full detail
+     */
+    void set_distance(r32 distance,
+                      r32 detail_distance = 10.f);
+
+    /**
+     * @brief Mark texture as used in this frame
+     */
+    void touch() {
+        m_used = true;
+    }
+
+    /**
+     * @brief Get the current texture
+     * @return texture::s_ptr    Texture with resident levels
+     */
+    texture::s_ptr get_texture() const {
+        return m_texture;
+    }
+
+    /**
+     * @brief Get the descriptor information
+     * @return VkDescriptorImageInfo const*    Descriptor image information
+     */
+    VkDescriptorImageInfo const* get_descriptor_info() const {
+        return m_texture ? m_texture->get_descriptor_info() : nullptr;
+    }
+
+    /**
+     * @brief Get the version (changes with descriptor)
+     * @return ui32    Version of texture
+     */
+    ui32 get_version() const {
+        return m_version;
+    }
+
+    /**
+     * @brief Get the number of mip levels
+     * @return ui32    Number of levels
+     */
+    ui32 get_level_count() const {
+        return m_layers.empty() ? 0 : to_ui32(m_layers.front().levels.size());
+    }
+
+    /**
+     * @brief Get the finest resident level
+     * @return ui32    Mip level (level count: none)
+     */
+    ui32 get_resident_level() const {
+        return m_resident_level;
+    }
+
+    /**
+     * @brief Get the first level of the mip tail
+     * @return ui32    Mip level
+     */
+    ui32 get_tail_level() const {
+        return m_tail_level;
+    }
+
+    /**
+     * @brief Check if all target levels are resident
+     * @return Texture is complete or streaming
+     */
+    bool complete() const {
+        return m_resident_level <= m_target_level;
+    }
+
+    /**
+     * @brief Get the size of the image levels
+     * @return size_t    Size in bytes
+     */
+    size_t get_resident_size() const {
+        return calc_size(m_base_level, get_level_count());
+    }
+
+private:
+    friend struct texture_streamer;
+
+    /// Vulkan device
+    device::ptr m_device = nullptr;
+
+    /// Texture format
+    VkFormat m_format = VK_FORMAT_UNDEFINED;
+
+    /// Texture type
+    texture_type m_type = texture_type::tex_2d;
+
+    /// List of layers with all mip levels
+    texture::layer::list m_layers;
+
+    /// Data of all levels
+    std::vector<ui8> m_data;
+
+    /// Current texture (levels from base level)
+    texture::s_ptr m_texture;
+
+    /// First level in image
+    ui32 m_base_level = 0;
+
+    /// Finest level with data
+    ui32 m_resident_level = 0;
+
+    /// First level of mip tail
+    ui32 m_tail_level = 0;
+
+    /// Finest level to stream in
+    ui32 m_target_level = 0;
+
+    /// Image layouts are initialized
+    bool m_prepared = false;
+
+    /// Used in this frame
+    bool m_used = false;
+
+    /// Number of frames without use
+    ui32 m_unused_frames = 0;
+
+    /// Version of descriptor
+    ui32 m_version = 0;
+
+    /**
+     * @brief Calculate the size of levels in all layers
+     * @param first_level    First mip level
+     * @param end_level      Mip level after last
+     * @return size_t        Size in bytes
+     */
+    size_t calc_size(ui32 first_level,
+                     ui32 end_level) const;
+
+    /**
+     * @brief Create a texture holding the levels from base level
+     * @param base_level         First mip level
+     * @param resident_level     Finest level with data
+     * @return texture::s_ptr    Created texture
+     */
+    texture::s_ptr create_texture(ui32 base_level,
+                                  ui32 resident_level) const;
+
+    /**
+     * @brief Move image to new base level and copy resident levels
+     * @param cmd_buf       Command buffer
+     * @param base_level    New first mip level
+     * @param release       Resources to release
+     * @return Rebase was successful or failed
+     */
+    bool rebase(VkCommandBuffer cmd_buf,
+                ui32 base_level,
+                texture_stream_release& release);
+
+    /**
+     * @brief Upload levels down to first level
+     * @param cmd_buf        Command buffer
+     * @param first_level    Finest level to upload
+     * @param release        Resources to release
+     * @return Upload was successful or failed
+     */
+    bool upload(VkCommandBuffer cmd_buf,
+                ui32 first_level,
+                texture_stream_release& release);
+
+    /**
+     * @brief Update sampler to resident levels
+     * @param release    Resources to release
+     */
+    void update_min_lod(texture_stream_release& release);
+};
+
+/**
+ * @brief Texture streaming
+ *
+ * Uploads the mip tail of added textures at once, then streams finer
+ * levels under a per frame byte budget (largest deficit first). Drops
+ * fine levels of textures which are far away or unused.
+ */
+struct texture_streamer {
+    /// Pointer to texture streamer
+    using ptr = texture_streamer*;
+
+    /**
+     * @brief Destroy the texture streamer
+     */
+    ~texture_streamer() {
+        clear();
+    }
+
+    /**
+     * @brief Add texture for streaming
+     * @param texture    Texture to stream
+     */
+    void add(streamed_texture::s_ptr texture) {
+        if (!contains(m_textures, texture))
+            m_textures.push_back(texture);
+    }
+
+    /**
+     * @brief Remove texture from streaming
+     * @param texture    Texture to remove
+     */
+    void remove(streamed_texture::s_ptr texture) {
+        lava::remove(m_textures, texture);
+    }
+
+    /**
+     * @brief Stream textures
+     * @param cmd_buf    Command buffer
+     * @param frame      Frame index
+     * @return Stream was successful or failed
+     */
+    bool stream(VkCommandBuffer cmd_buf,
+                index frame);
+
+    /**
+     * @brief Clear streaming (device must be idle)
+     */
+    void clear();
+
+    /**
+     * @brief Set the upload budget per frame
+     * @param value    Size in bytes (at least one level per frame)
+     */
+    void set_frame_budget(size_t value) {
+        m_frame_budget = value;
+    }
+
+    /**
+     * @brief Get the upload budget per frame
+     * @return size_t    Size in bytes
+     */
+    size_t get_frame_budget() const {
+        return m_frame_budget;
+    }
+
+    /**
+     * @brief Set the number of unused frames before eviction
+     * @param value    Number of frames (0: never evict unused)
+     */
+    void set_unused_frames(ui32 value) {
+        m_unused_frames = value;
+    }
+
+    /**
+     * @brief Get the number of unused frames before eviction
+     * @return ui32    Number of frames
+     */
+    ui32 get_unused_frames() const {
+        return m_unused_frames;
+    }
+
+    /**
+     * @brief Get the bytes uploaded in last stream
+     * @return size_t    Size in bytes
+     */
+    size_t get_uploaded_size() const {
+        return m_uploaded_size;
+    }
+
+    /**
+     * @brief Get the size of all streamed images
+     * @return size_t    Size in bytes
+     */
+    size_t get_resident_size() const;
+
+    /**
+     * @brief Check if streaming is busy
+     * @return Streaming is busy or not
+     */
+    bool busy() const;
+
+private:
+    /// List of streamed textures
+    streamed_texture::s_list m_textures;
+
+    /// Map of resources to release by frame index
+    std::map<index, texture_stream_release> m_release;
+
+    /// Upload budget per frame
+    size_t m_frame_budget = 4 * 1024 * 1024;
+
+    /// Number of unused frames before eviction
+    ui32 m_unused_frames = 0;
+
+    /// Bytes uploaded in last stream
+    size_t m_uploaded_size = 0;
+};
+
+} // namespace lava
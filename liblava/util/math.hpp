@@ -9,6 +9,7 @@
 
 #include "liblava/core/types.hpp"
 #include "picosha2.h"
+#include <array>
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -191,6 +192,54 @@ inline mat4 perspective_matrix(uv2 size,
                far_plane);
 }
 
+/// Frustum planes (left, right, bottom, top, near, far)
+using frustum_planes = std::array<v4, 6>;
+
+/**
+ * @brief Extract normalized frustum planes from view projection matrix
+ * @param view_projection     View projection matrix (depth zero to one)
+ * @return frustum_planes     Planes with inward facing normals
+ */
+inline frustum_planes extract_frustum_planes(mat4 const& view_projection) {
+    auto const row = [&](glm::length_t i) {
+        return v4(view_projection[0][i],
+                  view_projection[1][i],
+                  view_projection[2][i],
+                  view_projection[3][i]);
+    };
+
+    frustum_planes planes = {
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(2),
+        row(3) - row(2),
+    };
+
+    for (auto& plane : planes)
+        plane /= glm::length(v3(plane));
+
+    return planes;
+}
+
+/**
+ * @brief Check if sphere intersects frustum
+ * @param planes    Frustum planes
+ * @param center    Sphere center
+ * @param radius    Sphere radius
+ * @return Sphere is inside or intersecting
+ */
+inline bool sphere_in_frustum(frustum_planes const& planes,
+                              v3 const& center,
+                              r32 radius) {
+    for (auto const& plane : planes)
+        if (glm::dot(v3(plane), center) + plane.w < -radius)
+            return false;
+
+    return true;
+}
+
 /**
  * @brief Get SHA-256 hash of string
  * @param value      Value to hash
@@ -11,6 +11,7 @@
 #include "liblava/core/time.hpp"
 #include <condition_variable>
 #include <deque>
+#include <latch>
 #include <mutex>
 #include <thread>
 
@@ -139,4 +140,36 @@ private:
     bool m_stop = false;
 };
 
+/**
+ * @brief Run function for each item on a thread pool and wait
+ * @param thread_count    Number of threads (0: hardware concurrency)
+ * @param count           Number of items
+ * @param func            Function called with item index
+ */
+inline void parallel_for(ui32 thread_count,
+                         size_t count,
+                         std::function<void(size_t)> const& func) {
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (thread_count <= 1 || count <= 1) {
+        for (auto i = 0u; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    thread_pool pool;
+    pool.setup(to_ui32(std::min(size_t(thread_count), count)));
+
+    std::latch done(static_cast<std::ptrdiff_t>(count));
+    for (auto i = 0u; i < count; ++i)
+        pool.enqueue([&, i](id::ref) {
+            func(i);
+            done.count_down();
+        });
+
+    done.wait();
+    pool.teardown();
+}
+
 } // namespace lava
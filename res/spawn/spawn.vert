@@ -15,6 +15,10 @@ layout(binding = 1) uniform Ubo_Spawn {
 }
 ubo_spawn;
 
+layout(std430, binding = 3) readonly buffer Spawn_Instances {
+    mat4 instances[];
+};
+
 layout(location = 0) out vec4 outColor;
 layout(location = 1) out vec2 outUV;
 
@@ -26,5 +30,5 @@ void main() {
     outColor = inColor;
     outUV = inUV;
 
-    gl_Position = ubo_camera.projection * ubo_camera.view * ubo_spawn.model * vec4(inPos, 1.0);
+    gl_Position = ubo_camera.projection * ubo_camera.view * ubo_spawn.model * instances[gl_InstanceIndex] * vec4(inPos, 1.0);
 }